@@ -0,0 +1,87 @@
+// Consulta: resumen min/max/media de un dispositivo del almacén columnar
+// en un rango de tiempo.
+//
+// Compilación (Linux):
+//   g++ -std=c++17 -O2 -I../LIB_COLECTOR -I../../SISTEMA/LIB_SISTEMA main.cpp
+//       ../LIB_COLECTOR/COMP_ALMACEN.cpp ../LIB_COLECTOR/COMP_PROTOCOLO.cpp
+//       ../../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp -o consulta
+//
+// Uso:
+//   ./consulta <almacen>/<dispositivo> [desde] [hasta]
+// Fechas como "dd/mm/aaaa", "dd/mm/aaaa hh:mm:ss" o segundos epoch.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "COMP_ALMACEN.h"
+#include "COMP_PROTOCOLO.h"
+
+static bool parseTime(const char *text, uint32_t &out) {
+  int d, mo, y, h = 0, mi = 0, s = 0;
+  int n = sscanf(text, "%d/%d/%d %d:%d:%d", &d, &mo, &y, &h, &mi, &s);
+  if (n == 3 || n == 6) {
+    out = civilToEpoch(y, mo, d, h, mi, s);
+    return true;
+  }
+  char *end;
+  unsigned long v = strtoul(text, &end, 10);
+  if (*end != '\0') return false;
+  out = (uint32_t)v;
+  return true;
+}
+
+static void printDate(uint32_t t) {
+  time_t tt = t;
+  struct tm tm;
+  gmtime_r(&tt, &tm);
+  char text[20];
+  strftime(text, sizeof(text), "%d/%m/%Y %H:%M:%S", &tm);
+  printf("%s", text);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Uso: %s <almacen>/<dispositivo> [desde] [hasta]\n", argv[0]);
+    return 1;
+  }
+  uint32_t from = 0, to = UINT32_MAX;
+  if ((argc > 2 && !parseTime(argv[2], from)) || (argc > 3 && !parseTime(argv[3], to))) {
+    fprintf(stderr, "Fecha no válida\n");
+    return 1;
+  }
+
+  ColumnStoreReader reader;
+  if (!reader.open(argv[1])) {
+    fprintf(stderr, "No se pudo abrir %s\n", argv[1]);
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  uint64_t first, last;
+  reader.findRows(from, to, first, last);
+  Rollup rollups[STORE_SUMMARY_FIELDS];
+  uint32_t skipped[STORE_SUMMARY_FIELDS];
+  for (uint8_t f = 0; f < STORE_SUMMARY_FIELDS; f++) {
+    rollups[f] = reader.rollup((StoreField)f, from, to, &skipped[f]);
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%llu filas en el rango (de %llu, %u bloques indexados)\n",
+         (unsigned long long)(last - first), (unsigned long long)reader.getRowCount(),
+         reader.getBlockCount());
+  if (last > first) {
+    printf("Desde ");
+    printDate(reader.timestamps()[first]);
+    printf(" hasta ");
+    printDate(reader.timestamps()[last - 1]);
+    printf("\n");
+  }
+  static const char *const NAMES[STORE_SUMMARY_FIELDS] = { "Temperatura", "Humedad", "BPM", "SpO2" };
+  for (uint8_t f = 0; f < STORE_SUMMARY_FIELDS; f++) {
+    const Rollup &r = rollups[f];
+    printf("%-12s n=%-10u min %8.2f  max %8.2f  media %8.2f  (%u bloques desde el índice)\n",
+           NAMES[f], r.count, r.min, r.max, r.mean(), skipped[f]);
+  }
+  printf("Consulta en %.0f us\n", us);
+  return 0;
+}
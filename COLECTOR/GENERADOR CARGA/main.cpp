@@ -0,0 +1,207 @@
+// Generador de carga para el colector: simula miles de monitores que se
+// conectan al socket local y envían reportes con el formato de main.ino
+// (o bloques de historial binarios con -b).
+//
+// Compilación (Linux):
+//   g++ -std=c++17 -O2 -pthread -I../LIB_COLECTOR -I../../SISTEMA/LIB_SISTEMA
+//       main.cpp ../../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp -o generador
+//
+// Uso:
+//   ./generador [-s /tmp/colector.sock] [-n dispositivos] [-r reportes/s por dispositivo]
+//               [-t segundos] [-j hilos] [-b]
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "COMP_COMPRESION.h"
+#include "COMP_PROTOCOLO.h"
+#include "COMP_UMBRALES.h"
+
+constexpr size_t HISTORY_RECORDS = 16;   // Registros por bloque binario
+
+struct Options {
+  const char *socketPath = "/tmp/colector.sock";
+  int devices = 1000;
+  double rate = 10.0;
+  int seconds = 10;
+  int threads = 2;
+  bool binary = false;
+};
+
+struct Counters {
+  std::atomic<uint64_t> records{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> blocked{0};     // envíos omitidos por socket lleno
+  std::atomic<int> connected{0};
+};
+
+static int connectTo(const char *path) {
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Signos vitales simulados; ~5 % de los reportes disparan alguna alerta
+static VitalsRecord simulate(std::mt19937 &rng, uint32_t timestamp) {
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  VitalsRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.timestamp   = timestamp;
+  rec.temperature = 36.0f + unit(rng) * 1.4f;
+  rec.humidity    = 40.0f + unit(rng) * 20.0f;
+  rec.bpm         = 60.0f + unit(rng) * 40.0f;
+  rec.spo2        = 95 + (uint8_t)(unit(rng) * 5);
+  rec.latitude    = 6.2442 + unit(rng) * 0.001;
+  rec.longitude   = -75.5812 + unit(rng) * 0.001;
+  float event = unit(rng);
+  if (event < 0.025f)     rec.temperature = 38.0f;
+  else if (event < 0.05f) rec.bpm = 130.0f;
+  rec.flags = REC_HAS_TEMPERATURE | REC_HAS_HUMIDITY | REC_HAS_BPM | REC_HAS_SPO2 | REC_HAS_LOCATION;
+  return rec;
+}
+
+// Mismo texto que reportChannel() en main.ino
+static size_t formatReport(char *out, size_t cap, const VitalsRecord &rec) {
+  time_t t = rec.timestamp;
+  struct tm tm;
+  gmtime_r(&t, &tm);
+  char bufferTime[20];
+  strftime(bufferTime, sizeof(bufferTime), "%d/%m/%Y %H:%M:%S", &tm);
+
+  uint8_t alerts = evaluateAlerts(true, rec.temperature, rec.bpm);
+  bool alertTemp = alerts & ALERT_TEMPERATURE;
+  bool alertHR   = alerts & ALERT_HEART_RATE;
+  int n = snprintf(out, cap, "%s\nTemp: %.2f °C, BPM: %.1f, SpO2: %u%%\n",
+                   (alertTemp || alertHR) ? "*** ALERTA DE SALUD ***" : "Estado estable.",
+                   rec.temperature, rec.bpm, rec.spo2);
+  if (alertTemp) n += snprintf(out + n, cap - n, "Temperatura alta: %.2f °C\n", rec.temperature);
+  if (alertHR)   n += snprintf(out + n, cap - n, "Frecuencia cardiaca anómala: %.1f BPM\n", rec.bpm);
+  n += snprintf(out + n, cap - n, "Timestamp: %s\nUbicación: Lat %.6f, Lon %.6f\n"
+                "-------------------------------\n", bufferTime, rec.latitude, rec.longitude);
+  return (size_t)n;
+}
+
+// Bloque de historial comprimido precedido por la cabecera de trama
+static size_t formatHistory(uint8_t *out, size_t cap, std::mt19937 &rng, uint32_t timestamp) {
+  TimeSeriesEncoder encoder;
+  encoder.begin(out + FRAME_HEADER_SIZE, cap - FRAME_HEADER_SIZE);
+  for (size_t i = 0; i < HISTORY_RECORDS; i++) {
+    if (!encoder.append(simulate(rng, timestamp + i * 60))) break;
+  }
+  size_t len = encoder.size();
+  return writeFrameHeader(out, FRAME_HISTORY, (uint16_t)len) + len;
+}
+
+static bool sendAll(int fd, const void *data, size_t len) {
+  const uint8_t *p = (const uint8_t *)data;
+  while (len > 0) {
+    ssize_t n = send(fd, p, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      // Sin espacio: termina la trama de forma bloqueante para no cortarla
+      if (p == data) return false;
+      n = send(fd, p, len, MSG_NOSIGNAL);
+    }
+    if (n <= 0) return false;
+    p += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+static void runThread(const Options &opt, int index, Counters &counters) {
+  std::vector<int> fds;
+  for (int d = index; d < opt.devices; d += opt.threads) {
+    int fd = connectTo(opt.socketPath);
+    if (fd >= 0) {
+      fds.push_back(fd);
+      counters.connected++;
+    }
+  }
+  if (fds.empty()) return;
+
+  std::mt19937 rng(1234 + index);
+  std::vector<uint8_t> buffer(8192);
+  uint32_t timestamp = (uint32_t)time(nullptr);
+
+  // Cada dispositivo envía 'rate' veces por segundo, repartidos en el periodo
+  auto period = std::chrono::duration<double>(1.0 / opt.rate);
+  auto start = std::chrono::steady_clock::now();
+  auto end = start + std::chrono::seconds(opt.seconds);
+  for (uint64_t round = 0;; round++) {
+    auto roundStart = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * (double)round);
+    if (roundStart >= end) break;
+    std::this_thread::sleep_until(roundStart);
+    for (int fd : fds) {
+      size_t len;
+      uint64_t records;
+      if (opt.binary) {
+        len = formatHistory(buffer.data(), buffer.size(), rng, timestamp);
+        records = HISTORY_RECORDS;
+      } else {
+        len = formatReport((char *)buffer.data(), buffer.size(), simulate(rng, timestamp));
+        records = 1;
+      }
+      if (sendAll(fd, buffer.data(), len)) {
+        counters.records += records;
+        counters.bytes += len;
+      } else {
+        counters.blocked++;
+      }
+    }
+    timestamp++;
+  }
+  for (int fd : fds) close(fd);
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  int c;
+  while ((c = getopt(argc, argv, "s:n:r:t:j:b")) != -1) {
+    switch (c) {
+      case 's': opt.socketPath = optarg; break;
+      case 'n': opt.devices = atoi(optarg); break;
+      case 'r': opt.rate = atof(optarg); break;
+      case 't': opt.seconds = atoi(optarg); break;
+      case 'j': opt.threads = atoi(optarg); break;
+      case 'b': opt.binary = true; break;
+      default:
+        fprintf(stderr, "Uso: %s [-s socket] [-n dispositivos] [-r reportes/s] [-t s] [-j hilos] [-b]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (opt.threads < 1) opt.threads = 1;
+  if (opt.rate <= 0) opt.rate = 1;
+
+  Counters counters;
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < opt.threads; i++) {
+    threads.emplace_back(runThread, std::cref(opt), i, std::ref(counters));
+  }
+  for (auto &t : threads) t.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%d dispositivos conectados, %llu registros en %.1f s (%.0f reg/s, %.1f MB/s), %llu envíos omitidos\n",
+         counters.connected.load(), (unsigned long long)counters.records.load(), seconds,
+         counters.records.load() / seconds, counters.bytes.load() / seconds / 1e6,
+         (unsigned long long)counters.blocked.load());
+  return 0;
+}
@@ -0,0 +1,79 @@
+// Importador: convierte registros de texto del monitor (salida Serial de
+// main.ino) al almacén columnar del colector.
+//
+// Compilación (Linux):
+//   g++ -std=c++17 -O2 -I../LIB_COLECTOR -I../../SISTEMA/LIB_SISTEMA main.cpp
+//       ../LIB_COLECTOR/COMP_ALMACEN.cpp ../LIB_COLECTOR/COMP_PROTOCOLO.cpp
+//       ../../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp -o importador
+//
+// Uso:
+//   ./importador <almacen> <dispositivo> <registro.txt>...
+// El canal 0 va a <almacen>/<dispositivo>; el canal N a <dispositivo>-cN.
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <memory>
+#include <string>
+#include "COMP_ALMACEN.h"
+#include "COMP_PROTOCOLO.h"
+
+constexpr uint8_t MAX_CHANNELS = 8;
+
+struct Import {
+  std::string directory;
+  std::unique_ptr<ColumnStoreWriter> writers[MAX_CHANNELS];
+  uint64_t imported = 0;
+  uint64_t skipped = 0;
+};
+
+static void onRecord(void *context, const VitalsRecord &record, uint8_t channel) {
+  Import &imp = *static_cast<Import *>(context);
+  if (channel >= MAX_CHANNELS) {
+    imp.skipped++;
+    return;
+  }
+  std::unique_ptr<ColumnStoreWriter> &writer = imp.writers[channel];
+  if (!writer) {
+    std::string path = imp.directory;
+    if (channel > 0) path += "-c" + std::to_string(channel);
+    writer.reset(new ColumnStoreWriter());
+    if (!writer->open(path.c_str())) {
+      fprintf(stderr, "Error: %s (%s)\n", writer->getErrorMessage(), path.c_str());
+      exit(1);
+    }
+  }
+  if (writer->append(record)) imp.imported++;
+  else imp.skipped++;    // fuera de orden (p. ej. reloj sin GPS)
+}
+
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    fprintf(stderr, "Uso: %s <almacen> <dispositivo> <registro.txt>...\n", argv[0]);
+    return 1;
+  }
+  mkdir(argv[1], 0755);
+
+  Import imp;
+  imp.directory = std::string(argv[1]) + "/" + argv[2];
+
+  ReportParser parser;
+  uint8_t buffer[64 * 1024];
+  for (int i = 3; i < argc; i++) {
+    FILE *f = fopen(argv[i], "rb");
+    if (f == nullptr) {
+      fprintf(stderr, "No se pudo abrir %s\n", argv[i]);
+      continue;
+    }
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) parser.feed(buffer, n, onRecord, &imp);
+    fclose(f);
+  }
+
+  for (auto &writer : imp.writers) {
+    if (writer) writer->flush();
+  }
+  printf("%llu registros importados, %llu omitidos\n",
+         (unsigned long long)imp.imported, (unsigned long long)imp.skipped);
+  return 0;
+}
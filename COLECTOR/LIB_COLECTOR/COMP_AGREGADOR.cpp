@@ -0,0 +1,44 @@
+#include "COMP_AGREGADOR.h"
+#include "COMP_UMBRALES.h"
+#include <string.h>
+
+void resetAggregate(DeviceAggregate &aggregate) {
+    memset(&aggregate, 0, sizeof(aggregate));
+}
+
+uint8_t aggregateRecord(DeviceAggregate &aggregate, const VitalsRecord &record, uint8_t channel) {
+    bool hasTemperature = record.flags & REC_HAS_TEMPERATURE;
+    float bpm = (record.flags & REC_HAS_BPM) ? record.bpm : 0.0f;
+    uint8_t alerts = evaluateAlerts(hasTemperature, record.temperature, bpm);
+    // The device alerts on window extremes the means may not cross
+    if (record.flags & REC_ALERT_TEMPERATURE) alerts |= ALERT_TEMPERATURE;
+    if (record.flags & REC_ALERT_HEART_RATE)  alerts |= ALERT_HEART_RATE;
+    if (record.flags & REC_ALERT_GEOFENCE)    alerts |= ALERT_GEOFENCE;
+
+    aggregate.records++;
+    if (alerts & ALERT_TEMPERATURE) aggregate.temperatureAlerts++;
+    if (alerts & ALERT_HEART_RATE)  aggregate.heartRateAlerts++;
+
+    if (bpm > 0.0f) {
+        if (aggregate.bpmCount == 0 || bpm < aggregate.bpmMin) aggregate.bpmMin = bpm;
+        if (aggregate.bpmCount == 0 || bpm > aggregate.bpmMax) aggregate.bpmMax = bpm;
+        aggregate.bpmSum += bpm;
+        aggregate.bpmCount++;
+    }
+    if (hasTemperature) {
+        if (aggregate.temperatureCount == 0 || record.temperature > aggregate.temperatureMax) {
+            aggregate.temperatureMax = record.temperature;
+        }
+        aggregate.temperatureCount++;
+    }
+
+    aggregate.last = record;
+    aggregate.lastChannel = channel;
+    aggregate.lastAlerts = alerts;
+    return alerts;
+}
+
+float aggregateMeanBPM(const DeviceAggregate &aggregate) {
+    if (aggregate.bpmCount == 0) return 0.0f;
+    return (float)(aggregate.bpmSum / aggregate.bpmCount);
+}
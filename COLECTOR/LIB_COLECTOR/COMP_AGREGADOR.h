@@ -0,0 +1,38 @@
+#ifndef COMP_AGREGADOR_H
+#define COMP_AGREGADOR_H
+
+#include <stdint.h>
+#include "COMP_COMPRESION.h"
+
+// Running summary of the records of one device
+struct DeviceAggregate {
+    uint32_t records;
+    uint32_t temperatureAlerts;
+    uint32_t heartRateAlerts;
+
+    uint32_t bpmCount;
+    float    bpmMin;
+    float    bpmMax;
+    double   bpmSum;
+
+    uint32_t temperatureCount;
+    float    temperatureMax;
+
+    VitalsRecord last;
+    uint8_t  lastChannel;
+    uint8_t  lastAlerts;      // ALERT_* mask of the last record
+};
+
+void resetAggregate(DeviceAggregate &aggregate);
+
+/**
+ *  Re-run the alert thresholds of the firmware (COMP_UMBRALES.h) on a
+ *  record, add the REC_ALERT_* alerts the device reported and fold it
+ *  into the summary.
+ *  @return ALERT_* mask of the record
+ */
+uint8_t aggregateRecord(DeviceAggregate &aggregate, const VitalsRecord &record, uint8_t channel);
+
+float aggregateMeanBPM(const DeviceAggregate &aggregate);
+
+#endif // COMP_AGREGADOR_H
@@ -0,0 +1,456 @@
+#include "COMP_ALMACEN.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Column files, in the order of the column index
+enum Column : uint8_t {
+    COL_TIMESTAMP, COL_TEMPERATURE, COL_HUMIDITY, COL_BPM, COL_SPO2,
+    COL_LATITUDE, COL_LONGITUDE, COL_FLAGS
+};
+
+static const char *const COLUMN_FILES[STORE_COLUMNS] = {
+    "timestamp.u32", "temperature.f32", "humidity.f32", "bpm.f32", "spo2.u8",
+    "latitude.f64", "longitude.f64", "flags.u8"
+};
+static const uint8_t COLUMN_SIZES[STORE_COLUMNS] = { 4, 4, 4, 4, 1, 8, 8, 1 };
+
+static const char INDEX_FILE[] = "index.blk";
+
+// index.blk header
+struct IndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t blockRows;
+    uint32_t reserved;
+};
+static constexpr uint32_t INDEX_MAGIC   = 0x31534356;   // "VCS1"
+static constexpr uint32_t INDEX_VERSION = 1;
+
+static std::string joinPath(const std::string &directory, const char *name) {
+    return directory + "/" + name;
+}
+
+static uint64_t fileSize(const std::string &path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return 0;
+    return (uint64_t)st.st_size;
+}
+
+// ---------- Rollup ----------
+
+void Rollup::clear() {
+    min = NAN;
+    max = NAN;
+    sum = 0.0;
+    count = 0;
+}
+
+void Rollup::add(float value) {
+    if (isnan(value)) return;
+    if (count == 0 || value < min) min = value;
+    if (count == 0 || value > max) max = value;
+    sum += value;
+    count++;
+}
+
+void Rollup::merge(const Rollup &other) {
+    if (other.count == 0) return;
+    if (count == 0 || other.min < min) min = other.min;
+    if (count == 0 || other.max > max) max = other.max;
+    sum += other.sum;
+    count += other.count;
+}
+
+float Rollup::mean() const {
+    return count ? (float)(sum / count) : NAN;
+}
+
+// ---------- Writer ----------
+
+ColumnStoreWriter::ColumnStoreWriter()
+    : index(nullptr), rows(0), lastTimestamp(0), errorMessage("Sin error") {
+    for (FILE *&f : files) f = nullptr;
+    startBlock();
+}
+
+ColumnStoreWriter::~ColumnStoreWriter() {
+    close();
+}
+
+const char *ColumnStoreWriter::getErrorMessage() const {
+    return errorMessage;
+}
+
+uint64_t ColumnStoreWriter::getRowCount() const {
+    return rows;
+}
+
+void ColumnStoreWriter::startBlock() {
+    memset(&block, 0, sizeof(block));
+    for (Rollup &r : block.fields) r.clear();
+}
+
+bool ColumnStoreWriter::open(const char *directory) {
+    close();
+    std::string dir(directory);
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        errorMessage = "No se pudo crear el directorio";
+        return false;
+    }
+
+    // Rows present in every column; longer columns are cut back
+    uint64_t count = UINT64_MAX;
+    for (uint8_t c = 0; c < STORE_COLUMNS; c++) {
+        uint64_t n = fileSize(joinPath(dir, COLUMN_FILES[c])) / COLUMN_SIZES[c];
+        if (n < count) count = n;
+    }
+    for (uint8_t c = 0; c < STORE_COLUMNS; c++) {
+        std::string path = joinPath(dir, COLUMN_FILES[c]);
+        if (fileSize(path) != count * COLUMN_SIZES[c] && truncate(path.c_str(), count * COLUMN_SIZES[c]) != 0) {
+            errorMessage = "No se pudo reparar una columna";
+            return false;
+        }
+        files[c] = fopen(path.c_str(), "ab");
+        if (files[c] == nullptr) {
+            errorMessage = "No se pudo abrir una columna";
+            close();
+            return false;
+        }
+    }
+    rows = count;
+
+    // Index: header on a new file, complete blocks only on an existing one
+    std::string indexPath = joinPath(dir, INDEX_FILE);
+    uint64_t indexBlocks = fileSize(indexPath) >= sizeof(IndexHeader)
+                         ? (fileSize(indexPath) - sizeof(IndexHeader)) / sizeof(BlockSummary) : 0;
+    if (fileSize(indexPath) < sizeof(IndexHeader)) {
+        index = fopen(indexPath.c_str(), "wb");
+        IndexHeader header = { INDEX_MAGIC, INDEX_VERSION, STORE_BLOCK_ROWS, 0 };
+        if (index != nullptr) fwrite(&header, sizeof(header), 1, index);
+    } else {
+        uint64_t expected = rows / STORE_BLOCK_ROWS;
+        if (indexBlocks > expected) indexBlocks = expected;
+        if (truncate(indexPath.c_str(), sizeof(IndexHeader) + indexBlocks * sizeof(BlockSummary)) != 0) {
+            errorMessage = "No se pudo reparar el indice";
+            close();
+            return false;
+        }
+        index = fopen(indexPath.c_str(), "ab");
+    }
+    if (index == nullptr) {
+        errorMessage = "No se pudo abrir el indice";
+        close();
+        return false;
+    }
+    return recoverTail(dir);
+}
+
+bool ColumnStoreWriter::recoverTail(const std::string &directory) {
+    // Rebuild the summary of the unfinished block (and any complete block
+    // whose index entry was lost) from the columns
+    startBlock();
+    lastTimestamp = 0;
+    if (rows == 0) return true;
+
+    ColumnStoreReader reader;
+    if (!reader.open(directory.c_str())) {
+        errorMessage = "No se pudo leer la cola del almacen";
+        return false;
+    }
+    uint64_t indexed = (uint64_t)reader.getBlockCount() * STORE_BLOCK_ROWS;
+    const uint32_t *ts = reader.timestamps();
+    for (uint64_t r = indexed; r < rows; r++) {
+        VitalsRecord rec;
+        rec.timestamp   = ts[r];
+        rec.temperature = reader.value(FIELD_TEMPERATURE, r);
+        rec.humidity    = reader.value(FIELD_HUMIDITY, r);
+        rec.bpm         = reader.value(FIELD_BPM, r);
+        rec.spo2        = reader.spo2()[r];
+        summarise(rec);
+        if (block.rows == STORE_BLOCK_ROWS) {
+            fwrite(&block, sizeof(block), 1, index);
+            startBlock();
+        }
+    }
+    lastTimestamp = ts[rows - 1];
+    return fflush(index) == 0;
+}
+
+void ColumnStoreWriter::close() {
+    for (FILE *&f : files) {
+        if (f != nullptr) fclose(f);
+        f = nullptr;
+    }
+    if (index != nullptr) fclose(index);
+    index = nullptr;
+}
+
+void ColumnStoreWriter::summarise(const VitalsRecord &record) {
+    if (block.rows == 0) block.firstTimestamp = record.timestamp;
+    block.lastTimestamp = record.timestamp;
+    block.rows++;
+    block.fields[FIELD_TEMPERATURE].add(record.temperature);
+    block.fields[FIELD_HUMIDITY].add(record.humidity);
+    block.fields[FIELD_BPM].add(record.bpm);
+    if (record.spo2 > 0) block.fields[FIELD_SPO2].add(record.spo2);
+}
+
+bool ColumnStoreWriter::append(const VitalsRecord &record) {
+    if (index == nullptr) return false;
+    if (rows > 0 && record.timestamp < lastTimestamp) {
+        errorMessage = "Registro fuera de orden";
+        return false;
+    }
+
+    // Missing fields are stored as NaN (0 for SpO2)
+    float temperature = (record.flags & REC_HAS_TEMPERATURE) ? record.temperature : NAN;
+    float humidity    = (record.flags & REC_HAS_HUMIDITY)    ? record.humidity    : NAN;
+    float bpm         = (record.flags & REC_HAS_BPM)         ? record.bpm         : NAN;
+    uint8_t spo2      = (record.flags & REC_HAS_SPO2)        ? record.spo2        : 0;
+    double latitude   = (record.flags & REC_HAS_LOCATION)    ? record.latitude    : NAN;
+    double longitude  = (record.flags & REC_HAS_LOCATION)    ? record.longitude   : NAN;
+
+    bool ok = fwrite(&record.timestamp, 4, 1, files[COL_TIMESTAMP]) == 1;
+    ok &= fwrite(&temperature, 4, 1, files[COL_TEMPERATURE]) == 1;
+    ok &= fwrite(&humidity, 4, 1, files[COL_HUMIDITY]) == 1;
+    ok &= fwrite(&bpm, 4, 1, files[COL_BPM]) == 1;
+    ok &= fwrite(&spo2, 1, 1, files[COL_SPO2]) == 1;
+    ok &= fwrite(&latitude, 8, 1, files[COL_LATITUDE]) == 1;
+    ok &= fwrite(&longitude, 8, 1, files[COL_LONGITUDE]) == 1;
+    ok &= fwrite(&record.flags, 1, 1, files[COL_FLAGS]) == 1;
+    if (!ok) {
+        errorMessage = "Error de escritura";
+        return false;
+    }
+
+    VitalsRecord stored = record;
+    stored.temperature = temperature;
+    stored.humidity = humidity;
+    stored.bpm = bpm;
+    stored.spo2 = spo2;
+    summarise(stored);
+    rows++;
+    lastTimestamp = record.timestamp;
+
+    if (block.rows == STORE_BLOCK_ROWS) {
+        // Columns first, so an index entry never points past the data
+        if (!flush() || fwrite(&block, sizeof(block), 1, index) != 1 || fflush(index) != 0) {
+            errorMessage = "Error de escritura del indice";
+            return false;
+        }
+        startBlock();
+    }
+    return true;
+}
+
+bool ColumnStoreWriter::flush() {
+    bool ok = true;
+    for (FILE *f : files) {
+        if (f != nullptr && fflush(f) != 0) ok = false;
+    }
+    return ok;
+}
+
+// ---------- Reader ----------
+
+ColumnStoreReader::ColumnStoreReader() : rows(0), blocks(0) {
+    for (Mapping &m : columns) m = { nullptr, 0 };
+    index = { nullptr, 0 };
+}
+
+ColumnStoreReader::~ColumnStoreReader() {
+    close();
+}
+
+static bool mapFile(const std::string &path, const uint8_t *&data, size_t &length) {
+    data = nullptr;
+    length = 0;
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    if (ok && st.st_size > 0) {
+        void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            ok = false;
+        } else {
+            data = (const uint8_t *)p;
+            length = (size_t)st.st_size;
+        }
+    }
+    ::close(fd);
+    return ok;
+}
+
+void ColumnStoreReader::unmapAll() {
+    for (Mapping &m : columns) {
+        if (m.data != nullptr) munmap((void *)m.data, m.length);
+        m = { nullptr, 0 };
+    }
+    if (index.data != nullptr) munmap((void *)index.data, index.length);
+    index = { nullptr, 0 };
+    rows = 0;
+    blocks = 0;
+}
+
+bool ColumnStoreReader::open(const char *dir) {
+    directory = dir;
+    return refresh();
+}
+
+bool ColumnStoreReader::refresh() {
+    unmapAll();
+    uint64_t count = UINT64_MAX;
+    for (uint8_t c = 0; c < STORE_COLUMNS; c++) {
+        if (!mapFile(joinPath(directory, COLUMN_FILES[c]), columns[c].data, columns[c].length)) {
+            unmapAll();
+            return false;
+        }
+        uint64_t n = columns[c].length / COLUMN_SIZES[c];
+        if (n < count) count = n;
+    }
+    rows = count;
+
+    if (!mapFile(joinPath(directory, INDEX_FILE), index.data, index.length)) {
+        unmapAll();
+        return false;
+    }
+    if (index.length >= sizeof(IndexHeader)) {
+        const IndexHeader *header = (const IndexHeader *)index.data;
+        if (header->magic != INDEX_MAGIC || header->blockRows != STORE_BLOCK_ROWS) {
+            unmapAll();
+            return false;
+        }
+        uint64_t n = (index.length - sizeof(IndexHeader)) / sizeof(BlockSummary);
+        if (n > rows / STORE_BLOCK_ROWS) n = rows / STORE_BLOCK_ROWS;
+        blocks = (uint32_t)n;
+    }
+    return true;
+}
+
+void ColumnStoreReader::close() {
+    unmapAll();
+}
+
+uint64_t ColumnStoreReader::getRowCount() const {
+    return rows;
+}
+
+uint32_t ColumnStoreReader::getBlockCount() const {
+    return blocks;
+}
+
+const BlockSummary *ColumnStoreReader::summaries() const {
+    if (blocks == 0) return nullptr;
+    return (const BlockSummary *)(index.data + sizeof(IndexHeader));
+}
+
+const uint32_t *ColumnStoreReader::timestamps() const {
+    return (const uint32_t *)columns[COL_TIMESTAMP].data;
+}
+
+const float *ColumnStoreReader::floats(StoreField field) const {
+    switch (field) {
+    case FIELD_TEMPERATURE: return (const float *)columns[COL_TEMPERATURE].data;
+    case FIELD_HUMIDITY:    return (const float *)columns[COL_HUMIDITY].data;
+    case FIELD_BPM:         return (const float *)columns[COL_BPM].data;
+    default:                return nullptr;
+    }
+}
+
+const uint8_t *ColumnStoreReader::spo2() const {
+    return columns[COL_SPO2].data;
+}
+
+const double *ColumnStoreReader::latitudes() const {
+    return (const double *)columns[COL_LATITUDE].data;
+}
+
+const double *ColumnStoreReader::longitudes() const {
+    return (const double *)columns[COL_LONGITUDE].data;
+}
+
+const uint8_t *ColumnStoreReader::flags() const {
+    return columns[COL_FLAGS].data;
+}
+
+float ColumnStoreReader::value(StoreField field, uint64_t row) const {
+    if (field == FIELD_SPO2) {
+        uint8_t v = spo2()[row];
+        return v ? (float)v : NAN;
+    }
+    return floats(field)[row];
+}
+
+// First row in [lo, hi) whose timestamp is >= t (upper: > t)
+static uint64_t searchRows(const uint32_t *ts, uint64_t lo, uint64_t hi, uint32_t t, bool upper) {
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (upper ? ts[mid] <= t : ts[mid] < t) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void ColumnStoreReader::findRows(uint32_t from, uint32_t to, uint64_t &first, uint64_t &last) const {
+    first = last = 0;
+    if (rows == 0 || from > to) return;
+    const uint32_t *ts = timestamps();
+    const BlockSummary *blk = summaries();
+
+    // Narrow each bound to one block with the index, then search inside it
+    auto locate = [&](uint32_t t, bool upper) -> uint64_t {
+        uint32_t lo = 0, hi = blocks;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (upper ? blk[mid].lastTimestamp <= t : blk[mid].lastTimestamp < t) lo = mid + 1;
+            else hi = mid;
+        }
+        uint64_t start = (uint64_t)lo * STORE_BLOCK_ROWS;
+        uint64_t end = lo < blocks ? start + STORE_BLOCK_ROWS : rows;
+        return searchRows(ts, start, end, t, upper);
+    };
+    first = locate(from, false);
+    last = locate(to, true);
+    if (last < first) last = first;
+}
+
+Rollup ColumnStoreReader::rollup(StoreField field, uint32_t from, uint32_t to,
+                                 uint32_t *blocksSkipped) const {
+    Rollup result;
+    result.clear();
+    if (blocksSkipped != nullptr) *blocksSkipped = 0;
+
+    uint64_t first, last;
+    findRows(from, to, first, last);
+    const BlockSummary *blk = summaries();
+
+    uint64_t row = first;
+    while (row < last) {
+        uint64_t b = row / STORE_BLOCK_ROWS;
+        uint64_t blockStart = b * STORE_BLOCK_ROWS;
+        uint64_t blockEnd = blockStart + STORE_BLOCK_ROWS;
+        if (row == blockStart && blockEnd <= last && b < blocks) {
+            result.merge(blk[b].fields[field]);
+            if (blocksSkipped != nullptr) (*blocksSkipped)++;
+            row = blockEnd;
+            continue;
+        }
+        uint64_t end = blockEnd < last ? blockEnd : last;
+        if (field == FIELD_SPO2) {
+            const uint8_t *col = spo2();
+            for (; row < end; row++) {
+                if (col[row]) result.add(col[row]);
+            }
+        } else {
+            const float *col = floats(field);
+            for (; row < end; row++) result.add(col[row]);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,156 @@
+#ifndef COMP_ALMACEN_H
+#define COMP_ALMACEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include "COMP_COMPRESION.h"
+
+// Rows summarised by one entry of the sparse time index
+#ifndef STORE_BLOCK_ROWS
+#define STORE_BLOCK_ROWS 4096
+#endif
+
+/*
+ *  On-disk layout, one directory per device:
+ *
+ *      timestamp.u32  temperature.f32  humidity.f32  bpm.f32  spo2.u8
+ *      latitude.f64   longitude.f64    flags.u8      index.blk
+ *
+ *  Every column is a raw little-endian array, appended row by row.
+ *  Missing values are NaN (0 for SpO2). index.blk holds a header and one
+ *  BlockSummary per complete block of STORE_BLOCK_ROWS rows.
+ */
+
+// Column files per device
+#define STORE_COLUMNS 8
+
+// Fields with per-block summaries
+enum StoreField : uint8_t {
+    FIELD_TEMPERATURE = 0,
+    FIELD_HUMIDITY,
+    FIELD_BPM,
+    FIELD_SPO2,
+    STORE_SUMMARY_FIELDS
+};
+
+// min/max/sum over the valid values of a field
+struct Rollup {
+    float    min;
+    float    max;
+    double   sum;
+    uint32_t count;
+
+    void clear();
+    void add(float value);
+    void merge(const Rollup &other);
+    float mean() const;
+};
+
+struct BlockSummary {
+    uint32_t firstTimestamp;
+    uint32_t lastTimestamp;
+    uint32_t rows;
+    uint32_t reserved;
+    Rollup   fields[STORE_SUMMARY_FIELDS];
+};
+
+/**
+ *  Append-only writer for one device. Rows must arrive in timestamp
+ *  order; reopening an existing directory continues where it ended
+ *  (columns left uneven by a crash are cut to the shortest one).
+ */
+class ColumnStoreWriter {
+public:
+    ColumnStoreWriter();
+    ~ColumnStoreWriter();
+
+    /**
+     *  @param directory  Device directory, created if missing (its parent must exist)
+     *  @return false if the files cannot be opened
+     */
+    bool open(const char *directory);
+    void close();
+
+    /**
+     *  Append one record.
+     *  @return false if it is older than the last row or on a write error
+     */
+    bool append(const VitalsRecord &record);
+    bool flush();
+
+    uint64_t getRowCount() const;
+    const char *getErrorMessage() const;
+
+private:
+    FILE *files[STORE_COLUMNS];
+    FILE *index;
+    uint64_t rows;
+    uint32_t lastTimestamp;
+    BlockSummary block;      // summary of the block being filled
+    const char *errorMessage;
+
+    void startBlock();
+    void summarise(const VitalsRecord &record);
+    bool recoverTail(const std::string &directory);
+};
+
+/**
+ *  Read-only, zero-copy view of one device. Columns are memory mapped;
+ *  rows appended after open() become visible after refresh().
+ */
+class ColumnStoreReader {
+public:
+    ColumnStoreReader();
+    ~ColumnStoreReader();
+
+    bool open(const char *directory);
+    bool refresh();
+    void close();
+
+    uint64_t getRowCount() const;
+    uint32_t getBlockCount() const;     // complete, indexed blocks
+
+    // Raw columns (getRowCount() entries each)
+    const uint32_t *timestamps() const;
+    const float    *floats(StoreField field) const;   // not FIELD_SPO2
+    const uint8_t  *spo2() const;
+    const double   *latitudes() const;
+    const double   *longitudes() const;
+    const uint8_t  *flags() const;
+
+    // Value of a summarised field (NaN when missing)
+    float value(StoreField field, uint64_t row) const;
+
+    /**
+     *  Rows with from <= timestamp <= to, as [first, last).
+     *  Uses the block index and then a binary search inside one block.
+     */
+    void findRows(uint32_t from, uint32_t to, uint64_t &first, uint64_t &last) const;
+
+    /**
+     *  min/max/mean of a field over a time range. Blocks fully inside the
+     *  range are answered from their summary without touching the column.
+     *  @param blocksSkipped  Optional: number of blocks answered from the index
+     */
+    Rollup rollup(StoreField field, uint32_t from, uint32_t to,
+                  uint32_t *blocksSkipped = nullptr) const;
+
+private:
+    struct Mapping {
+        const uint8_t *data;
+        size_t length;
+    };
+
+    std::string directory;
+    Mapping columns[STORE_COLUMNS];
+    Mapping index;
+    uint64_t rows;
+    uint32_t blocks;
+
+    const BlockSummary *summaries() const;
+    void unmapAll();
+};
+
+#endif // COMP_ALMACEN_H
@@ -0,0 +1,62 @@
+#ifndef COMP_COLA_H
+#define COMP_COLA_H
+
+#include <stddef.h>
+#include <atomic>
+
+/**
+ *  Bounded single-producer / single-consumer ring.
+ *  push() and pop() are wait-free; each side keeps a cached copy of the
+ *  other side's index so the shared cache line is only touched when the
+ *  ring looks full (producer) or empty (consumer).
+ *  @tparam N  Capacity, power of two
+ */
+template <class T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), tailCache(0), tail(0), headCache(0) {}
+
+    // Producer side. @return false if the ring is full
+    bool push(const T &value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - headCache == N) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache == N) return false;
+        }
+        slots[t & (N - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. @return false if the ring is empty
+    bool pop(T &value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) return false;
+        }
+        value = slots[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate number of queued elements (exact from either side)
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+private:
+    // Consumer-owned indices
+    alignas(64) std::atomic<size_t> head;
+    size_t tailCache;
+
+    // Producer-owned indices
+    alignas(64) std::atomic<size_t> tail;
+    size_t headCache;
+
+    alignas(64) T slots[N];
+};
+
+#endif // COMP_COLA_H
@@ -0,0 +1,556 @@
+#include "COMP_GATEWAY.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <algorithm>
+
+// epoll tags: device index in the low bits, kind in the high bits
+static constexpr uint64_t TAG_DEVICE   = 0;
+static constexpr uint64_t TAG_LISTENER = 1ull << 62;
+static constexpr uint64_t TAG_WAKE     = 2ull << 62;
+static constexpr uint64_t TAG_RESUME   = 3ull << 62;
+static constexpr uint64_t TAG_MASK     = 3ull << 62;
+
+static constexpr int      READ_BUFFER_SIZE   = 64 * 1024;
+static constexpr int      READS_PER_EVENT    = 4;     // fairness between devices
+static constexpr int      EPOLL_BATCH        = 64;
+static constexpr int      EPOLL_TIMEOUT_MS   = 100;
+static constexpr uint32_t WORKER_BATCH       = 32;    // records per device per pass
+static constexpr uint32_t WORKER_IDLE_US     = 100;
+
+static uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void pinToCpu(unsigned cpu) {
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (cpus == 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// ---------- Latency histogram ----------
+
+uint8_t LatencyHistogram::bucketOf(uint32_t us) {
+    if (us < 4) return (uint8_t)us;
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint8_t sub = (us >> (msb - 2)) & 3;
+    return (uint8_t)((msb - 1) * 4 + sub);
+}
+
+uint32_t LatencyHistogram::bucketUpperUs(uint8_t bucket) {
+    if (bucket < 4) return bucket;
+    uint8_t msb = bucket / 4 + 1;
+    uint8_t sub = bucket % 4;
+    uint64_t upper = ((uint64_t)(4 + sub + 1) << (msb - 2)) - 1;
+    return upper > UINT32_MAX ? UINT32_MAX : (uint32_t)upper;
+}
+
+void LatencyHistogram::clear() {
+    memset(counts, 0, sizeof(counts));
+    total = 0;
+    maxUs = 0;
+}
+
+uint32_t LatencyHistogram::percentileUs(float fraction) const {
+    if (total == 0) return 0;
+    uint64_t target = (uint64_t)(fraction * (double)total);
+    if (target >= total) target = total - 1;
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < BUCKETS; b++) {
+        seen += counts[b];
+        if (seen > target) {
+            uint32_t upper = bucketUpperUs(b);
+            return upper < maxUs ? upper : maxUs;
+        }
+    }
+    return maxUs;
+}
+
+// ---------- Internal state ----------
+
+struct Gateway::Device {
+    int      fd;
+    uint32_t index;
+    uint8_t  reader;
+    std::string name;
+    std::atomic<bool> connected;
+
+    // Reader side
+    ReportParser parser;
+    uint64_t readNs;
+    std::atomic<uint64_t> received;
+    std::atomic<uint64_t> throttles;
+    std::atomic<uint32_t> parseErrors;
+    // Records parsed while the queue was full; the fd is out of epoll
+    // until they are all queued
+    std::vector<GatewayRecord> backlog;
+    size_t backlogHead;
+    std::atomic<bool> throttled;
+
+    SpscQueue<GatewayRecord, GATEWAY_QUEUE_DEPTH> queue;
+
+    // Worker side
+    DeviceAggregate aggregate;
+    std::unique_ptr<ColumnStoreWriter> store[GATEWAY_STORE_CHANNELS];   // opened on first use
+    bool storeDirty;
+
+    Device(int fd, uint32_t index, uint8_t reader, const char *name)
+        : fd(fd), index(index), reader(reader), name(name), connected(true), readNs(0),
+          received(0), throttles(0), parseErrors(0), backlogHead(0), throttled(false),
+          storeDirty(false) {
+        resetAggregate(aggregate);
+    }
+};
+
+struct Gateway::Reader {
+    int epollFd;
+    int resumeFd;                   // workers signal throttled devices they drained
+    std::vector<uint32_t> throttled;
+    std::thread thread;
+};
+
+struct Gateway::Worker {
+    std::thread thread;
+    std::atomic<uint64_t> processed;
+    std::atomic<uint64_t> alerts;
+    std::atomic<uint64_t> stored;
+    std::atomic<uint64_t> storeSkipped;
+
+    // Written by the worker, swapped out by getStats()
+    std::atomic<uint64_t> latency[LatencyHistogram::BUCKETS];
+    std::atomic<uint32_t> latencyMaxUs;
+
+    Worker() : processed(0), alerts(0), stored(0), storeSkipped(0), latencyMaxUs(0) {
+        for (auto &c : latency) c.store(0, std::memory_order_relaxed);
+    }
+};
+
+// ---------- Construction ----------
+
+Gateway::Gateway(uint8_t readerThreads, uint8_t workerThreads, bool pinCpus)
+    : readerCount(readerThreads ? readerThreads : 1), workerCount(workerThreads ? workerThreads : 1),
+      pinCpus(pinCpus), readers(new Reader[readerCount]), workers(new Worker[workerCount]),
+      devices(new std::unique_ptr<Device>[GATEWAY_MAX_DEVICES]), deviceCount(0),
+      wakeFd(-1), running(false), readersStopped(false), errorMessage("Sin error") {
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    for (uint8_t r = 0; r < readerCount; r++) {
+        readers[r].epollFd = epoll_create1(EPOLL_CLOEXEC);
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.u64 = TAG_WAKE;
+        epoll_ctl(readers[r].epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+        readers[r].resumeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        ev.data.u64 = TAG_RESUME;
+        epoll_ctl(readers[r].epollFd, EPOLL_CTL_ADD, readers[r].resumeFd, &ev);
+    }
+}
+
+Gateway::~Gateway() {
+    stop();
+    uint32_t count = deviceCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        if (devices[i]->fd >= 0) close(devices[i]->fd);
+    }
+    for (int fd : listeners) close(fd);
+    for (const std::string &path : socketPaths) unlink(path.c_str());
+    for (uint8_t r = 0; r < readerCount; r++) {
+        close(readers[r].epollFd);
+        close(readers[r].resumeFd);
+    }
+    if (wakeFd >= 0) close(wakeFd);
+}
+
+const char *Gateway::getErrorMessage() const {
+    return errorMessage;
+}
+
+// ---------- Sources ----------
+
+bool Gateway::listenUnix(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errorMessage = "Ruta de socket demasiado larga";
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        errorMessage = "No se pudo crear el socket";
+        return false;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        errorMessage = "No se pudo escuchar en el socket";
+        close(fd);
+        return false;
+    }
+
+    // New connections are accepted by the first reader
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = TAG_LISTENER | (uint64_t)fd;
+    epoll_ctl(readers[0].epollFd, EPOLL_CTL_ADD, fd, &ev);
+    listeners.push_back(fd);
+    socketPaths.push_back(path);
+    return true;
+}
+
+static speed_t baudToSpeed(uint32_t baud) {
+    switch (baud) {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default:     return B115200;
+    }
+}
+
+bool Gateway::addSerial(const char *path, uint32_t baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        errorMessage = "No se pudo abrir el puerto serie";
+        return false;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, baudToSpeed(baud));
+        cfsetospeed(&tio, baudToSpeed(baud));
+        tio.c_cflag |= CLOCAL | CREAD;
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    const char *name = strrchr(path, '/');
+    return registerDevice(fd, name != nullptr ? name + 1 : path);
+}
+
+bool Gateway::setStore(const char *directory) {
+    if (running.load(std::memory_order_acquire)) {
+        errorMessage = "El almacén se configura antes de arrancar";
+        return false;
+    }
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        errorMessage = "No se pudo crear el directorio del almacén";
+        return false;
+    }
+    storeDirectory = directory;
+    return true;
+}
+
+bool Gateway::registerDevice(int fd, const char *name) {
+    // Registration is rare; the lock keeps slots unique when a serial
+    // port is added while the first reader accepts connections
+    std::lock_guard<std::mutex> lock(registerLock);
+    uint32_t index = deviceCount.load(std::memory_order_relaxed);
+    if (index >= GATEWAY_MAX_DEVICES) {
+        errorMessage = "Demasiados dispositivos";
+        close(fd);
+        return false;
+    }
+    uint8_t reader = index % readerCount;
+    std::string socketName;
+    if (name == nullptr) {
+        socketName = "dispositivo-" + std::to_string(index);
+        name = socketName.c_str();
+    }
+    devices[index].reset(new Device(fd, index, reader, name));
+    deviceCount.store(index + 1, std::memory_order_release);
+    watchDevice(*devices[index]);
+    return true;
+}
+
+void Gateway::watchDevice(Device &device) {
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.u64 = TAG_DEVICE | device.index;
+    epoll_ctl(readers[device.reader].epollFd, EPOLL_CTL_ADD, device.fd, &ev);
+}
+
+void Gateway::closeDevice(Device &device) {
+    epoll_ctl(readers[device.reader].epollFd, EPOLL_CTL_DEL, device.fd, nullptr);
+    close(device.fd);
+    device.fd = -1;
+    device.connected.store(false, std::memory_order_release);
+}
+
+void Gateway::acceptAll(int listenFd) {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;   // EAGAIN or a transient error
+        registerDevice(fd, nullptr);
+    }
+}
+
+// ---------- Threads ----------
+
+bool Gateway::start() {
+    if (running.exchange(true)) return true;
+    readersStopped.store(false, std::memory_order_release);
+    for (uint8_t r = 0; r < readerCount; r++) {
+        readers[r].thread = std::thread(&Gateway::readerLoop, this, r);
+    }
+    for (uint8_t w = 0; w < workerCount; w++) {
+        workers[w].thread = std::thread(&Gateway::workerLoop, this, w);
+    }
+    return true;
+}
+
+void Gateway::stop() {
+    if (!running.exchange(false)) return;
+    uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) { /* readers time out anyway */ }
+    for (uint8_t r = 0; r < readerCount; r++) readers[r].thread.join();
+    readersStopped.store(true, std::memory_order_release);
+    for (uint8_t w = 0; w < workerCount; w++) workers[w].thread.join();
+}
+
+void Gateway::readerLoop(uint8_t index) {
+    if (pinCpus) pinToCpu(index);
+    Reader &reader = readers[index];
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[READ_BUFFER_SIZE]);
+    struct epoll_event events[EPOLL_BATCH];
+
+    while (running.load(std::memory_order_acquire)) {
+        int n = epoll_wait(reader.epollFd, events, EPOLL_BATCH, EPOLL_TIMEOUT_MS);
+        for (int i = 0; i < n; i++) {
+            uint64_t tag = events[i].data.u64;
+            switch (tag & TAG_MASK) {
+            case TAG_WAKE:
+                break;
+            case TAG_RESUME: {
+                uint64_t count;
+                if (read(reader.resumeFd, &count, sizeof(count)) < 0) { /* already cleared */ }
+                break;
+            }
+            case TAG_LISTENER:
+                acceptAll((int)(tag & ~TAG_MASK));
+                break;
+            default: {
+                Device &device = *devices[(uint32_t)(tag & ~TAG_MASK)];
+                // Skip events of this batch for a device throttled meanwhile
+                if (device.throttled.load(std::memory_order_relaxed)) break;
+                readDevice(device, buffer.get(), READ_BUFFER_SIZE);
+                if (!device.backlog.empty()) throttleDevice(reader, device);
+                break;
+            }
+            }
+        }
+        // Also after a timeout, in case a drain was signalled before the
+        // device was throttled
+        if (!reader.throttled.empty()) resumeDevices(reader);
+    }
+
+    // Workers keep draining until readersStopped: hand them the backlogs
+    for (uint32_t d : reader.throttled) {
+        while (!flushBacklog(*devices[d])) std::this_thread::yield();
+    }
+}
+
+void Gateway::readDevice(Device &device, uint8_t *buffer, size_t size) {
+    for (int i = 0; i < READS_PER_EVENT; i++) {
+        ssize_t n = read(device.fd, buffer, size);
+        if (n > 0) {
+            device.readNs = monotonicNs();
+            device.parser.feed(buffer, (size_t)n, onRecord, &device);
+            device.parseErrors.store(device.parser.getErrorCount(), std::memory_order_relaxed);
+            if (!device.backlog.empty()) return;   // queue full: stop here
+            if ((size_t)n < size) return;   // drained
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        } else {
+            closeDevice(device);   // EOF or error
+            return;
+        }
+    }
+}
+
+void Gateway::onRecord(void *context, const VitalsRecord &record, uint8_t channel) {
+    Device &device = *static_cast<Device *>(context);
+    GatewayRecord rec;
+    rec.vitals = record;
+    rec.receivedNs = device.readNs;
+    rec.channel = channel;
+    device.received.fetch_add(1, std::memory_order_relaxed);
+    // A history frame decodes hundreds of records at once, more than the
+    // queue holds: keep the rest, in order, for when the worker drains
+    if (!device.backlog.empty() || !device.queue.push(rec)) device.backlog.push_back(rec);
+}
+
+void Gateway::throttleDevice(Reader &reader, Device &device) {
+    epoll_ctl(reader.epollFd, EPOLL_CTL_DEL, device.fd, nullptr);
+    device.throttled.store(true, std::memory_order_relaxed);
+    device.throttles.fetch_add(1, std::memory_order_relaxed);
+    reader.throttled.push_back(device.index);
+    // Pairs with the fence in drainDevice(): either the worker sees the
+    // flag and signals, or the next resumeDevices() sees the free slots
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+bool Gateway::flushBacklog(Device &device) {
+    while (device.backlogHead < device.backlog.size() &&
+           device.queue.push(device.backlog[device.backlogHead])) {
+        device.backlogHead++;
+    }
+    if (device.backlogHead < device.backlog.size()) return false;
+    device.backlog.clear();
+    device.backlogHead = 0;
+    return true;
+}
+
+void Gateway::resumeDevices(Reader &reader) {
+    auto resumed = [this](uint32_t d) {
+        Device &device = *devices[d];
+        if (!flushBacklog(device)) return false;
+        device.throttled.store(false, std::memory_order_relaxed);
+        // Level-triggered: bytes left in the kernel buffer fire at once
+        watchDevice(device);
+        return true;
+    };
+    reader.throttled.erase(std::remove_if(reader.throttled.begin(), reader.throttled.end(), resumed),
+                           reader.throttled.end());
+}
+
+void Gateway::workerLoop(uint8_t index) {
+    if (pinCpus) pinToCpu(readerCount + index);
+    Worker &worker = workers[index];
+
+    // Keep going after stop() until every queue is empty
+    bool stopping = false;
+    while (true) {
+        if (readersStopped.load(std::memory_order_acquire)) stopping = true;
+        uint32_t count = deviceCount.load(std::memory_order_acquire);
+        uint32_t done = 0;
+        for (uint32_t i = index; i < count; i += workerCount) {
+            done += drainDevice(worker, *devices[i]);
+        }
+        if (done == 0) {
+            // Idle: make the rows written so far visible to readers
+            if (!storeDirectory.empty()) {
+                for (uint32_t i = index; i < count; i += workerCount) flushStore(*devices[i]);
+            }
+            if (stopping) return;
+            usleep(WORKER_IDLE_US);
+        }
+    }
+}
+
+uint32_t Gateway::drainDevice(Worker &worker, Device &device) {
+    GatewayRecord rec;
+    uint32_t n = 0;
+    uint64_t alerts = 0;
+    while (n < WORKER_BATCH && device.queue.pop(rec)) {
+        if (aggregateRecord(device.aggregate, rec.vitals, rec.channel)) alerts++;
+        if (!storeDirectory.empty()) storeRecord(worker, device, rec);
+
+        uint64_t elapsedNs = monotonicNs() - rec.receivedNs;
+        uint32_t us = elapsedNs / 1000 > UINT32_MAX ? UINT32_MAX : (uint32_t)(elapsedNs / 1000);
+        worker.latency[LatencyHistogram::bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+        if (us > worker.latencyMaxUs.load(std::memory_order_relaxed)) {
+            worker.latencyMaxUs.store(us, std::memory_order_relaxed);
+        }
+        n++;
+    }
+    if (n) {
+        worker.processed.fetch_add(n, std::memory_order_relaxed);
+        if (alerts) worker.alerts.fetch_add(alerts, std::memory_order_relaxed);
+        // The reader stopped reading this device: it has room again
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (device.throttled.load(std::memory_order_relaxed)) {
+            uint64_t one = 1;
+            if (write(readers[device.reader].resumeFd, &one, sizeof(one)) < 0) { /* already signalled */ }
+        }
+    }
+    return n;
+}
+
+void Gateway::storeRecord(Worker &worker, Device &device, const GatewayRecord &rec) {
+    if (rec.channel >= GATEWAY_STORE_CHANNELS) {
+        worker.storeSkipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::unique_ptr<ColumnStoreWriter> &writer = device.store[rec.channel];
+    if (!writer) {
+        std::string path = storeDirectory + "/" + device.name;
+        if (rec.channel > 0) path += "-c" + std::to_string(rec.channel);
+        writer.reset(new ColumnStoreWriter());
+        writer->open(path.c_str());
+    }
+    // History frames repeat reports already stored as text: those rows
+    // are older than the last one and are skipped here
+    if (writer->append(rec.vitals)) {
+        device.storeDirty = true;
+        worker.stored.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        worker.storeSkipped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Gateway::flushStore(Device &device) {
+    if (!device.storeDirty) return;
+    for (auto &writer : device.store) {
+        if (writer) writer->flush();
+    }
+    device.storeDirty = false;
+}
+
+// ---------- Statistics ----------
+
+void Gateway::getStats(GatewayStats &stats, bool resetLatency) {
+    memset(&stats, 0, sizeof(stats));
+    uint32_t count = deviceCount.load(std::memory_order_acquire);
+    stats.devices = count;
+    for (uint32_t i = 0; i < count; i++) {
+        const Device &d = *devices[i];
+        if (d.connected.load(std::memory_order_acquire)) stats.connected++;
+        stats.received    += d.received.load(std::memory_order_relaxed);
+        stats.throttled   += d.throttles.load(std::memory_order_relaxed);
+        stats.parseErrors += d.parseErrors.load(std::memory_order_relaxed);
+    }
+    for (uint8_t w = 0; w < workerCount; w++) {
+        Worker &worker = workers[w];
+        stats.processed += worker.processed.load(std::memory_order_relaxed);
+        stats.alerts    += worker.alerts.load(std::memory_order_relaxed);
+        stats.stored    += worker.stored.load(std::memory_order_relaxed);
+        stats.storeSkipped += worker.storeSkipped.load(std::memory_order_relaxed);
+        for (uint8_t b = 0; b < LatencyHistogram::BUCKETS; b++) {
+            uint64_t c = resetLatency ? worker.latency[b].exchange(0, std::memory_order_relaxed)
+                                      : worker.latency[b].load(std::memory_order_relaxed);
+            stats.latency.counts[b] += c;
+            stats.latency.total += c;
+        }
+        uint32_t maxUs = resetLatency ? worker.latencyMaxUs.exchange(0, std::memory_order_relaxed)
+                                      : worker.latencyMaxUs.load(std::memory_order_relaxed);
+        if (maxUs > stats.latency.maxUs) stats.latency.maxUs = maxUs;
+    }
+}
+
+const DeviceAggregate *Gateway::getAggregate(uint32_t device) const {
+    if (running.load(std::memory_order_acquire)) return nullptr;
+    if (device >= deviceCount.load(std::memory_order_acquire)) return nullptr;
+    return &devices[device]->aggregate;
+}
+
+uint32_t Gateway::getDeviceCount() const {
+    return deviceCount.load(std::memory_order_acquire);
+}
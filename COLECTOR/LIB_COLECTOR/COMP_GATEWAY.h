@@ -0,0 +1,162 @@
+#ifndef COMP_GATEWAY_H
+#define COMP_GATEWAY_H
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "COMP_COLA.h"
+#include "COMP_PROTOCOLO.h"
+#include "COMP_AGREGADOR.h"
+#include "COMP_ALMACEN.h"
+
+// Devices (serial ports + socket connections) over the gateway lifetime
+#ifndef GATEWAY_MAX_DEVICES
+#define GATEWAY_MAX_DEVICES 8192
+#endif
+
+// Parsed records buffered per device between its reader and its worker;
+// when the queue fills, the reader stops reading that device until the
+// worker drains it
+#ifndef GATEWAY_QUEUE_DEPTH
+#define GATEWAY_QUEUE_DEPTH 64
+#endif
+
+// Channels per device kept in the columnar store (SENSOR_MAX_CHANNELS)
+#ifndef GATEWAY_STORE_CHANNELS
+#define GATEWAY_STORE_CHANNELS 8
+#endif
+
+// One parsed record on its way to a worker
+struct GatewayRecord {
+    VitalsRecord vitals;
+    uint64_t receivedNs;    // CLOCK_MONOTONIC when its last bytes were read
+    uint8_t  channel;
+};
+
+/**
+ *  Latency histogram with four buckets per power of two (±12%),
+ *  from 1 us up to ~70 minutes.
+ */
+struct LatencyHistogram {
+    static constexpr uint8_t BUCKETS = 128;
+
+    uint64_t counts[BUCKETS];
+    uint64_t total;
+    uint32_t maxUs;
+
+    static uint8_t bucketOf(uint32_t us);
+    static uint32_t bucketUpperUs(uint8_t bucket);
+
+    void clear();
+    // Upper bound of the bucket holding the given fraction (0..1)
+    uint32_t percentileUs(float fraction) const;
+};
+
+struct GatewayStats {
+    uint32_t devices;       // registered since start
+    uint32_t connected;
+    uint64_t received;      // records parsed
+    uint64_t throttled;     // times a device was not read until its worker caught up
+    uint64_t processed;     // records evaluated by the workers
+    uint64_t alerts;        // records with at least one alert
+    uint64_t stored;        // records appended to the columnar store
+    uint64_t storeSkipped;  // older than the stored rows, bad channel or write error
+    uint64_t parseErrors;
+    LatencyHistogram latency;   // read -> evaluated
+};
+
+/**
+ *  Collector for many monitors at once.
+ *  Reader threads wait on epoll and parse each device stream into that
+ *  device's lock-free queue; worker threads drain the queues, re-run the
+ *  alert thresholds and keep a per-device aggregate.
+ *  Each device belongs to exactly one reader and one worker, so every
+ *  queue has a single producer and a single consumer.
+ *  A full queue never blocks the reader: the records that did not fit
+ *  wait on the device, which leaves epoll until its worker drains them,
+ *  and the unread bytes stay in the kernel buffer.
+ */
+class Gateway {
+public:
+    /**
+     *  @param readerThreads  Reader (epoll) threads
+     *  @param workerThreads  Worker threads
+     *  @param pinCpus        Pin readers then workers to consecutive CPUs
+     */
+    Gateway(uint8_t readerThreads, uint8_t workerThreads, bool pinCpus = false);
+    ~Gateway();
+
+    // Sources; may be added before or after start()
+    bool listenUnix(const char *path);
+    bool addSerial(const char *path, uint32_t baud = 115200);
+
+    /**
+     *  Keep every evaluated record in a columnar store (COMP_ALMACEN).
+     *  Each device gets <directory>/<name>, channel N > 0 <name>-cN as in
+     *  IMPORTADOR; the name is the serial port (ttyUSB0) or dispositivo-I
+     *  for the I-th socket connection. Workers write the rows and flush
+     *  them whenever they run out of records. Call before start().
+     */
+    bool setStore(const char *directory);
+
+    bool start();
+    void stop();
+
+    /**
+     *  Counters since start. Latency only covers records evaluated since
+     *  the previous call with resetLatency set.
+     */
+    void getStats(GatewayStats &stats, bool resetLatency);
+
+    // Aggregate of a device; only valid once stop() has returned
+    const DeviceAggregate *getAggregate(uint32_t device) const;
+    uint32_t getDeviceCount() const;
+
+    const char *getErrorMessage() const;
+
+private:
+    struct Device;
+    struct Reader;
+    struct Worker;
+
+    uint8_t readerCount;
+    uint8_t workerCount;
+    bool    pinCpus;
+
+    std::unique_ptr<Reader[]> readers;
+    std::unique_ptr<Worker[]> workers;
+    std::unique_ptr<std::unique_ptr<Device>[]> devices;
+    std::atomic<uint32_t> deviceCount;
+    std::mutex registerLock;    // serial ports vs accepted connections
+
+    std::vector<int> listeners;
+    std::vector<std::string> socketPaths;
+    std::string storeDirectory;         // empty: no store
+    int  wakeFd;
+    std::atomic<bool> running;
+    std::atomic<bool> readersStopped;   // workers drain the queues and leave
+    const char *errorMessage;
+
+    bool registerDevice(int fd, const char *name);
+    void closeDevice(Device &device);
+    void acceptAll(int listenFd);
+    void readDevice(Device &device, uint8_t *buffer, size_t size);
+    void watchDevice(Device &device);
+    void throttleDevice(Reader &reader, Device &device);
+    bool flushBacklog(Device &device);
+    void resumeDevices(Reader &reader);
+
+    void readerLoop(uint8_t index);
+    void workerLoop(uint8_t index);
+    uint32_t drainDevice(Worker &worker, Device &device);
+    void storeRecord(Worker &worker, Device &device, const GatewayRecord &rec);
+    void flushStore(Device &device);
+
+    static void onRecord(void *context, const VitalsRecord &record, uint8_t channel);
+};
+
+#endif // COMP_GATEWAY_H
@@ -0,0 +1,186 @@
+#include "COMP_PROTOCOLO.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Line prefixes printed by main.ino
+static const char PREFIX_CHANNEL[]   = "Canal ";
+static const char PREFIX_TEMP_HIGH[] = "Temperatura alta: ";
+static const char PREFIX_HR_ALERT[]  = "Frecuencia cardiaca anómala: ";
+static const char PREFIX_GEOFENCE[]  = "Fuera de la zona de cuidado";
+static const char PREFIX_TEMP[]      = "Temp: ";
+static const char PREFIX_TIMESTAMP[] = "Timestamp: ";
+static const char PREFIX_LOCATION[]  = "Ubicación: Lat ";
+static const char REPORT_END[]       = "-----";
+
+static bool startsWith(const char *s, const char *prefix, size_t prefixLen) {
+    return strncmp(s, prefix, prefixLen) == 0;
+}
+
+#define STARTS_WITH(s, p) startsWith((s), (p), sizeof(p) - 1)
+
+ReportParser::ReportParser() {
+    reset();
+}
+
+void ReportParser::reset() {
+    state = TEXT;
+    lineStart = true;
+    lineLen = 0;
+    frameType = 0;
+    frameLen = 0;
+    framePos = 0;
+    errors = 0;
+    clearPending();
+}
+
+void ReportParser::clearPending() {
+    memset(&pending, 0, sizeof(pending));
+    pendingChannel = 0;
+    pendingAny = false;
+}
+
+uint32_t ReportParser::getErrorCount() const {
+    return errors;
+}
+
+void ReportParser::feed(const uint8_t *data, size_t length, ReportCallback done, void *context) {
+    for (size_t i = 0; i < length; i++) {
+        uint8_t b = data[i];
+        switch (state) {
+        case TEXT:
+            if (lineStart && b == FRAME_START) {
+                state = FRAME_TYPE;
+                break;
+            }
+            if (b == '\n') {
+                line[lineLen] = '\0';
+                parseLine(done, context);
+                lineLen = 0;
+                lineStart = true;
+            } else {
+                lineStart = false;
+                if (b != '\r' && lineLen < PROTOCOL_MAX_LINE - 1) line[lineLen++] = (char)b;
+            }
+            break;
+        case FRAME_TYPE:
+            frameType = b;
+            state = FRAME_LEN_LO;
+            break;
+        case FRAME_LEN_LO:
+            frameLen = b;
+            state = FRAME_LEN_HI;
+            break;
+        case FRAME_LEN_HI:
+            frameLen |= (uint16_t)b << 8;
+            framePos = 0;
+            if (frameLen > PROTOCOL_MAX_FRAME) {
+                // Cannot hold it: count it and resynchronise on the text
+                errors++;
+                state = TEXT;
+                lineStart = false;
+            } else if (frameLen == 0) {
+                parseFrame(done, context);
+                state = TEXT;
+            } else {
+                if (frame.size() < frameLen) frame.resize(PROTOCOL_MAX_FRAME);
+                state = FRAME_PAYLOAD;
+            }
+            break;
+        case FRAME_PAYLOAD: {
+            // Copy as much of the payload as is available at once
+            size_t n = length - i;
+            if (n > (size_t)(frameLen - framePos)) n = frameLen - framePos;
+            memcpy(&frame[framePos], &data[i], n);
+            framePos += n;
+            i += n - 1;
+            if (framePos == frameLen) {
+                parseFrame(done, context);
+                state = TEXT;
+                lineStart = true;
+            }
+            break;
+        }
+        }
+    }
+}
+
+void ReportParser::parseLine(ReportCallback done, void *context) {
+    const char *s = line;
+
+    if (STARTS_WITH(s, REPORT_END)) {
+        if (pendingAny) done(context, pending, pendingChannel);
+        clearPending();
+    } else if (STARTS_WITH(s, PREFIX_CHANNEL)) {
+        pendingChannel = (uint8_t)strtoul(s + sizeof(PREFIX_CHANNEL) - 1, nullptr, 10);
+    } else if (STARTS_WITH(s, PREFIX_TEMP_HIGH)) {
+        // Alert lines carry the window maximum or extreme that fired the
+        // alert; the record keeps the "Temp:" means and only flags it
+        pending.flags |= REC_ALERT_TEMPERATURE;
+        pendingAny = true;
+    } else if (STARTS_WITH(s, PREFIX_HR_ALERT)) {
+        pending.flags |= REC_ALERT_HEART_RATE;
+        pendingAny = true;
+    } else if (STARTS_WITH(s, PREFIX_GEOFENCE)) {
+        pending.flags |= REC_ALERT_GEOFENCE;
+        pendingAny = true;
+    } else if (STARTS_WITH(s, PREFIX_TEMP)) {
+        // "Temp: 36.50 °C, BPM: 72.0, SpO2: 98%" or "Temp: N/A, BPM: ..."
+        const char *value = s + sizeof(PREFIX_TEMP) - 1;
+        if (strncmp(value, "N/A", 3) != 0) {
+            pending.temperature = strtof(value, nullptr);
+            pending.flags |= REC_HAS_TEMPERATURE;
+        }
+        const char *bpm = strstr(value, "BPM: ");
+        if (bpm != nullptr) {
+            pending.bpm = strtof(bpm + 5, nullptr);
+            if (pending.bpm > 0.0f) pending.flags |= REC_HAS_BPM;
+        }
+        const char *spo2 = strstr(value, "SpO2: ");
+        if (spo2 != nullptr) {
+            pending.spo2 = (uint8_t)strtoul(spo2 + 6, nullptr, 10);
+            if (pending.spo2 > 0) pending.flags |= REC_HAS_SPO2;
+        }
+        pendingAny = true;
+    } else if (STARTS_WITH(s, PREFIX_TIMESTAMP)) {
+        int d, mo, y, h, mi, se;
+        if (sscanf(s + sizeof(PREFIX_TIMESTAMP) - 1, "%d/%d/%d %d:%d:%d",
+                   &d, &mo, &y, &h, &mi, &se) == 6) {
+            pending.timestamp = civilToEpoch(y, mo, d, h, mi, se);
+        }
+    } else if (STARTS_WITH(s, PREFIX_LOCATION)) {
+        double lat, lon;
+        if (sscanf(s + sizeof(PREFIX_LOCATION) - 1, "%lf, Lon %lf", &lat, &lon) == 2) {
+            pending.latitude = lat;
+            pending.longitude = lon;
+            // The firmware prints 0,0 without a fix
+            if (lat != 0.0 || lon != 0.0) pending.flags |= REC_HAS_LOCATION;
+        }
+    }
+}
+
+void ReportParser::parseFrame(ReportCallback done, void *context) {
+    if (frameType != FRAME_HISTORY) {
+        errors++;
+        return;
+    }
+    TimeSeriesDecoder decoder(frame.data(), frameLen);
+    VitalsRecord rec;
+    uint16_t count = 0;
+    while (decoder.next(rec)) {
+        done(context, rec, 0);
+        count++;
+    }
+    if (count == 0 && frameLen > 0) errors++;
+}
+
+uint32_t civilToEpoch(int year, int month, int day, int hour, int minute, int second) {
+    // Days from 1970-01-01 (proleptic Gregorian calendar)
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yoe = (unsigned)(year - era * 400);
+    unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int32_t days = era * 146097 + (int32_t)doe - 719468;
+    return (uint32_t)days * 86400u + (uint32_t)(hour * 3600 + minute * 60 + second);
+}
@@ -0,0 +1,75 @@
+#ifndef COMP_PROTOCOLO_H
+#define COMP_PROTOCOLO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "COMP_COMPRESION.h"
+#include "COMP_TRAMA.h"
+
+// Longest text line kept; longer lines are truncated
+#ifndef PROTOCOL_MAX_LINE
+#define PROTOCOL_MAX_LINE 256
+#endif
+
+// Largest binary frame payload accepted (one history block of main.ino)
+#ifndef PROTOCOL_MAX_FRAME
+#define PROTOCOL_MAX_FRAME 4096
+#endif
+
+// Receives every record decoded from a device stream
+typedef void (*ReportCallback)(void *context, const VitalsRecord &record, uint8_t channel);
+
+/**
+ *  Incremental parser for the output of one device.
+ *  Text reports are the blocks printed by reportChannel() in main.ino,
+ *  closed by a line of dashes; everything else (start-up messages, bus
+ *  statistics) is ignored. Data can arrive split at any byte.
+ */
+class ReportParser {
+public:
+    ReportParser();
+    void reset();
+
+    /**
+     *  Consume bytes from the stream.
+     *  @param done     Called for every complete record
+     *  @param context  Passed back to done
+     */
+    void feed(const uint8_t *data, size_t length, ReportCallback done, void *context);
+
+    // Frames with an unknown type or a malformed payload
+    uint32_t getErrorCount() const;
+
+private:
+    enum State : uint8_t { TEXT, FRAME_TYPE, FRAME_LEN_LO, FRAME_LEN_HI, FRAME_PAYLOAD };
+
+    State    state;
+    bool     lineStart;
+
+    char     line[PROTOCOL_MAX_LINE];
+    uint16_t lineLen;
+
+    uint8_t  frameType;
+    uint16_t frameLen;
+    uint16_t framePos;
+    std::vector<uint8_t> frame;   // allocated on the first frame
+
+    // Report being assembled
+    VitalsRecord pending;
+    uint8_t  pendingChannel;
+    bool     pendingAny;
+
+    uint32_t errors;
+
+    void parseLine(ReportCallback done, void *context);
+    void parseFrame(ReportCallback done, void *context);
+    void clearPending();
+};
+
+/**
+ *  Seconds since 1970-01-01 for a civil date and time (no time zone).
+ */
+uint32_t civilToEpoch(int year, int month, int day, int hour, int minute, int second);
+
+#endif // COMP_PROTOCOLO_H
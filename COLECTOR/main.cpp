@@ -0,0 +1,118 @@
+// Colector: recibe los reportes de muchos monitores (puertos serie y
+// socket local), reevalúa las alertas y muestra estadísticas de ingesta.
+// Con -a guarda además cada registro en el almacén columnar
+// (COMP_ALMACEN), que se consulta con CONSULTA.
+//
+// Compilación (Linux):
+//   g++ -std=c++17 -O2 -pthread -ILIB_COLECTOR -I../SISTEMA/LIB_SISTEMA
+//       main.cpp LIB_COLECTOR/*.cpp ../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp -o colector
+//
+// Uso:
+//   ./colector [-s /tmp/colector.sock] [-d /dev/ttyUSB0 ...] [-r lectores]
+//              [-w trabajadores] [-i segundos] [-p] [-a almacen]
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+#include "COMP_GATEWAY.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+  stopRequested = 1;
+}
+
+int main(int argc, char **argv) {
+  const char *socketPath = "/tmp/colector.sock";
+  const char *storePath = nullptr;
+  int readers = 1, workers = 2, interval = 5;
+  bool pin = false;
+  std::vector<const char *> serialPorts;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "s:d:r:w:i:pa:")) != -1) {
+    switch (opt) {
+      case 's': socketPath = optarg; break;
+      case 'd': serialPorts.push_back(optarg); break;
+      case 'r': readers = atoi(optarg); break;
+      case 'w': workers = atoi(optarg); break;
+      case 'i': interval = atoi(optarg); break;
+      case 'p': pin = true; break;
+      case 'a': storePath = optarg; break;
+      default:
+        fprintf(stderr, "Uso: %s [-s socket] [-d puerto]... [-r lectores] [-w trabajadores] [-i s] [-p] [-a almacen]\n", argv[0]);
+        return 1;
+    }
+  }
+  if (readers < 1) readers = 1;
+  if (workers < 1) workers = 1;
+  if (interval < 1) interval = 1;
+
+  Gateway gateway(readers, workers, pin);
+  if (storePath != nullptr && !gateway.setStore(storePath)) {
+    fprintf(stderr, "Error: %s (%s)\n", gateway.getErrorMessage(), storePath);
+    return 1;
+  }
+  if (!gateway.listenUnix(socketPath)) {
+    fprintf(stderr, "Error: %s (%s)\n", gateway.getErrorMessage(), socketPath);
+    return 1;
+  }
+  for (const char *port : serialPorts) {
+    if (!gateway.addSerial(port)) fprintf(stderr, "Error: %s (%s)\n", gateway.getErrorMessage(), port);
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  gateway.start();
+  printf("Colector escuchando en %s (%d lectores, %d trabajadores)\n", socketPath, readers, workers);
+
+  // Estadísticas por intervalo
+  GatewayStats stats, previous;
+  memset(&previous, 0, sizeof(previous));
+  auto last = std::chrono::steady_clock::now();
+  while (!stopRequested) {
+    for (int i = 0; i < interval * 10 && !stopRequested; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last).count();
+    last = now;
+
+    gateway.getStats(stats, true);
+    double rate = (stats.processed - previous.processed) / seconds;
+    printf("Dispositivos %u (%u conectados) | %.0f reg/s (%.0f por trabajador) | "
+           "latencia p50 %u us, p99 %u us, max %u us | pausas %llu, alertas %llu, errores %llu\n",
+           stats.devices, stats.connected, rate, rate / workers,
+           stats.latency.percentileUs(0.50f), stats.latency.percentileUs(0.99f), stats.latency.maxUs,
+           (unsigned long long)(stats.throttled - previous.throttled),
+           (unsigned long long)(stats.alerts - previous.alerts),
+           (unsigned long long)stats.parseErrors);
+    fflush(stdout);
+    previous = stats;
+  }
+
+  gateway.stop();
+
+  // Resumen de los dispositivos con alertas
+  uint32_t withAlerts = 0;
+  for (uint32_t i = 0; i < gateway.getDeviceCount(); i++) {
+    const DeviceAggregate *a = gateway.getAggregate(i);
+    if (a == nullptr || (a->temperatureAlerts == 0 && a->heartRateAlerts == 0)) continue;
+    if (withAlerts++ < 20) {
+      printf("Dispositivo %u: %u registros, alertas temp %u, FC %u, BPM %.1f [%.1f, %.1f], temp max %.2f °C\n",
+             i, a->records, a->temperatureAlerts, a->heartRateAlerts,
+             aggregateMeanBPM(*a), a->bpmMin, a->bpmMax, a->temperatureMax);
+    }
+  }
+  printf("%u de %u dispositivos con alertas\n", withAlerts, gateway.getDeviceCount());
+  if (storePath != nullptr) {
+    gateway.getStats(stats, false);
+    printf("Almacén %s: %llu registros guardados, %llu omitidos\n", storePath,
+           (unsigned long long)stats.stored, (unsigned long long)stats.storeSkipped);
+  }
+  return 0;
+}
@@ -0,0 +1,331 @@
+// Prueba y medida del almacén columnar (COLECTOR/LIB_COLECTOR/COMP_ALMACEN):
+//  - Escribe meses de registros sintéticos (uno cada 5 s, con huecos de
+//    horas sin monitor) y mide filas/s y bytes por fila.
+//  - Consultas de rango al azar, de una hora a dos meses: findRows() y
+//    rollup() contra un recorrido completo de las columnas, y su tiempo.
+//  - Reapertura tras un corte: columnas desiguales recortadas y escritura
+//    que continúa.
+//  - Gateway con almacén (colector -a): lo recibido por el socket queda
+//    en <almacen>/dispositivo-N y los bloques de historial repetidos se
+//    omiten.
+//
+// Compilación (Linux):
+//   g++ -std=c++17 -O2 -pthread -I../../COLECTOR/LIB_COLECTOR -I../../SISTEMA/LIB_SISTEMA
+//       main.cpp ../../COLECTOR/LIB_COLECTOR/*.cpp ../../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp
+//       -o almacen
+//
+// Uso:
+//   ./almacen [meses] [consultas]
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <string>
+#include "COMP_ALMACEN.h"
+#include "COMP_GATEWAY.h"
+#include "COMP_PROTOCOLO.h"
+
+namespace fs = std::filesystem;
+typedef std::chrono::steady_clock Clock;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+static double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static const uint32_t EPOCH_BASE = 1735689600;   // 01/01/2025
+static const uint32_t PERIOD_S = 5;
+
+// Un registro cada 5 s; de vez en cuando el monitor se quita unas horas
+struct Synthetic {
+  std::mt19937 rng;
+  uint32_t timestamp;
+  float temperature, bpm;
+
+  explicit Synthetic(uint32_t seed) : rng(seed), timestamp(EPOCH_BASE), temperature(36.6f), bpm(72.0f) {}
+
+  VitalsRecord next() {
+    std::uniform_real_distribution<float> step(-1.0f, 1.0f);
+    timestamp += PERIOD_S;
+    if (rng() % 20000 == 0) timestamp += 3600 * (1 + rng() % 8);
+    temperature = std::min(39.5f, std::max(35.5f, temperature + 0.01f * step(rng)));
+    bpm = std::min(150.0f, std::max(45.0f, bpm + 0.5f * step(rng)));
+    VitalsRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.timestamp = timestamp;
+    rec.temperature = temperature;
+    rec.humidity = 45.0f + 5.0f * step(rng);
+    rec.bpm = bpm;
+    rec.spo2 = (uint8_t)(96 + rng() % 4);
+    rec.latitude = 40.4168;
+    rec.longitude = -3.7038;
+    rec.flags = REC_HAS_TEMPERATURE | REC_HAS_HUMIDITY | REC_HAS_BPM | REC_HAS_SPO2 | REC_HAS_LOCATION;
+    // Sin sensor de pulso en uno de cada 50 registros
+    if (rng() % 50 == 0) rec.flags &= ~(REC_HAS_BPM | REC_HAS_SPO2);
+    return rec;
+  }
+};
+
+static uint64_t directoryBytes(const fs::path &dir) {
+  uint64_t total = 0;
+  for (const auto &entry : fs::directory_iterator(dir)) total += entry.file_size();
+  return total;
+}
+
+// Recorrido completo de referencia
+static Rollup scan(const ColumnStoreReader &reader, StoreField field, uint32_t from, uint32_t to) {
+  Rollup r;
+  r.clear();
+  const uint32_t *ts = reader.timestamps();
+  for (uint64_t row = 0; row < reader.getRowCount(); row++) {
+    if (ts[row] < from || ts[row] > to) continue;
+    if (field == FIELD_SPO2) {
+      if (reader.spo2()[row]) r.add(reader.spo2()[row]);
+    } else {
+      r.add(reader.floats(field)[row]);
+    }
+  }
+  return r;
+}
+
+static bool sameRollup(const Rollup &a, const Rollup &b) {
+  if (a.count != b.count) return false;
+  if (a.count == 0) return true;
+  return a.min == b.min && a.max == b.max && fabs(a.sum - b.sum) <= 1e-9 * fabs(b.sum) + 1e-6;
+}
+
+static void testQueries(const fs::path &root, uint32_t months, uint32_t queries) {
+  fs::path dir = root / "sintetico";
+  uint64_t rows = (uint64_t)months * 30 * 86400 / PERIOD_S;
+  printf("Escritura: %u meses, %llu filas\n", months, (unsigned long long)rows);
+
+  Synthetic gen(1);
+  ColumnStoreWriter writer;
+  check(writer.open(dir.c_str()), "abrir el directorio del dispositivo");
+  auto start = Clock::now();
+  bool appended = true;
+  for (uint64_t i = 0; i < rows; i++) appended &= writer.append(gen.next());
+  appended &= writer.flush();
+  double s = secondsSince(start);
+  writer.close();
+  uint64_t bytes = directoryBytes(dir);
+  printf("  %.2f M filas/s, %.1f MB, %.1f bytes/fila\n", rows / s / 1e6, bytes / 1e6, (double)bytes / rows);
+  check(appended, "todas las filas escritas");
+  VitalsRecord older = gen.next();
+  older.timestamp = EPOCH_BASE;
+  writer.open(dir.c_str());
+  check(!writer.append(older) && writer.getRowCount() == rows, "una fila fuera de orden se rechaza");
+  writer.close();
+
+  ColumnStoreReader reader;
+  check(reader.open(dir.c_str()) && reader.getRowCount() == rows, "lectura de todas las filas");
+  check(reader.getBlockCount() == rows / STORE_BLOCK_ROWS, "un resumen por bloque completo");
+
+  printf("Consultas: %u rangos al azar\n", queries);
+  const uint32_t *ts = reader.timestamps();
+  uint32_t firstTs = ts[0], lastTs = ts[rows - 1];
+  std::mt19937 rng(2);
+  std::uniform_int_distribution<uint32_t> length(3600, 60 * 86400);
+  const StoreField fields[] = {FIELD_TEMPERATURE, FIELD_HUMIDITY, FIELD_BPM, FIELD_SPO2};
+  bool rowsOk = true, rollupsOk = true;
+  double findUs = 0, rollupUs = 0, scanUs = 0;
+  uint64_t skipped = 0, blocksTouched = 0;
+  for (uint32_t q = 0; q < queries; q++) {
+    uint32_t len = length(rng);
+    uint32_t from = firstTs + rng() % (lastTs - firstTs);
+    uint32_t to = from + len;
+    StoreField field = fields[q % 4];
+
+    auto t0 = Clock::now();
+    uint64_t first, last;
+    reader.findRows(from, to, first, last);
+    findUs += secondsSince(t0) * 1e6;
+    uint64_t refFirst = std::lower_bound(ts, ts + rows, from) - ts;
+    uint64_t refLast = std::upper_bound(ts, ts + rows, to) - ts;
+    rowsOk &= first == refFirst && last == refLast;
+
+    t0 = Clock::now();
+    uint32_t fromIndex = 0;
+    Rollup got = reader.rollup(field, from, to, &fromIndex);
+    rollupUs += secondsSince(t0) * 1e6;
+    t0 = Clock::now();
+    Rollup ref = scan(reader, field, from, to);
+    scanUs += secondsSince(t0) * 1e6;
+    rollupsOk &= sameRollup(got, ref);
+    skipped += fromIndex;
+    blocksTouched += (last - first + STORE_BLOCK_ROWS - 1) / STORE_BLOCK_ROWS;
+  }
+  printf("  findRows %.1f us, rollup %.1f us, recorrido completo %.0f us (media por consulta)\n",
+         findUs / queries, rollupUs / queries, scanUs / queries);
+  printf("  %.1f%% de los bloques del rango respondidos desde el índice\n",
+         blocksTouched ? 100.0 * skipped / blocksTouched : 0.0);
+  check(rowsOk, "findRows() igual a la búsqueda binaria en la columna");
+  check(rollupsOk, "rollup() igual al recorrido completo");
+}
+
+static void testRecovery(const fs::path &root) {
+  printf("Reapertura tras un corte\n");
+  fs::path dir = root / "corte";
+  Synthetic gen(3);
+  const uint64_t ROWS = STORE_BLOCK_ROWS * 3 + 100;
+  ColumnStoreWriter writer;
+  writer.open(dir.c_str());
+  for (uint64_t i = 0; i < ROWS; i++) writer.append(gen.next());
+  writer.close();
+
+  // Corte a mitad de una fila: la columna de BPM se queda corta
+  fs::resize_file(dir / "bpm.f32", (ROWS - 10) * 4 + 2);
+  check(writer.open(dir.c_str()) && writer.getRowCount() == ROWS - 10,
+        "columnas recortadas a la más corta");
+  for (int i = 0; i < STORE_BLOCK_ROWS; i++) writer.append(gen.next());
+  writer.close();
+
+  ColumnStoreReader reader;
+  bool ok = reader.open(dir.c_str()) && reader.getRowCount() == ROWS - 10 + STORE_BLOCK_ROWS;
+  const uint32_t *ts = reader.timestamps();
+  ok &= ts != nullptr && std::is_sorted(ts, ts + reader.getRowCount());
+  check(ok, "la escritura continúa en orden");
+  ok = reader.getBlockCount() == reader.getRowCount() / STORE_BLOCK_ROWS;
+  for (uint32_t b = 0; ok && b < reader.getBlockCount(); b++) {
+    uint32_t from = ts[b * STORE_BLOCK_ROWS];
+    uint32_t to = ts[(b + 1) * STORE_BLOCK_ROWS - 1];
+    uint32_t fromIndex = 0;
+    ok &= sameRollup(reader.rollup(FIELD_BPM, from, to, &fromIndex), scan(reader, FIELD_BPM, from, to));
+  }
+  check(ok, "índice reconstruido y coherente con las columnas");
+}
+
+static int connectUnix(const char *path) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) return fd;
+  if (fd >= 0) close(fd);
+  return -1;
+}
+
+static bool sendAll(int fd, const void *data, size_t len) {
+  const char *p = (const char *)data;
+  while (len > 0) {
+    ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    p += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+static void sendReport(int fd, const VitalsRecord &rec, int channel) {
+  time_t t = rec.timestamp;
+  struct tm tm;
+  gmtime_r(&t, &tm);
+  char when[20], text[256];
+  strftime(when, sizeof(when), "%d/%m/%Y %H:%M:%S", &tm);
+  int n = 0;
+  if (channel >= 0) n += snprintf(text + n, sizeof(text) - n, "Canal %d\n", channel);
+  n += snprintf(text + n, sizeof(text) - n,
+                "Estado estable.\nTemp: %.2f °C, BPM: %.1f, SpO2: %u%%\nTimestamp: %s\n"
+                "Ubicación: Lat %.6f, Lon %.6f\n-------------------------------\n",
+                rec.temperature, rec.bpm, rec.spo2, when, rec.latitude, rec.longitude);
+  sendAll(fd, text, (size_t)n);
+}
+
+static void testGatewayStore(const fs::path &root) {
+  printf("Gateway con almacén\n");
+  const uint32_t DEVICES = 4, REPORTS = 300, HISTORY = 200;
+  fs::path store = root / "colector";
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/prueba_almacen_%d.sock", (int)getpid());
+
+  Gateway gateway(1, 2);
+  check(gateway.setStore(store.c_str()) && gateway.listenUnix(path) && gateway.start(),
+        "colector con almacén en marcha");
+  for (uint32_t d = 0; d < DEVICES; d++) {
+    // Conexiones en orden para que la N-ésima sea dispositivo-N
+    int fd = connectUnix(path);
+    while (gateway.getDeviceCount() < d + 1) usleep(1000);
+    Synthetic gen(10 + d);
+    std::vector<VitalsRecord> sentRecords;
+    for (uint32_t i = 0; i < REPORTS; i++) {
+      VitalsRecord rec = gen.next();
+      sentRecords.push_back(rec);
+      sendReport(fd, rec, -1);
+      if (d == 0) sendReport(fd, rec, 1);    // segundo sitio del primer monitor
+    }
+    // Bloque de historial con reportes que ya llegaron como texto
+    std::vector<uint8_t> frame(FRAME_HEADER_SIZE + PROTOCOL_MAX_FRAME);
+    TimeSeriesEncoder encoder;
+    encoder.begin(frame.data() + FRAME_HEADER_SIZE, PROTOCOL_MAX_FRAME);
+    for (uint32_t i = 0; i < HISTORY; i++) encoder.append(sentRecords[i]);
+    size_t len = writeFrameHeader(frame.data(), FRAME_HISTORY, (uint16_t)encoder.size()) + encoder.size();
+    sendAll(fd, frame.data(), len);
+    close(fd);
+  }
+  GatewayStats stats;
+  uint64_t expected = DEVICES * (REPORTS + HISTORY) + REPORTS;
+  for (int wait = 0; wait < 500; wait++) {
+    gateway.getStats(stats, false);
+    if (stats.processed >= expected && stats.connected == 0) break;
+    usleep(10000);
+  }
+  gateway.stop();
+  gateway.getStats(stats, false);
+  printf("  %llu registros guardados, %llu omitidos\n",
+         (unsigned long long)stats.stored, (unsigned long long)stats.storeSkipped);
+  check(stats.stored == DEVICES * REPORTS + REPORTS && stats.storeSkipped == DEVICES * HISTORY,
+        "reportes guardados, historial repetido omitido");
+
+  bool ok = true;
+  for (uint32_t d = 0; d < DEVICES; d++) {
+    ColumnStoreReader reader;
+    std::string dir = (store / ("dispositivo-" + std::to_string(d))).string();
+    ok &= reader.open(dir.c_str()) && reader.getRowCount() == REPORTS;
+    Synthetic gen(10 + d);
+    for (uint32_t i = 0; ok && i < REPORTS; i++) {
+      VitalsRecord rec = gen.next();
+      ok &= reader.timestamps()[i] == rec.timestamp &&
+            fabsf(reader.floats(FIELD_BPM)[i] - rec.bpm) < 0.06f;
+    }
+  }
+  ColumnStoreReader second;
+  ok &= second.open((store / "dispositivo-0-c1").c_str()) && second.getRowCount() == REPORTS;
+  check(ok, "cada dispositivo y canal en su directorio");
+}
+
+int main(int argc, char **argv) {
+  uint32_t months = argc > 1 ? (uint32_t)atoi(argv[1]) : 6;
+  uint32_t queries = argc > 2 ? (uint32_t)atoi(argv[2]) : 400;
+  if (months < 1) months = 1;
+  if (queries < 1) queries = 1;
+
+  char tmpl[] = "/tmp/prueba_almacen_XXXXXX";
+  if (mkdtemp(tmpl) == nullptr) {
+    fprintf(stderr, "No se pudo crear el directorio temporal\n");
+    return 1;
+  }
+  fs::path root(tmpl);
+  testQueries(root, months, queries);
+  testRecovery(root);
+  testGatewayStore(root);
+  fs::remove_all(root);
+
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
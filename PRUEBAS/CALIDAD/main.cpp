@@ -0,0 +1,194 @@
+// Prueba del índice de calidad de señal (COMP_CALIDAD). Primero
+// SignalQuality solo: la curtosis de cada ventana se compara con un cálculo
+// a dos pasadas en doble precisión para señales de forma conocida (seno,
+// pulso, ruido gaussiano, picos), también con la componente AC desplazada
+// como queda mientras se asienta la eliminación de continua; después la
+// puntuación de ventanas limpias (también desplazadas), planas, recortadas
+// y con artefactos. Por último un canal completo sobre el bus emulado
+// (COMP_BUS_MOCK) con un tramo de movimiento entre dos tramos limpios.
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -DPLATFORM_SIMULATED_TIME -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o calidad
+//
+// Uso:
+//   ./calidad
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <random>
+#include <vector>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+
+typedef SensorChannelsT<MockBus> Channels;
+
+static const uint8_t MAX30102_ADDR = 0x57;
+static const uint8_t SHT31_ADDR = 0x44;
+static const float RATE_HZ = 100.0f;   // PROFILE_STANDARD
+static const float BPM = 72.0f;
+static const float DC = 100000.0f;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+enum Shape { SINE, PULSE, NOISE, SPIKES };
+
+static const char *shapeName(Shape s) {
+  switch (s) {
+    case SINE:  return "seno";
+    case PULSE: return "pulso";
+    case NOISE: return "ruido";
+    default:    return "picos";
+  }
+}
+
+// Una ventana de SQI_WINDOW_MS de componente AC
+static std::vector<float> window(Shape s, float offset, std::mt19937 &rng) {
+  std::normal_distribution<float> noise(0.0f, 1.0f);
+  size_t n = (size_t)(RATE_HZ * SQI_WINDOW_MS / 1000);
+  std::vector<float> v(n);
+  for (size_t i = 0; i < n; i++) {
+    float phase = 2.0f * (float)M_PI * BPM / 60.0f * i / RATE_HZ;
+    float x;
+    switch (s) {
+      case SINE:  x = 1500.0f * sinf(phase); break;
+      case PULSE: x = 1500.0f * sinf(phase) + 500.0f * sinf(2.0f * phase + 1.0f); break;
+      case NOISE: x = 1500.0f * noise(rng); break;
+      default:    x = 50.0f * noise(rng) + ((i % 37 == 5) ? 20000.0f : 0.0f); break;
+    }
+    v[i] = x + offset;
+  }
+  return v;
+}
+
+static double kurtosis(const std::vector<float> &v) {
+  double mean = 0.0, m2 = 0.0, m4 = 0.0;
+  for (size_t i = 0; i < v.size(); i++) mean += v[i];
+  mean /= v.size();
+  for (size_t i = 0; i < v.size(); i++) {
+    double d = v[i] - mean;
+    m2 += d * d;
+    m4 += d * d * d * d;
+  }
+  m2 /= v.size();
+  m4 /= v.size();
+  return m2 > 0.0 ? m4 / (m2 * m2) : 0.0;
+}
+
+static uint8_t score(SignalQuality &q, const std::vector<float> &v, uint32_t raw) {
+  for (size_t i = 0; i < v.size(); i++) q.add(v[i], raw, DC);
+  return q.evaluate(SQI_WINDOW_MS);
+}
+
+static void testKurtosis() {
+  printf("Curtosis frente a dos pasadas\n");
+  std::mt19937 rng(11);
+  static const Shape shapes[] = {SINE, PULSE, NOISE, SPIKES};
+  static const float offsets[] = {0.0f, 1000.0f, 20000.0f, 100000.0f};
+  double worst = 0.0;
+  bool ok = true;
+  for (size_t s = 0; s < 4; s++) {
+    for (size_t o = 0; o < 4; o++) {
+      std::vector<float> v = window(shapes[s], offsets[o], rng);
+      SignalQuality q;
+      score(q, v, (uint32_t)DC);
+      double ref = kurtosis(v);
+      double err = fabs(q.getKurtosis() - ref) / ref;
+      printf("  %-6s desplazada %6.0f: %7.3f (referencia %7.3f)\n",
+             shapeName(shapes[s]), offsets[o], q.getKurtosis(), ref);
+      worst = fmax(worst, err);
+      ok &= err <= 0.01;
+    }
+  }
+  printf("  error relativo máximo %.2e\n", worst);
+  check(ok, "curtosis con un error relativo <= 1 %");
+}
+
+static void testScore() {
+  printf("Puntuación de ventanas\n");
+  std::mt19937 rng(5);
+  SignalQuality q;
+  uint8_t clean = score(q, window(PULSE, 0.0f, rng), (uint32_t)DC);
+  printf("  limpia %u\n", clean);
+  check(clean >= SignalQuality::MIN_SCORE, "ventana limpia aceptada");
+  uint8_t shifted = score(q, window(PULSE, 20000.0f, rng), (uint32_t)DC);
+  printf("  limpia desplazada %u\n", shifted);
+  // Ni la curtosis ni los cruces (de la media, no del cero) dependen del
+  // desplazamiento que deja la eliminación de continua al asentarse
+  check(q.getKurtosis() < SignalQuality::KURTOSIS_MAX, "el desplazamiento no cambia la curtosis");
+  check(shifted >= SignalQuality::MIN_SCORE, "ventana limpia desplazada aceptada");
+  check(score(q, std::vector<float>(100, 0.0f), (uint32_t)DC) == 0, "ventana plana: 0");
+  check(score(q, window(PULSE, 0.0f, rng), SignalQuality::SATURATION) == 0, "ventana recortada: 0");
+  uint8_t spikes = score(q, window(SPIKES, 0.0f, rng), (uint32_t)DC);
+  printf("  picos %u (curtosis %.1f)\n", spikes, q.getKurtosis());
+  check(spikes < SignalQuality::MIN_SCORE, "ventana con picos rechazada");
+  check(q.getWindowCount() == 5 && q.getRejectedCount() == 3, "contadores de ventanas y rechazos");
+}
+
+static void testChannel() {
+  printf("Canal con movimiento entre 10 y 20 s\n");
+  MockI2CBus bus;
+  MockMAX30102 chip;
+  MockSHT31 climateChip;
+  bus.addDevice(MAX30102_ADDR, &chip);
+  bus.addDevice(SHT31_ADDR, &climateChip);
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  SHT31T<MockBus> climate{MockBus(bus)};
+  Channels channels;
+  channels.addChannel(&pulse, &climate);
+  channels.beginAll();
+
+  std::mt19937 rng(3);
+  std::normal_distribution<double> noise(0.0, 1.0);
+  double drift = 0.0;
+  uint32_t windows[3] = {0}, rejected[3] = {0};
+  for (uint32_t n = 0; n < 3000; n++) {
+    uint32_t part = n / 1000;
+    double phase = 2.0 * M_PI * BPM / 60.0 * n / RATE_HZ;
+    double ppg = 2000.0 * (sin(phase) + 0.3 * sin(2.0 * phase + 1.0));
+    if (part == 1) {
+      drift = 0.98 * (drift + 800.0 * noise(rng));
+      ppg += drift + 3000.0 * sin(2.0 * M_PI * 5.3 * n / RATE_HZ);
+      if (rng() % 40 == 0) ppg += 30000.0 * noise(rng);
+    }
+    double ir = fmax(DC + ppg + 50.0 * noise(rng), 0.0);
+    chip.pushSample((uint32_t)(0.8 * ir), (uint32_t)ir);
+    const SignalQuality &q = channels.getQuality(0);
+    uint32_t w = q.getWindowCount(), r = q.getRejectedCount();
+    channels.poll(5000);
+    delay(10);
+    windows[part] += q.getWindowCount() - w;
+    rejected[part] += q.getRejectedCount() - r;
+    if (n == 999) channels.resetWindows(0);
+  }
+  // La primera ventana del primer tramo aún arrastra la continua inicial, y
+  // la primera que cierra en el último tramo empezó durante el movimiento
+  printf("  limpio: %u/%u rechazadas, movimiento: %u/%u, limpio: %u/%u\n",
+         rejected[0], windows[0], rejected[1], windows[1], rejected[2], windows[2]);
+  const WindowStats &bpm = channels.getWindow(0, VITAL_BPM);
+  printf("  %.1f lpm, ventana de BPM del movimiento en adelante: %u, %.1f..%.1f, p50 %.1f\n",
+         channels.getBPM(0), bpm.getCount(), bpm.getMin(), bpm.getMax(), bpm.getP50());
+  check(rejected[0] <= 2 && rejected[2] <= 1, "tramos limpios aceptados");
+  check(rejected[1] * 2 >= windows[1], "la mayoría del movimiento rechazado");
+  check(fabsf(channels.getBPM(0) - BPM) < 0.05f * BPM, "pulso bien medido al final");
+  // Alguna ventana de movimiento puede colarse; la mediana no debe moverse
+  check(bpm.getCount() > 0 && fabsf(bpm.getP50() - BPM) < 0.1f * BPM,
+        "mediana de la ventana de BPM en el ritmo real");
+}
+
+int main() {
+  testKurtosis();
+  testScore();
+  testChannel();
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,278 @@
+// Prueba del ciclo de trabajo sobre el bus emulado (COMP_BUS_MOCK), con la
+// configuración de main.ino (detección de presencia y control de ganancia):
+// un arranque en frío, varios ciclos de ACQUISITION_WINDOW_MS despierto y
+// el resto del periodo dormido con suspendAll()/resumeAll(), y un arranque
+// en frío de referencia. Cada despertar construye objetos nuevos (la RAM se
+// pierde) y reinicia millis(); solo sobrevive el RetainedChannel, como en
+// la memoria RTC. Comprueba que el chip duerme con su configuración, que
+// el despertar en caliente cuesta menos bus y da el primer pulso antes que
+// en frío, que la ganancia no vuelve a ajustarse, que un cambio de ritmo
+// durante el sueño se mide bien y que un chip que pierde la alimentación
+// mientras duerme recibe la configuración completa. Cada despertar añade
+// además su registro al bloque de historial, que sigue en la memoria RTC
+// de un despertar al siguiente hasta llenarse y enviarse como FRAME_HISTORY.
+// El corazón sigue latiendo mientras la unidad duerme; el chip emulado
+// solo convierte fuera de shutdown, al ritmo de su FIFO, y la luz que
+// devuelve el dedo es proporcional a la corriente del LED.
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -DPLATFORM_SIMULATED_TIME -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp
+//       ../../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp -o ciclo
+//
+// Uso:
+//   ./ciclo
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+#include "COMP_COMPRESION.h"
+#include "COMP_TRAMA.h"
+
+typedef SensorChannelsT<MockBus> Channels;
+
+static const uint8_t MAX30102_ADDR = 0x57;
+static const uint8_t SHT31_ADDR = 0x44;
+// Los de main.ino
+static const uint32_t ACQUISITION_WINDOW_MS = 8000;
+static const uint32_t READING_INTERVAL_MS = 60000;
+// Cuentas de IR por código de amplitud con ADC_RGE = 2: la amplitud de
+// setup() satura el IR y el ajuste tiene que bajarla
+static const double TISSUE = 20000.0;
+static const size_t HISTORY_BUFFER_SIZE = 4096;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Dedo sobre el sensor durante todo el ensayo
+struct Site {
+  MockMAX30102 chip;
+  double bpm = 72.0;
+  double phase = 0.0;        // ciclos cardiacos desde el inicio
+  uint32_t nextMs = 0;
+
+  // SMP_AVE = 32 (FIFO_CONFIG[7:5] = 5) es el perfil de presencia
+  uint32_t periodMs() const {
+    return ((chip.getRegister(REG_FIFO_CONFIG) >> 5) == 5) ? 640 : 10;
+  }
+
+  // MODE_CONFIG en modo SpO2, dentro o fuera de shutdown
+  bool configured() const { return (chip.getRegister(REG_MODE_CONFIG) & 0x07) != 0; }
+  bool asleep() const { return (chip.getRegister(REG_MODE_CONFIG) & 0x80) != 0; }
+
+  void advance(uint32_t ms) { phase += bpm / 60.0 * ms / 1000.0; }
+
+  void tick(uint32_t now) {
+    if ((int32_t)(now - nextMs) < 0) return;
+    nextMs = now + periodMs();
+    if (!configured() || asleep()) return;
+    double rf = pow(2.0, 2 - ((chip.getRegister(REG_SPO2_CONFIG) >> 5) & 0x03));
+    double beat = 1.0 + 0.01 * (sin(2.0 * M_PI * phase) + 0.3 * sin(4.0 * M_PI * phase + 1.0));
+    double ir = fmin(TISSUE * chip.getRegister(REG_LED2_PA) * rf * beat, LedGainControl::FULL_SCALE);
+    double red = fmin(0.7 * TISSUE * chip.getRegister(REG_LED1_PA) * rf * beat, LedGainControl::FULL_SCALE);
+    chip.pushSample((uint32_t)red, (uint32_t)ir);
+  }
+};
+
+struct Rig {
+  MockI2CBus bus;
+  Site site;
+  MockSHT31 climateChip;
+  // Memoria RTC del historial: búfer y estado del codificador
+  uint8_t history[HISTORY_BUFFER_SIZE];
+  TimeSeriesEncoder::Retained historyState;
+  bool historyKept = false;
+  uint32_t wakes = 0;
+  std::vector<VitalsRecord> appended;        // registros aún no enviados
+  std::vector<std::vector<uint8_t> > frames; // tramas enviadas
+
+  Rig() {
+    bus.addDevice(MAX30102_ADDR, &site.chip);
+    bus.addDevice(SHT31_ADDR, &climateChip);
+  }
+};
+
+// Reporte de un despertar, como appendHistory()/sendHistory() de main.ino:
+// el codificador es un objeto nuevo que continúa el bloque guardado
+static void report(Rig &rig, float bpm, uint8_t spo2) {
+  TimeSeriesEncoder encoder;
+  if (rig.historyKept) encoder.restore(rig.history, HISTORY_BUFFER_SIZE, rig.historyState);
+  else encoder.begin(rig.history, HISTORY_BUFFER_SIZE);
+  VitalsRecord rec = {};
+  rec.timestamp = rig.wakes++ * (READING_INTERVAL_MS / 1000);
+  rec.temperature = 36.5f + 0.01f * (rig.wakes % 7);
+  rec.humidity = 50.0f;
+  rec.bpm = bpm;
+  rec.spo2 = spo2;
+  rec.flags = REC_HAS_TEMPERATURE | REC_HAS_HUMIDITY | (bpm > 0.0f ? REC_HAS_BPM : 0) |
+              (spo2 > 0 ? REC_HAS_SPO2 : 0);
+  if (!encoder.append(rec)) {
+    std::vector<uint8_t> frame(FRAME_HEADER_SIZE);
+    writeFrameHeader(frame.data(), FRAME_HISTORY, (uint16_t)encoder.size());
+    frame.insert(frame.end(), rig.history, rig.history + encoder.size());
+    rig.frames.push_back(frame);
+    encoder.begin(rig.history, HISTORY_BUFFER_SIZE);
+    encoder.append(rec);
+  }
+  rig.appended.push_back(rec);
+  encoder.save(rig.historyState);
+  rig.historyKept = true;
+}
+
+// Lo que se mide en un despertar
+struct Wake {
+  uint32_t bringUpTx;        // transacciones de beginAll()/resumeAll()
+  uint32_t firstVitalMs;     // UINT32_MAX si no llega
+  uint32_t gainSteps;
+  uint32_t windowTx;
+  float bpm;
+  uint8_t spo2;
+};
+
+// Un despertar: objetos nuevos, millis() desde 0, ventana de adquisición y,
+// si out no es nulo, suspendAll() al final
+static Wake awake(Rig &rig, const Channels::RetainedChannel *in, Channels::RetainedChannel *out) {
+  platformSimulatedUs() = 0;
+  rig.site.nextMs = 0;
+  MAX30102T<MockBus> pulse{MockBus(rig.bus)};
+  SHT31T<MockBus> climate{MockBus(rig.bus)};
+  Channels channels;
+  channels.addChannel(&pulse, &climate);
+  channels.setPresenceDetection(true);
+  channels.setGainControl(true);
+
+  Wake w;
+  uint32_t tx = rig.bus.getTransactions();
+  if (in != nullptr) channels.resumeAll(in);
+  else channels.beginAll();
+  w.bringUpTx = rig.bus.getTransactions() - tx;
+  for (uint32_t t = 0; t < ACQUISITION_WINDOW_MS; t += 10) {
+    rig.site.tick(millis());
+    channels.poll(5000);
+    rig.site.advance(10);
+    delay(10);
+  }
+  w.firstVitalMs = channels.getTimeToFirstVital(0, DEVICE_PULSE);
+  w.gainSteps = channels.getGainControl(0).getStepCount();
+  w.windowTx = rig.bus.getTransactions() - tx;
+  w.bpm = channels.getBPM(0);
+  w.spo2 = channels.getSpO2(0);
+  report(rig, w.bpm, w.spo2);
+  if (out != nullptr) channels.suspendAll(out);
+  return w;
+}
+
+static void print(const char *name, const Wake &w) {
+  printf("  %-14s %3u transacciones al arrancar, primer pulso a los %5d ms, "
+         "%u pasos de ganancia, %.1f lpm, SpO2 %u\n",
+         name, w.bringUpTx, w.firstVitalMs == UINT32_MAX ? -1 : (int)w.firstVitalMs,
+         w.gainSteps, w.bpm, w.spo2);
+}
+
+static void sleep(Rig &rig) {
+  rig.site.advance(READING_INTERVAL_MS - ACQUISITION_WINDOW_MS);
+}
+
+int main() {
+  Rig rig;
+  Channels::RetainedChannel rtc[1];
+
+  printf("Arranque en frío\n");
+  Wake cold = awake(rig, nullptr, rtc);
+  print("frío", cold);
+  check(cold.firstVitalMs != UINT32_MAX && fabsf(cold.bpm - 72.0f) < 0.05f * 72.0f,
+        "mide el pulso en la primera ventana");
+  check(cold.gainSteps > 0, "la ganancia se ajusta al tejido");
+  uint8_t irAmplitude = rig.site.chip.getRegister(REG_LED2_PA);
+  check(rig.site.asleep() && rig.site.configured(), "suspendAll() duerme el chip con su configuración");
+  check(rtc[0].presenceState == PRESENCE_ACTIVE && rtc[0].fingerPresent, "guarda el dedo presente");
+
+  printf("Ciclos en caliente\n");
+  bool measured = true, fasterThanCold = true, cheaper = true, gainKept = true;
+  uint32_t warmTx = 0, worstFirst = 0;
+  for (int cycle = 0; cycle < 4; cycle++) {
+    sleep(rig);
+    if (cycle == 2) rig.site.bpm = 90.0;   // el ritmo cambia mientras duerme
+    Wake warm = awake(rig, rtc, rtc);
+    char name[16];
+    snprintf(name, sizeof(name), "caliente %d", cycle + 1);
+    print(name, warm);
+    measured &= fabsf(warm.bpm - rig.site.bpm) < 0.05f * rig.site.bpm;
+    fasterThanCold &= warm.firstVitalMs < cold.firstVitalMs;
+    cheaper &= warm.bringUpTx < cold.bringUpTx;
+    gainKept &= warm.gainSteps == 0 && rig.site.chip.getRegister(REG_LED2_PA) == irAmplitude;
+    warmTx += warm.windowTx;
+    if (warm.firstVitalMs > worstFirst) worstFirst = warm.firstVitalMs;
+  }
+  check(measured, "mide el pulso en cada ventana, también tras el cambio");
+  check(fasterThanCold, "primer pulso antes que en frío");
+  check(cheaper, "menos transacciones para levantar el canal");
+  check(gainKept, "la ganancia guardada no se vuelve a ajustar");
+
+  printf("Pérdida de alimentación mientras duerme\n");
+  sleep(rig);
+  rig.site.chip.powerOnReset();
+  Wake lost = awake(rig, rtc, rtc);
+  print("sin RTC", lost);
+  check(rig.site.configured() && lost.bringUpTx >= cold.bringUpTx,
+        "resumeAll() hace la configuración completa");
+  check(fabsf(lost.bpm - rig.site.bpm) < 0.05f * rig.site.bpm, "y vuelve a medir el pulso");
+
+  printf("Arranque en frío de referencia\n");
+  sleep(rig);
+  Wake ref = awake(rig, nullptr, nullptr);
+  print("frío", ref);
+  check(worstFirst < ref.firstVitalMs, "el despertar en caliente sigue siendo más rápido");
+
+  printf("Historial a través del sueño\n");
+  std::vector<VitalsRecord> firstBlock = rig.appended;
+  while (rig.frames.empty() && rig.wakes < 10000) {
+    firstBlock = rig.appended;
+    report(rig, 72.0f, 97);
+  }
+  check(rig.frames.size() == 1, "el bloque se llena y se envía");
+  bool framed = false, decoded = false;
+  if (!rig.frames.empty()) {
+    const std::vector<uint8_t> &f = rig.frames[0];
+    uint16_t len = f[2] | (f[3] << 8);
+    framed = f[0] == FRAME_START && f[1] == FRAME_HISTORY && (size_t)len + FRAME_HEADER_SIZE == f.size();
+    TimeSeriesDecoder decoder(f.data() + FRAME_HEADER_SIZE, len);
+    VitalsRecord rec;
+    size_t n = 0;
+    decoded = true;
+    while (decoder.next(rec)) {
+      decoded &= n < firstBlock.size() && rec.timestamp == firstBlock[n].timestamp &&
+                 fabsf(rec.bpm - firstBlock[n].bpm) <= 0.05f && rec.spo2 == firstBlock[n].spo2;
+      n++;
+    }
+    decoded &= n == firstBlock.size();
+    printf("  %u registros de %u despertares en %u bytes\n", (unsigned)n, rig.wakes,
+           (unsigned)len);
+  }
+  check(framed, "trama FRAME_HISTORY bien formada");
+  check(decoded && firstBlock.size() > 100,
+        "contiene los registros de todos los despertares del bloque");
+  check(firstBlock.size() > 0 && firstBlock[0].bpm == cold.bpm,
+        "incluido el del primer arranque en frío");
+
+  printf("Ciclo de trabajo\n");
+  double duty = (double)ACQUISITION_WINDOW_MS / READING_INTERVAL_MS;
+  printf("  despierto %.1f %% del tiempo, %.0f transacciones por ventana en caliente\n",
+         100.0 * duty, warmTx / 4.0);
+  printf("  adquisición útil tras el primer pulso: frío %.0f %%, caliente %.0f %%\n",
+         100.0 * (ACQUISITION_WINDOW_MS - cold.firstVitalMs) / ACQUISITION_WINDOW_MS,
+         100.0 * (ACQUISITION_WINDOW_MS - worstFirst) / ACQUISITION_WINDOW_MS);
+
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,243 @@
+// Prueba del códec de historial (COMP_COMPRESION): ida y vuelta exacta a la
+// resolución de cada canal, velocidad de codificación/decodificación y
+// razón de compresión frente al texto de los reportes de main.ino.
+// Sin argumentos usa sesiones sintéticas; con capturas del monitor serie
+// (texto de main.ino) mide también las sesiones grabadas.
+//
+// Compilación (Linux):
+//   g++ -std=c++17 -O2 -I../../SISTEMA/LIB_SISTEMA -I../../COLECTOR/LIB_COLECTOR
+//       main.cpp ../../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp
+//       ../../COLECTOR/LIB_COLECTOR/COMP_PROTOCOLO.cpp -o compresion
+//
+// Uso:
+//   ./compresion [captura.txt ...]
+// Devuelve 1 si algún registro no se recupera.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "COMP_COMPRESION.h"
+#include "COMP_PROTOCOLO.h"
+
+constexpr size_t BLOCK_SIZE = 4096;        // HISTORY_BUFFER_SIZE de main.ino
+constexpr size_t SESSION_RECORDS = 10080;  // Una semana, un reporte por minuto
+constexpr size_t BENCH_RECORDS = 2000000;
+
+struct Session {
+  const char *name;
+  std::vector<VitalsRecord> records;
+  size_t textBytes;   // Bytes del texto de los reportes
+};
+
+// Texto mínimo de un reporte (el de main.ino lleva además el resumen de
+// ventana, así que la razón real es mayor)
+static size_t textSize(const VitalsRecord &rec) {
+  char buf[256];
+  int n = snprintf(buf, sizeof(buf),
+                   "Estado estable.\nTemp: %.2f °C, BPM: %.1f, SpO2: %u%%\n"
+                   "Timestamp: 01/01/2026 00:00:00\nUbicación: Lat %.6f, Lon %.6f\n"
+                   "-------------------------------\n",
+                   rec.temperature, rec.bpm, rec.spo2, rec.latitude, rec.longitude);
+  return (size_t)n;
+}
+
+// Paciente en reposo: derivas lentas, GPS fijo con ruido de 1-2 m
+static Session restingSession(std::mt19937 &rng) {
+  std::normal_distribution<float> noise(0.0f, 1.0f);
+  Session s{"reposo", {}, 0};
+  float temp = 36.6f, hum = 50.0f, bpm = 68.0f;
+  for (size_t i = 0; i < SESSION_RECORDS; i++) {
+    VitalsRecord r;
+    memset(&r, 0, sizeof(r));
+    r.timestamp = 1767225600u + (uint32_t)(i * 60);
+    temp += 0.01f * noise(rng);
+    hum += 0.1f * noise(rng);
+    bpm = 68.0f + 0.9f * (bpm - 68.0f) + 1.5f * noise(rng);
+    r.temperature = roundf(temp * 100.0f) / 100.0f;
+    r.humidity = roundf(hum * 100.0f) / 100.0f;
+    r.bpm = roundf(bpm * 10.0f) / 10.0f;
+    r.spo2 = (uint8_t)(97 + (int)lroundf(0.5f * noise(rng)));
+    r.latitude = 6.244200 + 0.000010 * noise(rng);
+    r.longitude = -75.581200 + 0.000010 * noise(rng);
+    r.flags = REC_HAS_TEMPERATURE | REC_HAS_HUMIDITY | REC_HAS_BPM | REC_HAS_SPO2 | REC_HAS_LOCATION;
+    s.records.push_back(r);
+    s.textBytes += textSize(r);
+  }
+  return s;
+}
+
+// Paciente en movimiento con huecos: sin dedo, sin GPS bajo techo, fiebre
+static Session ambulatorySession(std::mt19937 &rng) {
+  std::normal_distribution<float> noise(0.0f, 1.0f);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  Session s{"ambulatorio", {}, 0};
+  float temp = 36.8f, hum = 45.0f, bpm = 80.0f;
+  double lat = 6.2442, lon = -75.5812;
+  for (size_t i = 0; i < SESSION_RECORDS; i++) {
+    VitalsRecord r;
+    memset(&r, 0, sizeof(r));
+    // Reportes perdidos de vez en cuando (reinicios, sensor ausente)
+    r.timestamp = 1767225600u + (uint32_t)(i * 60) + (unit(rng) < 0.01f ? 120 : 0);
+    temp += 0.02f * noise(rng) + ((i / 1440) % 3 == 2 ? 0.002f : -0.001f);
+    hum += 0.3f * noise(rng);
+    bpm = 80.0f + 0.8f * (bpm - 80.0f) + 4.0f * noise(rng);
+    lat += 0.00002 * noise(rng);
+    lon += 0.00002 * noise(rng);
+    r.temperature = roundf(temp * 100.0f) / 100.0f;
+    r.humidity = roundf(hum * 100.0f) / 100.0f;
+    r.bpm = roundf(bpm * 10.0f) / 10.0f;
+    r.spo2 = (uint8_t)(96 + (int)lroundf(noise(rng)));
+    r.latitude = lat;
+    r.longitude = lon;
+    r.flags = REC_HAS_TEMPERATURE | REC_HAS_HUMIDITY;
+    if (unit(rng) > 0.2f) r.flags |= REC_HAS_BPM | REC_HAS_SPO2;
+    if (unit(rng) > 0.3f) r.flags |= REC_HAS_LOCATION;
+    s.records.push_back(r);
+    s.textBytes += textSize(r);
+  }
+  return s;
+}
+
+static void collect(void *context, const VitalsRecord &record, uint8_t) {
+  static_cast<Session *>(context)->records.push_back(record);
+}
+
+static bool loadCapture(const char *path, Session &s) {
+  FILE *f = fopen(path, "rb");
+  if (f == nullptr) return false;
+  ReportParser parser;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    parser.feed(buf, n, collect, &s);
+    s.textBytes += n;
+  }
+  fclose(f);
+  return true;
+}
+
+static bool near(double a, double b, double lsb) {
+  return fabs(a - b) <= lsb * 0.5 + 1e-9;
+}
+
+// Compara un registro decodificado con el original a la resolución del canal
+static bool sameRecord(const VitalsRecord &a, const VitalsRecord &b) {
+  if (a.timestamp != b.timestamp || a.flags != b.flags) return false;
+  if ((a.flags & REC_HAS_TEMPERATURE) && !near(a.temperature, b.temperature, 0.01)) return false;
+  if ((a.flags & REC_HAS_HUMIDITY) && !near(a.humidity, b.humidity, 0.01)) return false;
+  if ((a.flags & REC_HAS_BPM) && !near(a.bpm, b.bpm, 0.1)) return false;
+  if ((a.flags & REC_HAS_SPO2) && a.spo2 != b.spo2) return false;
+  if ((a.flags & REC_HAS_LOCATION) &&
+      (!near(a.latitude, b.latitude, 1e-6) || !near(a.longitude, b.longitude, 1e-6))) return false;
+  return true;
+}
+
+// Codifica la sesión en bloques como main.ino y la decodifica de vuelta
+static bool roundTrip(const Session &s, size_t &encodedBytes, size_t &blocks) {
+  static uint8_t block[BLOCK_SIZE];
+  TimeSeriesEncoder encoder;
+  encodedBytes = 0;
+  blocks = 0;
+  size_t first = 0, i = 0;
+  encoder.begin(block, sizeof(block));
+  while (first < s.records.size()) {
+    bool full = i < s.records.size() && !encoder.append(s.records[i]);
+    if (!full && i < s.records.size()) {
+      i++;
+      continue;
+    }
+    // Bloque cerrado: se decodifica y se compara
+    TimeSeriesDecoder decoder(block, encoder.size());
+    VitalsRecord rec;
+    for (size_t k = first; k < i; k++) {
+      if (!decoder.next(rec) || !sameRecord(rec, s.records[k])) {
+        printf("  registro %zu no coincide\n", k);
+        return false;
+      }
+    }
+    if (decoder.next(rec)) return false;
+    encodedBytes += encoder.size();
+    blocks++;
+    first = i;
+    encoder.begin(block, sizeof(block));
+  }
+  return true;
+}
+
+static void report(const Session &s, bool &ok) {
+  size_t encoded, blocks;
+  bool pass = roundTrip(s, encoded, blocks);
+  ok = ok && pass;
+  size_t raw = s.records.size() * sizeof(VitalsRecord);
+  printf("%-14s %7zu registros  %2zu bloques  %6.2f B/registro  texto %6.1fx  struct %5.1fx  %s\n",
+         s.name, s.records.size(), blocks, (double)encoded / s.records.size(),
+         (double)s.textBytes / encoded, (double)raw / encoded, pass ? "OK" : "FALLA");
+}
+
+static volatile double sink;   // Evita que se descarte la decodificación
+
+static void benchmark(const Session &s) {
+  static uint8_t block[BLOCK_SIZE];
+  TimeSeriesEncoder encoder;
+  size_t n = s.records.size();
+  uint64_t bytes = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  encoder.begin(block, sizeof(block));
+  for (size_t i = 0; i < BENCH_RECORDS; i++) {
+    if (!encoder.append(s.records[i % n])) {
+      bytes += encoder.size();
+      encoder.begin(block, sizeof(block));
+      encoder.append(s.records[i % n]);
+    }
+  }
+  bytes += encoder.size();
+  double encodeS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  // Un bloque lleno decodificado repetidamente
+  encoder.begin(block, sizeof(block));
+  size_t perBlock = 0;
+  while (encoder.append(s.records[perBlock % n])) perBlock++;
+  size_t blockLen = encoder.size();
+  VitalsRecord rec;
+  double checksum = 0.0;
+  size_t decoded = 0;
+  t0 = std::chrono::steady_clock::now();
+  while (decoded < BENCH_RECORDS) {
+    TimeSeriesDecoder decoder(block, blockLen);
+    while (decoder.next(rec)) {
+      checksum += rec.bpm;
+      decoded++;
+    }
+  }
+  double decodeS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  sink = checksum;
+  printf("%-14s codificación %6.1f M registros/s (%6.1f MB/s)  decodificación %6.1f M registros/s\n",
+         s.name, BENCH_RECORDS / encodeS / 1e6, bytes / encodeS / 1e6, decoded / decodeS / 1e6);
+}
+
+int main(int argc, char **argv) {
+  std::mt19937 rng(26);
+  std::vector<Session> sessions;
+  sessions.push_back(restingSession(rng));
+  sessions.push_back(ambulatorySession(rng));
+  for (int i = 1; i < argc; i++) {
+    Session s{argv[i], {}, 0};
+    if (!loadCapture(argv[i], s) || s.records.empty()) {
+      fprintf(stderr, "%s: sin reportes\n", argv[i]);
+      return 1;
+    }
+    sessions.push_back(s);
+  }
+
+  bool ok = true;
+  printf("Razón de compresión (bloques de %zu bytes)\n", BLOCK_SIZE);
+  for (const Session &s : sessions) report(s, ok);
+  printf("Velocidad (%zu registros)\n", BENCH_RECORDS);
+  for (const Session &s : sessions) benchmark(s);
+  return ok ? 0 : 1;
+}
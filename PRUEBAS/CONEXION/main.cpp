@@ -0,0 +1,155 @@
+// Prueba de conexión en caliente sobre el bus emulado (COMP_BUS_MOCK): un
+// sitio con MAX30102 y SHT31 detrás de puertos que se abren y cierran con
+// setMuxMask(), como al enchufar y desenchufar los sensores. Comprueba el
+// arranque con el MAX30102 ausente, su alta posterior, que un FIFO que deja
+// de entregar muestras con el chip respondiendo no se toma por una
+// desconexión (ni provoca un ciclo "sin respuesta"/"reconectado"), la baja
+// al desenchufarlo, la vuelta de un chip nuevo y el chip que se reinicia
+// sin desenchufarse, que se vuelve a configurar sin pasar por el sondeo.
+// El chip emulado solo convierte mientras está visible y configurado.
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -DPLATFORM_SIMULATED_TIME -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o conexion
+//
+// Uso:
+//   ./conexion
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+
+typedef SensorChannelsT<MockBus> Channels;
+
+static const uint8_t MAX30102_ADDR = 0x57;
+static const uint8_t SHT31_ADDR = 0x44;
+static const uint8_t PULSE_PORT = 0x01;
+static const uint8_t CLIMATE_PORT = 0x02;
+static const float BPM = 72.0f;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+struct Bench {
+  MockI2CBus bus;
+  MockMAX30102 chip;
+  MockSHT31 climateChip;
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  SHT31T<MockBus> climate{MockBus(bus)};
+  Channels channels;
+  uint8_t mask = 0;
+  bool converting = true;     // false: el FIFO deja de recibir muestras
+  uint32_t beat = 0;
+  uint32_t offlineEvents = 0;
+  bool wasOnline = false;
+
+  Bench() {
+    bus.addDevice(MAX30102_ADDR, &chip, 0);
+    bus.addDevice(SHT31_ADDR, &climateChip, 1);
+    channels.addChannel(&pulse, &climate);
+  }
+
+  void plug(uint8_t ports) {
+    mask = ports;
+    bus.setMuxMask(mask);
+  }
+
+  bool pulseOnline() const { return channels.isDeviceOnline(0, DEVICE_PULSE); }
+  uint32_t attaches() const { return channels.getAttachCount(0, DEVICE_PULSE); }
+
+  // MODE_CONFIG con modo SpO2 y fuera de shutdown
+  bool configured() const {
+    uint8_t mode = chip.getRegister(REG_MODE_CONFIG);
+    return (mode & 0x07) != 0 && !(mode & 0x80);
+  }
+
+  // Avanza ms en pasos de 10 ms con un dedo sobre el sensor; devuelve el
+  // tiempo hasta que el MAX30102 queda en el estado indicado (o ms)
+  uint32_t run(uint32_t ms, int until = -1) {
+    uint32_t reached = ms;
+    for (uint32_t t = 0; t < ms; t += 10) {
+      if ((mask & PULSE_PORT) && configured() && converting) {
+        double phase = 2.0 * M_PI * BPM / 60.0 * beat++ / 100.0;
+        double ir = 50000.0 + 1500.0 * sin(phase) + 500.0 * sin(2.0 * phase);
+        chip.pushSample((uint32_t)(0.8 * ir), (uint32_t)ir);
+      }
+      channels.poll(5000);
+      bool online = pulseOnline();
+      if (wasOnline && !online) offlineEvents++;
+      wasOnline = online;
+      if (until >= 0 && reached == ms && online == (until != 0)) reached = t;
+      delay(10);
+    }
+    return reached;
+  }
+};
+
+int main() {
+  Bench b;
+
+  printf("Arranque sin MAX30102\n");
+  b.plug(CLIMATE_PORT);
+  check(b.channels.beginAll() == 0, "beginAll() no cuenta el canal incompleto");
+  check(!b.pulseOnline() && b.channels.isDeviceOnline(0, DEVICE_CLIMATE), "pulso ausente, clima presente");
+  b.run(3000);
+  check(!b.pulseOnline() && b.attaches() == 0, "sigue ausente sin alta");
+
+  printf("Se enchufa el MAX30102\n");
+  b.plug(PULSE_PORT | CLIMATE_PORT);
+  uint32_t attach = b.run(10000, 1);
+  printf("  alta en %u ms, primer ritmo a los %u ms, %.1f lpm\n", attach,
+         b.channels.getTimeToFirstVital(0, DEVICE_PULSE), b.channels.getBPM(0));
+  check(attach <= Channels::PROBE_INTERVAL_MS + 20, "alta en un intervalo de sondeo");
+  check(b.attaches() == 1 && b.configured(), "un alta y el chip configurado");
+  check(fabsf(b.channels.getBPM(0) - BPM) < 0.05f * BPM, "mide el pulso");
+
+  printf("FIFO parado 10 s con el chip respondiendo\n");
+  b.converting = false;
+  uint32_t tx = b.bus.getTransactions();
+  b.run(10000);
+  printf("  %u bajas, %u altas, %u transacciones\n", b.offlineEvents, b.attaches(),
+         b.bus.getTransactions() - tx);
+  check(b.pulseOnline() && b.offlineEvents == 0, "no se da por perdido");
+  check(b.attaches() == 1, "ni se vuelve a dar de alta");
+  b.converting = true;
+  b.run(8000);
+  check(fabsf(b.channels.getBPM(0) - BPM) < 0.05f * BPM, "vuelve a medir al llegar muestras");
+
+  printf("Se desenchufa el MAX30102\n");
+  b.plug(CLIMATE_PORT);
+  uint32_t lost = b.run(4000, 0);
+  printf("  baja en %u ms\n", lost);
+  check(!b.pulseOnline() && b.offlineEvents == 1, "se da de baja");
+  check(lost <= Channels::PULSE_TIMEOUT_MS + 20, "en PULSE_TIMEOUT_MS");
+  check(b.channels.getBPM(0) == 0.0f, "sin ritmo mientras falta");
+  check(b.channels.isDeviceOnline(0, DEVICE_CLIMATE), "el clima sigue en línea");
+
+  printf("Se enchufa un chip nuevo\n");
+  b.chip.powerOnReset();
+  b.plug(PULSE_PORT | CLIMATE_PORT);
+  attach = b.run(10000, 1);
+  printf("  alta en %u ms, %.1f lpm\n", attach, b.channels.getBPM(0));
+  check(b.pulseOnline() && b.attaches() == 2 && b.configured(), "segunda alta, chip configurado");
+  check(fabsf(b.channels.getBPM(0) - BPM) < 0.05f * BPM, "mide el pulso");
+
+  printf("El chip se reinicia sin desenchufarse\n");
+  b.chip.powerOnReset();
+  b.run(Channels::PULSE_TIMEOUT_MS + 100);
+  printf("  %u bajas, %u altas\n", b.offlineEvents, b.attaches());
+  check(b.attaches() == 3 && b.configured(), "se reconfigura en PULSE_TIMEOUT_MS");
+  check(b.pulseOnline(), "sin esperar al sondeo");
+  b.run(8000);
+  check(fabsf(b.channels.getBPM(0) - BPM) < 0.05f * BPM, "vuelve a medir");
+
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,164 @@
+// Prueba de COMP_ESTADISTICAS: los percentiles P² (p5/p50/p95) de
+// WindowStats se comparan con los cuantiles exactos de la misma serie
+// ordenada, y el mínimo, máximo, media y desviación con un cálculo en doble
+// precisión a dos pasadas. Se usan series con forma de BPM (normal, uniforme,
+// sesgada, bimodal, creciente y constante) y ventanas cortas y largas.
+// El error de un percentil se mide en rango: la fracción de muestras por
+// debajo de la estimación frente a p.
+//
+// Compilación (Linux):
+//   g++ -std=c++11 -O2 -I../../SISTEMA/LIB_SISTEMA main.cpp
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o estadisticas
+//
+// Uso:
+//   ./estadisticas
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "COMP_ESTADISTICAS.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+enum Shape { NORMAL, UNIFORM, SKEWED, BIMODAL, RISING, CONSTANT };
+
+static const char *shapeName(Shape s) {
+  switch (s) {
+    case NORMAL:   return "normal";
+    case UNIFORM:  return "uniforme";
+    case SKEWED:   return "sesgada";
+    case BIMODAL:  return "bimodal";
+    case RISING:   return "creciente";
+    default:       return "constante";
+  }
+}
+
+static std::vector<float> series(Shape s, size_t n, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> normal(72.0f, 8.0f);
+  std::uniform_real_distribution<float> uniform(50.0f, 120.0f);
+  std::exponential_distribution<float> tail(1.0f / 12.0f);
+  std::bernoulli_distribution exercise(0.3);
+  std::vector<float> v(n);
+  for (size_t i = 0; i < n; i++) {
+    switch (s) {
+      case NORMAL:   v[i] = normal(rng); break;
+      case UNIFORM:  v[i] = uniform(rng); break;
+      case SKEWED:   v[i] = 55.0f + tail(rng); break;
+      case BIMODAL:  v[i] = exercise(rng) ? normal(rng) + 60.0f : normal(rng); break;
+      case RISING:   v[i] = 60.0f + 60.0f * i / n; break;
+      default:       v[i] = 72.0f; break;
+    }
+  }
+  return v;
+}
+
+// Fracción de la serie ordenada estrictamente por debajo de x y hasta x
+// inclusive; con valores repetidos la estimación es válida en todo ese rango
+static void rankOf(const std::vector<float> &sorted, float x, double &lo, double &hi) {
+  double n = sorted.size();
+  lo = (std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin()) / n;
+  hi = (std::upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin()) / n;
+}
+
+static double rankError(const std::vector<float> &sorted, float x, double p) {
+  double lo, hi;
+  rankOf(sorted, x, lo, hi);
+  if (p < lo) return lo - p;
+  if (p > hi) return p - hi;
+  return 0.0;
+}
+
+static void testShape(Shape s, size_t n, double tolerance) {
+  std::vector<float> v = series(s, n, 1234 + (uint32_t)s * 7 + (uint32_t)n);
+  WindowStats w;
+  for (size_t i = 0; i < v.size(); i++) w.add(v[i]);
+
+  double sum = 0.0;
+  for (size_t i = 0; i < n; i++) sum += v[i];
+  double mean = sum / n;
+  double sq = 0.0;
+  for (size_t i = 0; i < n; i++) sq += (v[i] - mean) * (v[i] - mean);
+  double sd = n > 1 ? sqrt(sq / (n - 1)) : 0.0;
+
+  std::vector<float> sorted(v);
+  std::sort(sorted.begin(), sorted.end());
+  double e5 = rankError(sorted, w.getP5(), 0.05);
+  double e50 = rankError(sorted, w.getP50(), 0.50);
+  double e95 = rankError(sorted, w.getP95(), 0.95);
+  double worst = std::max(e5, std::max(e50, e95));
+
+  printf("%s, %zu muestras: p5 %.1f/%.1f p50 %.1f/%.1f p95 %.1f/%.1f, "
+         "rango %.3f\n", shapeName(s), n,
+         w.getP5(), sorted[(size_t)(0.05 * (n - 1) + 0.5)],
+         w.getP50(), sorted[(size_t)(0.50 * (n - 1) + 0.5)],
+         w.getP95(), sorted[(size_t)(0.95 * (n - 1) + 0.5)], worst);
+
+  char what[96];
+  check(w.getCount() == n, "cuenta");
+  check(w.getMin() == sorted.front() && w.getMax() == sorted.back(), "mínimo y máximo exactos");
+  check(fabs(w.getMean() - mean) <= 1e-3 * fabs(mean), "media frente a dos pasadas");
+  check(fabs(w.getStdDev() - sd) <= 1e-3 * sd + 1e-4, "desviación frente a dos pasadas");
+  check(w.getP5() <= w.getP50() && w.getP50() <= w.getP95(), "p5 <= p50 <= p95");
+  check(w.getP5() >= sorted.front() && w.getP95() <= sorted.back(), "percentiles dentro de [mín, máx]");
+  snprintf(what, sizeof(what), "error de rango de p5/p50/p95 <= %.2f", tolerance);
+  check(worst <= tolerance, what);
+}
+
+// Con menos de cinco muestras P² devuelve el rango más cercano exacto
+static void testFewSamples() {
+  printf("Menos de cinco muestras\n");
+  P2Quantile q(0.5f);
+  check(q.get() == 0.0f, "sin muestras devuelve 0");
+  q.add(80.0f);
+  check(q.get() == 80.0f, "una muestra");
+  q.add(60.0f);
+  q.add(70.0f);
+  check(q.get() == 70.0f, "mediana de tres desordenadas");
+  q.reset();
+  check(q.get() == 0.0f, "reset() vacía el estimador");
+
+  WindowStats w;
+  w.add(72.0f);
+  check(w.getVariance() == 0.0f && w.getMin() == 72.0f && w.getMax() == 72.0f,
+        "una muestra: varianza 0, mín = máx");
+}
+
+static void bench() {
+  const size_t n = 4000000;
+  std::vector<float> v = series(NORMAL, 1 << 16, 99);
+  WindowStats w;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i++) w.add(v[i & 0xFFFF]);
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("Rendimiento\n");
+  printf("  WindowStats::add(): %.1f M muestras/s (%.1f ns), p50 %.1f\n",
+         n / s / 1e6, s / n * 1e9, w.getP50());
+}
+
+int main() {
+  testFewSamples();
+
+  // Las ventanas se vacían en cada informe: un minuto de BPM son decenas de
+  // muestras y 10000 son casi tres horas de valores por segundo. P² se
+  // aproxima más cuanto más larga es la serie
+  static const Shape shapes[] = {NORMAL, UNIFORM, SKEWED, BIMODAL, RISING, CONSTANT};
+  for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+    testShape(shapes[i], 60, 0.10);
+    testShape(shapes[i], 1000, 0.03);
+    testShape(shapes[i], 10000, 0.01);
+  }
+
+  bench();
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+// Prueba del FIFO del MAX30102 sobre el bus emulado (COMP_BUS_MOCK): cuenta
+// de muestras con el FIFO parcial, lleno y desbordado (FIFO_ROLLOVER_EN a 0,
+// como lo deja applyProfile()), y un canal con el perfil de 800 Hz leído
+// más despacio de lo que tarda en llenarse el FIFO, que debe seguir
+// entregando muestras sin darse por perdido. Por último un cambio de
+// perfil en marcha, con un dedo que devuelve luz en proporción a la
+// corriente del LED: el nuevo nivel no debe tomarse como un artefacto.
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -DPLATFORM_SIMULATED_TIME -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o fifo
+//
+// Uso:
+//   ./fifo
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <utility>
+#include <vector>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> Samples;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Muestras numeradas: IR = 1000 + n, rojo = n
+static void push(MockMAX30102 &chip, uint32_t &n, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++, n++) chip.pushSample(n, 1000 + n);
+}
+
+static bool consecutive(const Samples &s, uint32_t first) {
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i].first != first + i || s[i].second != 1000 + first + i) return false;
+  }
+  return true;
+}
+
+// Canal con el perfil de 800 Hz leído cada periodMs; devuelve si siguió
+// en línea todo el tiempo y cuántas muestras procesó
+static void runChannel(uint32_t periodMs, uint32_t seconds, bool &online,
+                       uint32_t &attaches, uint32_t &samples, uint32_t &pushed) {
+  MockI2CBus bus;
+  MockMAX30102 chip;
+  bus.addDevice(0x57, &chip);
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  SensorChannelsT<MockBus> channels;
+  channels.addChannel(&pulse, nullptr);
+  channels.beginAll();
+  channels.setProfile(0, PROFILE_HIGH_RES_800);
+
+  online = true;
+  pushed = 0;
+  uint32_t k = 0;
+  for (uint32_t t = 0; t < seconds * 1000; t += periodMs) {
+    for (uint32_t i = 0; i < periodMs * 800 / 1000; i++, k++) {
+      double ir = 50000.0 + 1500.0 * sin(2.0 * M_PI * 1.25 * k / 800.0);
+      chip.pushSample((uint32_t)(0.8 * ir), (uint32_t)ir);
+      pushed++;
+    }
+    delay(periodMs);
+    channels.poll(5000);
+    online &= channels.isDeviceOnline(0, DEVICE_PULSE);
+  }
+  attaches = channels.getAttachCount(0, DEVICE_PULSE);
+  samples = channels.getSampleCount(0);
+}
+
+// Canal con dedo que pasa de PROFILE_STANDARD a PROFILE_LOW_POWER a los
+// 15 s; cuenta las ventanas rechazadas por el índice de calidad en los 5 s
+// siguientes al cambio
+static void runSwitch(uint32_t &rejected, uint32_t &windows, float &bpm) {
+  MockI2CBus bus;
+  MockMAX30102 chip;
+  bus.addDevice(0x57, &chip);
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  SensorChannelsT<MockBus> channels;
+  channels.addChannel(&pulse, nullptr);
+  channels.beginAll();
+
+  rejected = windows = 0;
+  for (uint32_t t = 0; t < 25000; t += 10) {
+    if (t == 15000) channels.setProfile(0, PROFILE_LOW_POWER);
+    // SPO2_SR en SPO2_CONFIG[4:2]: 50 Hz, una muestra cada 20 ms
+    bool slow = ((chip.getRegister(REG_SPO2_CONFIG) >> 2) & 0x07) == SR_CODE_50HZ;
+    if (!slow || (t % 20) == 0) {
+      double rf = pow(2.0, 2 - ((chip.getRegister(REG_SPO2_CONFIG) >> 5) & 0x03));
+      double beat = 1.0 + 0.02 * sin(2.0 * M_PI * 1.2 * t / 1000.0);
+      double ir = 1400.0 * chip.getRegister(REG_LED2_PA) * rf * beat;
+      double red = 1000.0 * chip.getRegister(REG_LED1_PA) * rf * beat;
+      chip.pushSample((uint32_t)red, (uint32_t)ir);
+    }
+    const SignalQuality &q = channels.getQuality(0);
+    uint32_t w = q.getWindowCount(), r = q.getRejectedCount();
+    channels.poll(5000);
+    delay(10);
+    if (t >= 15000 && t < 20000) {
+      windows += q.getWindowCount() - w;
+      rejected += q.getRejectedCount() - r;
+    }
+  }
+  bpm = channels.getBPM(0);
+}
+
+int main() {
+  MockI2CBus bus;
+  MockMAX30102 chip;
+  bus.addDevice(0x57, &chip);
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  Samples s;
+  uint32_t n = 0;
+
+  printf("Cuenta del FIFO (perfil %s)\n", PROFILE_HIGH_RES_800.name);
+  check(pulse.begin(), "begin()");
+  pulse.setup();
+  pulse.applyProfile(PROFILE_HIGH_RES_800);
+  check((chip.getRegister(0x08) & 0x10) == 0, "applyProfile() deja FIFO_ROLLOVER_EN a 0");
+
+  check(!pulse.readAllFIFO(s) && s.empty(), "FIFO vacío: ninguna muestra");
+  push(chip, n, 10);
+  check(pulse.readAllFIFO(s) && s.size() == 10 && consecutive(s, 0), "10 muestras en orden");
+  push(chip, n, 30);   // Los punteros dan la vuelta al búfer circular
+  check(pulse.readAllFIFO(s) && s.size() == 30 && consecutive(s, 10),
+        "30 muestras con los punteros dando la vuelta");
+
+  uint32_t first = n;
+  push(chip, n, 45);   // 13 muestras más de las que caben
+  bool read = pulse.readAllFIFO(s);
+  check(read && s.size() == 32 && consecutive(s, first),
+        "FIFO desbordado: se leen las 32 más antiguas");
+  check(!pulse.readAllFIFO(s), "tras leerlo queda vacío (OVF_COUNTER a 0)");
+  push(chip, n, 5);
+  check(pulse.readAllFIFO(s) && s.size() == 5 && consecutive(s, n - 5),
+        "la adquisición sigue tras el desbordamiento");
+
+  push(chip, n, 40);
+  uint32_t red = 0, ir = 0;
+  check(pulse.readFIFO(red, ir) && red == n - 9, "readFIFO() vacía un FIFO desbordado");
+
+  printf("Canal a 800 Hz\n");
+  bool online;
+  uint32_t attaches, samples, pushed;
+  // Cada 20 ms: 16 muestras por lectura, ninguna se pierde
+  runChannel(20, 10, online, attaches, samples, pushed);
+  printf("  cada 20 ms: %u muestras leídas de %u, %u conexiones\n", samples, pushed, attaches);
+  check(online && attaches == 1 && samples == pushed / PROFILE_HIGH_RES_800.decimation,
+        "lectura a tiempo: todas las muestras");
+  // Cada 60 ms: 48 muestras por lectura, el FIFO se llena y desborda
+  runChannel(60, 10, online, attaches, samples, pushed);
+  printf("  cada 60 ms: %u muestras leídas de %u, %u conexiones\n", samples, pushed, attaches);
+  check(online && attaches == 1, "lectura tardía: el canal sigue en línea");
+  check(samples >= pushed * 32 / 48 / PROFILE_HIGH_RES_800.decimation - 16,
+        "lectura tardía: 32 muestras por lectura");
+
+  printf("Cambio de perfil en marcha\n");
+  uint32_t rejected, windows;
+  float bpm;
+  runSwitch(rejected, windows, bpm);
+  printf("  %s -> %s: %u/%u ventanas rechazadas, %.1f lpm\n", PROFILE_STANDARD.name,
+         PROFILE_LOW_POWER.name, rejected, windows, bpm);
+  check(windows > 0 && rejected == 0, "el cambio de nivel no se rechaza como artefacto");
+  check(fabsf(bpm - 72.0f) < 0.05f * 72.0f, "sigue midiendo el pulso");
+
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
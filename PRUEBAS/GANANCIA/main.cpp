@@ -0,0 +1,189 @@
+// Prueba del control automático de ganancia de los LED (COMP_GANANCIA).
+// Primero LedGainControl solo: desde ajustes y niveles al azar (incluido un
+// LED en su límite, que obliga a cambiar el rango del ADC compartido) cada
+// paso debe mover la ganancia de cada LED como mucho MAX_STEP. Después un
+// canal completo sobre el bus emulado (COMP_BUS_MOCK), con tejidos de
+// reflectancia muy distinta: el nivel debe acabar en la banda objetivo (o
+// el LED en su límite), sin saturar, con el pulso bien medido y sin saltos
+// de ganancia mayores que MAX_STEP en los registros del chip.
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -DPLATFORM_SIMULATED_TIME -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o ganancia
+//
+// Uso:
+//   ./ganancia
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <random>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+
+typedef SensorChannelsT<MockBus> Channels;
+
+static const uint8_t MAX30102_ADDR = 0x57;
+static const uint8_t SHT31_ADDR = 0x44;
+static const float BPM = 72.0f;
+// Redondeo de la amplitud a un código entero
+static const float STEP_SLACK = 1.05f;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Alimenta niveles constantes durante un intervalo; devuelve si hubo paso
+static bool interval(LedGainControl &g, uint32_t &now, uint32_t red, uint32_t ir) {
+  bool stepped = false;
+  for (uint32_t t = 0; t <= LedGainControl::INTERVAL_MS && !stepped; t += 10, now += 10) {
+    stepped = g.update(red, ir, true, now);
+  }
+  return stepped;
+}
+
+static bool withinStep(float ratio) {
+  return ratio <= LedGainControl::MAX_STEP * STEP_SLACK &&
+         ratio >= 1.0f / (LedGainControl::MAX_STEP * STEP_SLACK);
+}
+
+static void testStepBound() {
+  printf("Tamaño de cada paso\n");
+  uint32_t now = 1000;
+
+  // Rojo en su máximo y aún bajo, IR bajo: el rango baja (x2) a la vez que
+  // el IR pediría doblar su amplitud
+  LedGainControl g;
+  LedGainControl::Retained start = {LedGainControl::MAX_AMPLITUDE, 0x40, 2};
+  g.restore(PROFILE_STANDARD, start, now);
+  float red0 = g.getRedGain(), ir0 = g.getIRGain();
+  bool stepped = interval(g, now, 10000, 20000);
+  float redRatio = g.getRedGain() / red0, irRatio = g.getIRGain() / ir0;
+  printf("  rojo al límite + IR bajo: rango %u -> %u, rojo x%.2f, IR x%.2f\n",
+         start.adcRange, g.getADCRange(), redRatio, irRatio);
+  check(stepped && g.getADCRange() == 1, "el rango del ADC baja");
+  check(withinStep(redRatio) && withinStep(irRatio), "ningún LED pasa de MAX_STEP");
+  check(fabsf(g.getRedStep() - redRatio) < 1e-3f && fabsf(g.getIRStep() - irRatio) < 1e-3f,
+        "getRedStep()/getIRStep() son el cambio real de ganancia");
+  check(irRatio > 1.5f, "el IR sube lo que pedía");
+
+  // IR en su mínimo y saturado, rojo dentro de banda: el rango sube (x0.5)
+  // y el rojo no debe perder la mitad de su nivel
+  start.redAmplitude = 0x40;
+  start.irAmplitude = LedGainControl::MIN_AMPLITUDE;
+  start.adcRange = 1;
+  g.restore(PROFILE_STANDARD, start, now);
+  red0 = g.getRedGain();
+  ir0 = g.getIRGain();
+  interval(g, now, LedGainControl::TARGET, LedGainControl::FULL_SCALE);
+  redRatio = g.getRedGain() / red0;
+  irRatio = g.getIRGain() / ir0;
+  printf("  IR al límite saturado + rojo en banda: rango %u -> %u, rojo x%.2f, IR x%.2f\n",
+         start.adcRange, g.getADCRange(), redRatio, irRatio);
+  check(g.getADCRange() == 2 && fabsf(irRatio - 0.5f) < 0.01f, "el rango sube y el IR baja a la mitad");
+  check(fabsf(redRatio - 1.0f) < 0.05f, "el rojo en banda conserva su ganancia");
+
+  // Al azar: ajustes, niveles y saturaciones
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> amp(LedGainControl::MIN_AMPLITUDE, LedGainControl::MAX_AMPLITUDE);
+  std::uniform_int_distribution<int> range(0, LedGainControl::MAX_ADC_RANGE);
+  std::uniform_int_distribution<uint32_t> level(0, LedGainControl::FULL_SCALE);
+  uint32_t steps = 0, bad = 0, rangeSteps = 0;
+  float worst = 1.0f;
+  for (int i = 0; i < 200000; i++) {
+    LedGainControl::Retained r = {(uint8_t)amp(rng), (uint8_t)amp(rng), (uint8_t)range(rng)};
+    if (rng() % 4 == 0) r.redAmplitude = (rng() & 1) ? LedGainControl::MAX_AMPLITUDE : LedGainControl::MIN_AMPLITUDE;
+    if (rng() % 4 == 0) r.irAmplitude = (rng() & 1) ? LedGainControl::MAX_AMPLITUDE : LedGainControl::MIN_AMPLITUDE;
+    g.restore(PROFILE_STANDARD, r, now);
+    red0 = g.getRedGain();
+    ir0 = g.getIRGain();
+    if (!interval(g, now, level(rng), level(rng))) continue;
+    steps++;
+    if (g.getADCRange() != r.adcRange) rangeSteps++;
+    redRatio = g.getRedGain() / red0;
+    irRatio = g.getIRGain() / ir0;
+    worst = fmaxf(worst, fmaxf(fmaxf(redRatio, 1.0f / redRatio), fmaxf(irRatio, 1.0f / irRatio)));
+    if (!withinStep(redRatio) || !withinStep(irRatio)) bad++;
+  }
+  printf("  al azar: %u pasos (%u con cambio de rango), peor x%.2f\n", steps, rangeSteps, worst);
+  check(rangeSteps > 1000, "se ejercitan cambios de rango");
+  check(bad == 0, "ningún paso al azar pasa de MAX_STEP");
+}
+
+// Tejido: cuentas de IR por código de amplitud con ADC_RGE = 2; el rojo
+// refleja el 70 % del IR. Sin dedo (finger a false) la luz que vuelve no
+// llega a MIN_SIGNAL y el ajuste no debe moverse
+static void testClosedLoop(double k, bool finger) {
+  MockI2CBus bus;
+  MockMAX30102 chip;
+  MockSHT31 climateChip;
+  bus.addDevice(MAX30102_ADDR, &chip);
+  bus.addDevice(SHT31_ADDR, &climateChip);
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  SHT31T<MockBus> climate{MockBus(bus)};
+  Channels channels;
+  channels.addChannel(&pulse, &climate);
+  channels.beginAll();
+  channels.setGainControl(true);
+
+  double lastGain[2] = {0.0, 0.0}, worstJump = 1.0;
+  uint32_t lateSaturated = 0;
+  double meanIR = 0.0;
+  uint32_t late = 0;
+  for (uint32_t n = 0; n < 3000; n++) {   // 30 s a 100 Hz
+    // Ganancia efectiva del chip: amplitud x escala del rango
+    double rf = pow(2.0, 2 - ((chip.getRegister(REG_SPO2_CONFIG) >> 5) & 0x03));
+    double gain[2] = {chip.getRegister(REG_LED1_PA) * rf, chip.getRegister(REG_LED2_PA) * rf};
+    for (int l = 0; l < 2; l++) {
+      if (lastGain[l] > 0.0 && gain[l] > 0.0) {
+        worstJump = fmax(worstJump, fmax(gain[l] / lastGain[l], lastGain[l] / gain[l]));
+      }
+      lastGain[l] = gain[l];
+    }
+    double beat = 1.0 + 0.01 * sin(2.0 * M_PI * BPM / 60.0 * n / 100.0);
+    double ir = fmin(k * gain[1] * beat, LedGainControl::FULL_SCALE);
+    double red = fmin(0.7 * k * gain[0] * beat, LedGainControl::FULL_SCALE);
+    chip.pushSample((uint32_t)red, (uint32_t)ir);
+    channels.poll(5000);
+    delay(10);
+    if (n >= 2000) {
+      if (ir >= LedGainControl::SATURATION || red >= LedGainControl::SATURATION) lateSaturated++;
+      meanIR += ir;
+      late++;
+    }
+  }
+  meanIR /= late;
+
+  const LedGainControl &g = channels.getGainControl(0);
+  printf("Tejido k = %g: IR 0x%02X rojo 0x%02X rango %u, %u pasos, IR medio %.0f, %.1f lpm\n",
+         k, g.getIRAmplitude(), g.getRedAmplitude(), g.getADCRange(), g.getStepCount(),
+         meanIR, channels.getBPM(0));
+  bool inBand = meanIR >= LedGainControl::TARGET_LOW && meanIR <= LedGainControl::TARGET_HIGH;
+  bool atLimit = (g.getIRAmplitude() == LedGainControl::MAX_AMPLITUDE && g.getADCRange() == 0) ||
+                 (g.getIRAmplitude() == LedGainControl::MIN_AMPLITUDE &&
+                  g.getADCRange() == LedGainControl::MAX_ADC_RANGE);
+  if (!finger) {
+    check(g.getStepCount() == 0, "sin dedo el ajuste no se mueve");
+    return;
+  }
+  check(inBand || atLimit, "IR en la banda objetivo o al límite del ajuste");
+  check(lateSaturated == 0, "sin saturar tras asentarse");
+  check(worstJump <= LedGainControl::MAX_STEP * STEP_SLACK, "saltos de ganancia en el chip <= MAX_STEP");
+  check(fabsf(channels.getBPM(0) - BPM) < 0.05f * BPM, "pulso bien medido");
+}
+
+int main() {
+  testStepBound();
+  testClosedLoop(30.0, false);
+  // De piel muy oscura o dedo mal apoyado a un reflejo que satura de sobra
+  static const double tissues[] = {100.0, 400.0, 3000.0, 20000.0};
+  for (size_t i = 0; i < sizeof(tissues) / sizeof(tissues[0]); i++) testClosedLoop(tissues[i], true);
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
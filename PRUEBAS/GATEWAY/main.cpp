@@ -0,0 +1,389 @@
+// Prueba del colector (COLECTOR/LIB_COLECTOR):
+//  - ReportParser: el texto de reportChannel() y las tramas binarias dan
+//    los mismos registros enteros, byte a byte o en trozos al azar, y las
+//    tramas inválidas se cuentan sin perder la sincronía con el texto.
+//    Las líneas de alerta sólo marcan el registro: las medias se quedan.
+//  - SpscQueue: orden y ausencia de pérdidas entre dos hilos.
+//  - Gateway: muchos dispositivos por el socket local; cada registro
+//    enviado se recibe, se evalúa una vez y cuenta sus alertas. Un
+//    dispositivo que llena su cola deja de leerse hasta que se vacía, sin
+//    perder registros, tampoco al parar.
+//
+// Compilación (Linux):
+//   g++ -std=c++17 -O2 -pthread -I../../COLECTOR/LIB_COLECTOR -I../../SISTEMA/LIB_SISTEMA
+//       main.cpp ../../COLECTOR/LIB_COLECTOR/*.cpp ../../SISTEMA/LIB_SISTEMA/COMP_COMPRESION.cpp
+//       -o gateway
+//
+// Uso:
+//   ./gateway [dispositivos] [reportes por dispositivo]
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "COMP_AGREGADOR.h"
+#include "COMP_COLA.h"
+#include "COMP_GATEWAY.h"
+#include "COMP_PROTOCOLO.h"
+#include "COMP_UMBRALES.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+static const uint32_t EPOCH_BASE = 1760000000;   // 2025-10-09
+
+// Reporte i del dispositivo d: uno de cada diez con fiebre
+static VitalsRecord makeRecord(uint32_t d, uint32_t i) {
+  VitalsRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.timestamp = EPOCH_BASE + i * 60;
+  rec.temperature = (i % 10 == 0) ? 38.25f : 36.50f;
+  rec.bpm = 60.0f + (d % 40);
+  rec.spo2 = 97;
+  rec.latitude = 40.0 + d * 1e-4;
+  rec.longitude = -3.0 - i * 1e-5;
+  rec.flags = REC_HAS_TEMPERATURE | REC_HAS_BPM | REC_HAS_SPO2 | REC_HAS_LOCATION;
+  return rec;
+}
+
+// Texto de reportChannel() en main.ino; las alertas llevan un extremo de
+// la ventana distinto de la media
+static std::string formatReport(const VitalsRecord &rec, int channel) {
+  char buf[512];
+  int n = 0;
+  if (channel >= 0) n += snprintf(buf + n, sizeof(buf) - n, "Canal %d\n", channel);
+  uint8_t alerts = evaluateAlerts(true, rec.temperature, rec.bpm);
+  n += snprintf(buf + n, sizeof(buf) - n, "%s\nTemp: %.2f °C, BPM: %.1f, SpO2: %u%%\n",
+                alerts ? "*** ALERTA DE SALUD ***" : "Estado estable.",
+                rec.temperature, rec.bpm, rec.spo2);
+  if (alerts & ALERT_TEMPERATURE) {
+    n += snprintf(buf + n, sizeof(buf) - n, "Temperatura alta: %.2f °C\n", rec.temperature + 0.6f);
+  }
+  if (alerts & ALERT_HEART_RATE) {
+    n += snprintf(buf + n, sizeof(buf) - n, "Frecuencia cardiaca anómala: %.1f BPM\n", rec.bpm + 25.0f);
+  }
+  n += snprintf(buf + n, sizeof(buf) - n, "  BPM: media %.1f ± 1.0, min 60.0, p5 60.0, p50 70.0, p95 80.0, max 80.0 (n=60)\n",
+                rec.bpm);
+  time_t t = rec.timestamp;
+  struct tm tm;
+  gmtime_r(&t, &tm);
+  char when[20];
+  strftime(when, sizeof(when), "%d/%m/%Y %H:%M:%S", &tm);
+  n += snprintf(buf + n, sizeof(buf) - n, "Timestamp: %s\nUbicación: Lat %.6f, Lon %.6f\n"
+                "-------------------------------\n", when, rec.latitude, rec.longitude);
+  return std::string(buf, n);
+}
+
+// Registro que el parser debe sacar de formatReport(): medias y alertas
+static VitalsRecord reported(VitalsRecord rec) {
+  uint8_t alerts = evaluateAlerts(true, rec.temperature, rec.bpm);
+  if (alerts & ALERT_TEMPERATURE) rec.flags |= REC_ALERT_TEMPERATURE;
+  if (alerts & ALERT_HEART_RATE)  rec.flags |= REC_ALERT_HEART_RATE;
+  return rec;
+}
+
+static std::string formatHistory(uint32_t d, uint32_t first, uint32_t count) {
+  std::vector<uint8_t> out(FRAME_HEADER_SIZE + PROTOCOL_MAX_FRAME);
+  TimeSeriesEncoder encoder;
+  encoder.begin(out.data() + FRAME_HEADER_SIZE, PROTOCOL_MAX_FRAME);
+  for (uint32_t i = 0; i < count; i++) encoder.append(makeRecord(d, first + i));
+  size_t len = writeFrameHeader(out.data(), FRAME_HISTORY, (uint16_t)encoder.size()) + encoder.size();
+  return std::string((const char *)out.data(), len);
+}
+
+struct Collected {
+  std::vector<VitalsRecord> records;
+  std::vector<uint8_t> channels;
+};
+
+static void collect(void *context, const VitalsRecord &rec, uint8_t channel) {
+  Collected *c = (Collected *)context;
+  c->records.push_back(rec);
+  c->channels.push_back(channel);
+}
+
+static bool sameRecord(const VitalsRecord &a, const VitalsRecord &b) {
+  return a.timestamp == b.timestamp && fabsf(a.temperature - b.temperature) < 0.006f &&
+         fabsf(a.bpm - b.bpm) < 0.06f && a.spo2 == b.spo2 &&
+         fabs(a.latitude - b.latitude) < 1e-6 && fabs(a.longitude - b.longitude) < 1e-6 &&
+         a.flags == b.flags;
+}
+
+static void testParser() {
+  printf("ReportParser\n");
+  std::string stream = "Iniciando sistema...\nBus 0: 12.5% ocupado\n";
+  std::vector<VitalsRecord> expected;
+  std::vector<uint8_t> expectedChannels;
+  for (uint32_t i = 0; i < 40; i++) {
+    VitalsRecord rec = makeRecord(3, i);
+    stream += formatReport(rec, (int)(i % 2));
+    expected.push_back(reported(rec));
+    expectedChannels.push_back((uint8_t)(i % 2));
+    if (i == 19) {
+      // Bloque de historial entre dos reportes
+      stream += formatHistory(3, 1000, 150);
+      for (uint32_t k = 0; k < 150; k++) {
+        expected.push_back(makeRecord(3, 1000 + k));
+        expectedChannels.push_back(0);
+      }
+    }
+  }
+  // Trama de tipo desconocido y trama más larga que PROTOCOL_MAX_FRAME
+  uint8_t bad[FRAME_HEADER_SIZE + 2];
+  writeFrameHeader(bad, 0x7F, 2);
+  bad[FRAME_HEADER_SIZE] = bad[FRAME_HEADER_SIZE + 1] = 0x55;
+  stream += std::string((const char *)bad, sizeof(bad)) + "\n";
+  writeFrameHeader(bad, FRAME_HISTORY, PROTOCOL_MAX_FRAME + 1);
+  stream += std::string((const char *)bad, FRAME_HEADER_SIZE) + "basura\n";
+  // Alerta sólo de geocerca: el reporte conserva sus constantes
+  VitalsRecord zone = makeRecord(3, 41);
+  std::string text = formatReport(zone, -1);
+  text.replace(0, strlen("Estado estable."), "*** ALERTA DE SALUD ***");
+  text.insert(text.find("Timestamp:"), "Fuera de la zona de cuidado\n");
+  stream += text;
+  zone.flags |= REC_ALERT_GEOFENCE;
+  expected.push_back(zone);
+  // Alertas por extremos de la ventana con medias normales
+  VitalsRecord burst = makeRecord(3, 43);
+  text = formatReport(burst, -1);
+  text.replace(0, strlen("Estado estable."), "*** ALERTA DE SALUD ***");
+  text.insert(text.find("  BPM: media"),
+              "Temperatura alta: 38.40 °C\nFrecuencia cardiaca anómala: 131.0 BPM\n");
+  stream += text;
+  burst.flags |= REC_ALERT_TEMPERATURE | REC_ALERT_HEART_RATE;
+  expected.push_back(burst);
+  VitalsRecord last = makeRecord(3, 42);
+  stream += formatReport(last, -1);
+  expected.push_back(last);
+  expectedChannels.push_back(0);
+  expectedChannels.push_back(0);
+  expectedChannels.push_back(0);
+
+  const uint8_t *data = (const uint8_t *)stream.data();
+  std::mt19937 rng(7);
+  bool allOk = true;
+  for (int mode = 0; mode < 3; mode++) {
+    ReportParser parser;
+    Collected got;
+    if (mode == 0) {
+      parser.feed(data, stream.size(), collect, &got);
+    } else if (mode == 1) {
+      for (size_t i = 0; i < stream.size(); i++) parser.feed(data + i, 1, collect, &got);
+    } else {
+      std::uniform_int_distribution<size_t> chunk(1, 700);
+      for (size_t i = 0; i < stream.size();) {
+        size_t n = std::min(chunk(rng), stream.size() - i);
+        parser.feed(data + i, n, collect, &got);
+        i += n;
+      }
+    }
+    bool ok = got.records.size() == expected.size() && parser.getErrorCount() == 2;
+    for (size_t i = 0; ok && i < expected.size(); i++) {
+      ok = sameRecord(got.records[i], expected[i]) && got.channels[i] == expectedChannels[i];
+    }
+    allOk &= ok;
+    const char *names[] = {"entero", "byte a byte", "trozos al azar"};
+    printf("  %-15s %zu registros, %u errores\n", names[mode], got.records.size(), parser.getErrorCount());
+  }
+  check(allOk, "texto, tramas y errores iguales con cualquier troceo");
+
+  DeviceAggregate aggregate;
+  resetAggregate(aggregate);
+  uint8_t alerts = aggregateRecord(aggregate, burst, 0);
+  check(alerts == (ALERT_TEMPERATURE | ALERT_HEART_RATE) && aggregate.temperatureMax == burst.temperature,
+        "alertas del equipo contadas sin sustituir las medias");
+}
+
+static void testQueue() {
+  printf("SpscQueue\n");
+  const uint64_t N = 20000000;
+  SpscQueue<uint64_t, 64> queue;
+  bool ordered = true;
+  auto start = std::chrono::steady_clock::now();
+  std::thread consumer([&]() {
+    uint64_t expected = 0, v;
+    while (expected < N) {
+      if (!queue.pop(v)) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (v != expected) ordered = false;
+      expected++;
+    }
+  });
+  for (uint64_t i = 0; i < N;) {
+    if (queue.push(i)) i++;
+    else std::this_thread::yield();
+  }
+  consumer.join();
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("  %.1f M elementos/s entre dos hilos\n", N / s / 1e6);
+  check(ordered && queue.size() == 0, "orden FIFO sin pérdidas");
+}
+
+static int connectUnix(const char *path) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    if (fd >= 0) close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static bool sendAll(int fd, const std::string &s) {
+  size_t off = 0;
+  while (off < s.size()) {
+    ssize_t n = send(fd, s.data() + off, s.size() - off, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    off += (size_t)n;
+  }
+  return true;
+}
+
+static void testGateway(uint32_t devices, uint32_t reports) {
+  printf("Gateway: %u dispositivos x %u reportes\n", devices, reports);
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/prueba_gateway_%d.sock", (int)getpid());
+  Gateway gateway(2, 2);
+  check(gateway.listenUnix(path) && gateway.start(), "escucha en el socket local");
+
+  // Un cliente por dispositivo, al ritmo justo para no llenar las colas;
+  // uno de cada cuatro manda además un bloque de historial
+  const uint32_t HISTORY = 100;
+  uint64_t sent = 0, expectedAlerts = 0;
+  std::vector<int> fds;
+  for (uint32_t d = 0; d < devices; d++) fds.push_back(connectUnix(path));
+  bool connected = true;
+  for (int fd : fds) connected &= fd >= 0;
+  check(connected, "todos los dispositivos conectan");
+  auto start = std::chrono::steady_clock::now();
+  bool sentOk = connected;
+  for (uint32_t i = 0; sentOk && i < reports; i++) {
+    for (uint32_t d = 0; d < devices; d++) {
+      VitalsRecord rec = makeRecord(d, i);
+      sentOk &= sendAll(fds[d], formatReport(rec, -1));
+      sent++;
+      if (evaluateAlerts(true, rec.temperature, rec.bpm)) expectedAlerts++;
+    }
+    if (i % 16 == 15) usleep(2000);
+  }
+  for (uint32_t d = 0; sentOk && d < devices; d += 4) {
+    sentOk &= sendAll(fds[d], formatHistory(d, reports, HISTORY));
+    sent += HISTORY;
+    for (uint32_t k = 0; k < HISTORY; k++) {
+      VitalsRecord rec = makeRecord(d, reports + k);
+      if (evaluateAlerts(true, rec.temperature, rec.bpm)) expectedAlerts++;
+    }
+  }
+  for (int fd : fds) if (fd >= 0) close(fd);
+  check(sentOk, "envío completo");
+
+  // Esperar a que todo se lea y se evalúe
+  GatewayStats stats;
+  for (int wait = 0; wait < 1000; wait++) {
+    gateway.getStats(stats, false);
+    if (stats.received >= sent && stats.processed == stats.received &&
+        stats.connected == 0) break;
+    usleep(10000);
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  gateway.getStats(stats, false);
+  gateway.stop();
+
+  uint64_t records = 0, alerts = 0;
+  bool perDevice = true;
+  for (uint32_t i = 0; i < gateway.getDeviceCount(); i++) {
+    const DeviceAggregate *a = gateway.getAggregate(i);
+    records += a->records;
+    alerts += a->temperatureAlerts;
+    // Cada conexión es un único monitor: FC constante en todo su flujo
+    perDevice &= a->bpmCount == 0 || a->bpmMin == a->bpmMax;
+  }
+  printf("  %.0f registros/s, latencia p50 %u us, p99 %u us, máx %u us\n",
+         stats.processed / s, stats.latency.percentileUs(0.5f),
+         stats.latency.percentileUs(0.99f), stats.latency.maxUs);
+  printf("  enviados %llu, recibidos %llu, pausas %llu, errores %llu\n",
+         (unsigned long long)sent, (unsigned long long)stats.received,
+         (unsigned long long)stats.throttled, (unsigned long long)stats.parseErrors);
+  check(gateway.getDeviceCount() == devices, "un dispositivo por conexión");
+  check(stats.received == sent && stats.parseErrors == 0, "todos los registros recibidos");
+  check(stats.processed == sent && records == sent, "cada registro evaluado una vez");
+  check(alerts == expectedAlerts && stats.alerts == expectedAlerts,
+        "alertas de temperatura reevaluadas en el colector");
+  check(perDevice, "los registros no se mezclan entre dispositivos");
+}
+
+// Un dispositivo vuelca mucho historial de golpe por el mismo lector que
+// otro que sólo manda texto
+static void testBackpressure() {
+  printf("Gateway: cola llena\n");
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/prueba_gateway_%d_cola.sock", (int)getpid());
+  Gateway gateway(1, 1);
+  check(gateway.listenUnix(path) && gateway.start(), "escucha en el socket local");
+
+  const uint32_t FRAMES = 40, HISTORY = 150, REPORTS = 100;
+  std::string flood;
+  for (uint32_t f = 0; f < FRAMES; f++) flood += formatHistory(0, f * HISTORY, HISTORY);
+  std::string text;
+  for (uint32_t i = 0; i < REPORTS; i++) text += formatReport(makeRecord(1, i), -1);
+  uint64_t sent = FRAMES * HISTORY + REPORTS;
+
+  int heavy = connectUnix(path), light = connectUnix(path);
+  bool sentOk = heavy >= 0 && light >= 0 && sendAll(heavy, flood) && sendAll(light, text);
+  GatewayStats stats;
+  for (int wait = 0; wait < 500; wait++) {
+    gateway.getStats(stats, false);
+    if (stats.processed >= sent) break;
+    usleep(10000);
+  }
+  gateway.getStats(stats, false);
+  printf("  recibidos %llu de %llu, pausas %llu\n", (unsigned long long)stats.received,
+         (unsigned long long)sent, (unsigned long long)stats.throttled);
+  check(sentOk && stats.received == sent && stats.processed == sent,
+        "historial mayor que la cola recibido entero");
+  check(stats.throttled > 0, "el dispositivo se deja de leer con la cola llena");
+
+  // Parar con un volcado a medias: lo ya leído se evalúa igualmente
+  int late = connectUnix(path);
+  sentOk = late >= 0 && sendAll(late, flood);
+  usleep(2000);
+  gateway.stop();
+  gateway.getStats(stats, false);
+  check(sentOk && stats.processed == stats.received, "nada leído se pierde al parar");
+  if (heavy >= 0) close(heavy);
+  if (light >= 0) close(light);
+  if (late >= 0) close(late);
+
+  const DeviceAggregate *a = gateway.getAggregate(1);
+  check(a != nullptr && a->records == REPORTS, "el otro dispositivo recibe todos sus reportes");
+}
+
+int main(int argc, char **argv) {
+  uint32_t devices = argc > 1 ? (uint32_t)atoi(argv[1]) : 512;
+  uint32_t reports = argc > 2 ? (uint32_t)atoi(argv[2]) : 200;
+  testParser();
+  testQueue();
+  testGateway(devices, reports);
+  testBackpressure();
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+// Prueba y medida de las geocercas (SISTEMA/LIB_SISTEMA/COMP_GEOCERCA) con
+// miles de zonas y millones de posiciones:
+//  - Cada posición da las mismas zonas con el índice en rejilla que
+//    probando todos los polígonos, y update() informa de entradas y
+//    salidas coherentes con ello.
+//  - Velocidad frente al recorrido de todas las zonas.
+//  - build() rechaza una tabla de celdas que no cabe en lugar de dar la
+//    vuelta al contador de 16 bits (zonas solapadas en toda la rejilla).
+// Las capacidades se amplían en la compilación, como haría un proyecto
+// que cargue muchas zonas.
+//
+// Compilación (Linux):
+//   g++ -std=c++11 -O2 -DGEOFENCE_MAX_ZONES=4096 -DGEOFENCE_MAX_VERTICES=65535
+//       -DGEOFENCE_MAX_CELL_ENTRIES=65535 -DGEOFENCE_GRID=128
+//       -I../../SISTEMA/LIB_SISTEMA main.cpp ../../SISTEMA/LIB_SISTEMA/COMP_GEOCERCA.cpp
+//       -o geocerca
+//
+// Uso:
+//   ./geocerca [zonas] [posiciones]
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include "COMP_GEOCERCA.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Ciudad de 20 x 20 km alrededor de Madrid
+static const float CITY_LAT = 40.40f, CITY_LON = -3.70f;
+static const float CITY_SPAN = 0.18f;
+static const float METERS_PER_DEG = 111000.0f;
+
+struct Polygon {
+  uint16_t id;
+  std::vector<float> lat, lon;
+  float minLat, maxLat, minLon, maxLon;
+};
+
+// Polígono estrellado de 5 a 12 vértices y 30-300 m de radio
+static Polygon randomZone(std::mt19937 &rng, uint16_t id) {
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  Polygon p;
+  p.id = id;
+  float cLat = CITY_LAT + CITY_SPAN * unit(rng), cLon = CITY_LON + CITY_SPAN * unit(rng);
+  float radius = (30.0f + 270.0f * unit(rng)) / METERS_PER_DEG;
+  int n = 5 + (int)(rng() % 8);
+  for (int k = 0; k < n; k++) {
+    float a = 2.0f * (float)M_PI * (k + 0.8f * unit(rng)) / n;
+    float r = radius * (0.4f + 0.6f * unit(rng));
+    p.lat.push_back(cLat + r * sinf(a));
+    p.lon.push_back(cLon + r * cosf(a));
+  }
+  p.minLat = *std::min_element(p.lat.begin(), p.lat.end());
+  p.maxLat = *std::max_element(p.lat.begin(), p.lat.end());
+  p.minLon = *std::min_element(p.lon.begin(), p.lon.end());
+  p.maxLon = *std::max_element(p.lon.begin(), p.lon.end());
+  return p;
+}
+
+// Referencia: mismo criterio de rayo que Geofence::contains()
+static bool inside(const Polygon &p, float latitude, float longitude) {
+  if (latitude < p.minLat || latitude > p.maxLat || longitude < p.minLon || longitude > p.maxLon) return false;
+  bool in = false;
+  size_t n = p.lat.size();
+  for (size_t i = 0, j = n - 1; i < n; j = i++) {
+    if ((p.lat[i] > latitude) != (p.lat[j] > latitude) &&
+        longitude < (p.lon[j] - p.lon[i]) * (latitude - p.lat[i]) / (p.lat[j] - p.lat[i]) + p.lon[i]) {
+      in = !in;
+    }
+  }
+  return in;
+}
+
+// Paseo por la ciudad: pasos de ~10 m con saltos ocasionales
+static void makeFixes(std::mt19937 &rng, size_t count, std::vector<float> &lat, std::vector<float> &lon) {
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::normal_distribution<float> step(0.0f, 10.0f / METERS_PER_DEG);
+  float la = CITY_LAT + CITY_SPAN / 2, lo = CITY_LON + CITY_SPAN / 2;
+  lat.resize(count);
+  lon.resize(count);
+  for (size_t i = 0; i < count; i++) {
+    if (rng() % 1000 == 0) {
+      la = CITY_LAT + CITY_SPAN * unit(rng);
+      lo = CITY_LON + CITY_SPAN * unit(rng);
+    }
+    la = std::min(CITY_LAT + CITY_SPAN, std::max(CITY_LAT, la + step(rng)));
+    lo = std::min(CITY_LON + CITY_SPAN, std::max(CITY_LON, lo + step(rng)));
+    lat[i] = la;
+    lon[i] = lo;
+  }
+}
+
+static void testIndex(uint32_t zoneCount, size_t fixCount) {
+  printf("Índice: %u zonas, rejilla %dx%d, %zu posiciones\n", zoneCount, GEOFENCE_GRID, GEOFENCE_GRID, fixCount);
+  std::mt19937 rng(1);
+  std::vector<Polygon> zones;
+  std::unique_ptr<Geofence> fence(new Geofence());
+  bool added = true;
+  for (uint32_t z = 0; z < zoneCount; z++) {
+    zones.push_back(randomZone(rng, (uint16_t)(1000 + z)));
+    const Polygon &p = zones.back();
+    added &= fence->addZone(p.id, p.lat.data(), p.lon.data(), (uint16_t)p.lat.size());
+  }
+  check(added && fence->getZoneCount() == zoneCount, "zonas añadidas");
+  auto t0 = Clock::now();
+  check(fence->build(), "build() del índice");
+  printf("  build() en %.2f ms\n", std::chrono::duration<double>(Clock::now() - t0).count() * 1e3);
+
+  std::vector<float> lat, lon;
+  makeFixes(rng, fixCount, lat, lon);
+
+  // Zonas de cada posición según el índice (update) y sus eventos
+  std::vector<uint16_t> before, now, truth;
+  GeofenceEvent events[2 * GEOFENCE_MAX_INSIDE];
+  size_t mismatches = 0, badEvents = 0, insideFixes = 0, totalEvents = 0;
+  double indexS = 0.0;
+  for (size_t i = 0; i < fixCount; i++) {
+    auto start = Clock::now();
+    uint8_t n = fence->update(lat[i], lon[i], events, 2 * GEOFENCE_MAX_INSIDE);
+    indexS += std::chrono::duration<double>(Clock::now() - start).count();
+    totalEvents += n;
+
+    now.clear();
+    for (uint8_t k = 0; k < fence->getInsideCount(); k++) now.push_back(fence->getInsideZoneId(k));
+    std::sort(now.begin(), now.end());
+    if (!now.empty()) insideFixes++;
+
+    // Los eventos son exactamente la diferencia entre antes y ahora
+    std::vector<uint16_t> entered, exited;
+    std::set_difference(now.begin(), now.end(), before.begin(), before.end(), std::back_inserter(entered));
+    std::set_difference(before.begin(), before.end(), now.begin(), now.end(), std::back_inserter(exited));
+    size_t in = 0, out = 0;
+    bool eventsOk = true;
+    for (uint8_t k = 0; k < n; k++) {
+      const std::vector<uint16_t> &set = events[k].entered ? entered : exited;
+      eventsOk &= std::binary_search(set.begin(), set.end(), events[k].zoneId);
+      (events[k].entered ? in : out)++;
+    }
+    if (!eventsOk || in != entered.size() || out != exited.size()) badEvents++;
+    before = now;
+
+    // Contraste con todas las zonas en una de cada 20 posiciones
+    if (i % 20 == 0) {
+      truth.clear();
+      for (const Polygon &p : zones) {
+        if (inside(p, lat[i], lon[i])) truth.push_back(p.id);
+      }
+      if (truth.size() > GEOFENCE_MAX_INSIDE) truth.resize(GEOFENCE_MAX_INSIDE);
+      std::sort(truth.begin(), truth.end());
+      if (truth != now) mismatches++;
+      int32_t first = fence->findZone(lat[i], lon[i]);
+      if ((first < 0) != truth.empty()) mismatches++;
+    }
+  }
+
+  // Recorrido de todas las zonas para comparar el tiempo
+  size_t bruteFixes = std::min(fixCount, (size_t)20000);
+  auto start = Clock::now();
+  volatile size_t bruteInside = 0;
+  for (size_t i = 0; i < bruteFixes; i++) {
+    for (const Polygon &p : zones) {
+      if (inside(p, lat[i], lon[i])) {
+        bruteInside++;
+        break;
+      }
+    }
+  }
+  double bruteS = std::chrono::duration<double>(Clock::now() - start).count();
+  printf("  índice: %.2f M posiciones/s (%.0f ns), todas las zonas: %.3f M posiciones/s (%.0f ns)\n",
+         fixCount / indexS / 1e6, indexS / fixCount * 1e9,
+         bruteFixes / bruteS / 1e6, bruteS / bruteFixes * 1e9);
+  printf("  %.1f%% de posiciones dentro de alguna zona, %zu eventos\n",
+         100.0 * insideFixes / fixCount, totalEvents);
+  check(mismatches == 0, "mismas zonas que probando todos los polígonos");
+  check(badEvents == 0, "entradas y salidas coherentes");
+}
+
+static void testOverflow() {
+  printf("Desbordamiento de la tabla de celdas\n");
+  // Zonas idénticas que cubren la rejilla entera, GRID^2 pares (celda,
+  // zona) cada una, hasta pasar de GEOFENCE_MAX_CELL_ENTRIES: con 16 x 16
+  // son 256 zonas y con 128 x 128 cuatro; 65536 en 16 bits daba 0
+  std::unique_ptr<Geofence> fence(new Geofence());
+  const float lat[4] = {40.0f, 40.0f, 40.1f, 40.1f};
+  const float lon[4] = {-3.0f, -2.9f, -2.9f, -3.0f};
+  uint32_t zones = 0;
+  while (zones < GEOFENCE_MAX_ZONES && (uint64_t)zones * GEOFENCE_GRID * GEOFENCE_GRID <= GEOFENCE_MAX_CELL_ENTRIES) {
+    fence->addZone((uint16_t)zones, lat, lon, 4);
+    zones++;
+  }
+  bool fits = (uint64_t)zones * GEOFENCE_GRID * GEOFENCE_GRID <= GEOFENCE_MAX_CELL_ENTRIES;
+  printf("  %u zonas, %llu pares para %d entradas\n", zones,
+         (unsigned long long)zones * GEOFENCE_GRID * GEOFENCE_GRID, GEOFENCE_MAX_CELL_ENTRIES);
+  check(fence->build() == fits, "build() falla si no cabe");
+  check(fence->findZone(40.05f, -2.95f) == (fits ? 0 : -1), "sin índice no hay zona válida");
+}
+
+int main(int argc, char **argv) {
+  uint32_t zones = argc > 1 ? (uint32_t)atoi(argv[1]) : 4000;
+  size_t fixes = argc > 2 ? (size_t)atol(argv[2]) : 2000000;
+  if (zones > GEOFENCE_MAX_ZONES) zones = GEOFENCE_MAX_ZONES;
+  testIndex(zones, fixes);
+  testOverflow();
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
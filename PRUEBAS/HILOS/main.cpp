@@ -0,0 +1,116 @@
+// Prueba de pollBus() desde dos hilos: dos controladores emulados
+// (COMP_BUS_MOCK), cada uno con su sitio MAX30102 + SHT31 a un ritmo
+// distinto, atendidos a la vez por un hilo cada uno, como dos tareas en el
+// ESP32. Cada hilo alimenta su chip a 100 Hz en tiempo real y sondea su bus
+// sin pausa. Comprueba que cada canal procesa exactamente las muestras de
+// su chip y mide su propio ritmo, sin mezclar datos del otro bus.
+// Con -fsanitize=thread el mismo programa señala cualquier acceso
+// compartido entre los dos pollBus().
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -pthread -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o hilos
+//
+// Uso:
+//   ./hilos [segundos]    (8 por defecto; el ritmo necesita unos 6 s de señal)
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+
+typedef SensorChannelsT<MockBus> Channels;
+
+static const uint8_t MAX30102_ADDR = 0x57;
+static const uint8_t SHT31_ADDR = 0x44;
+static const uint8_t BUSES = 2;
+static const float BPM[BUSES] = {60.0f, 96.0f};
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Un controlador con su sitio; solo lo toca el hilo que lo atiende
+struct Site {
+  MockI2CBus bus;
+  MockMAX30102 chip;
+  MockSHT31 climateChip;
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  SHT31T<MockBus> climate{MockBus(bus)};
+  uint32_t pushed = 0;
+  uint32_t polls = 0;
+
+  Site() {
+    bus.addDevice(MAX30102_ADDR, &chip);
+    bus.addDevice(SHT31_ADDR, &climateChip);
+  }
+};
+
+// Alimenta el chip al ritmo real de PROFILE_STANDARD y sondea el bus entre
+// muestra y muestra
+static void serve(Channels &channels, Site &site, uint8_t b, float bpm, uint32_t seconds) {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  Clock::time_point end = start + std::chrono::seconds(seconds);
+  Clock::time_point next = start;
+  while (Clock::now() < end) {
+    if (Clock::now() >= next) {
+      double phase = 2.0 * M_PI * bpm / 60.0 * site.pushed / 100.0;
+      double ir = 50000.0 + 1500.0 * sin(phase) + 500.0 * sin(2.0 * phase);
+      site.chip.pushSample((uint32_t)(0.8 * ir), (uint32_t)ir);
+      site.pushed++;
+      next += std::chrono::milliseconds(10);
+    }
+    channels.pollBus(b, 5000);
+    site.polls++;
+    std::this_thread::yield();
+  }
+}
+
+int main(int argc, char **argv) {
+  uint32_t seconds = (argc > 1) ? (uint32_t)atoi(argv[1]) : 8;
+  Site sites[BUSES];
+  Channels channels;
+  for (uint8_t b = 0; b < BUSES; b++) {
+    sites[b].climateChip.setClimate(20.0f + 10.0f * b, 40.0f + 10.0f * b);
+    channels.addChannel(&sites[b].pulse, &sites[b].climate, b);
+  }
+  check(channels.beginAll() == BUSES, "beginAll() levanta los dos canales");
+
+  printf("Dos hilos, %u s\n", seconds);
+  std::thread workers[BUSES];
+  for (uint8_t b = 0; b < BUSES; b++) {
+    workers[b] = std::thread(serve, std::ref(channels), std::ref(sites[b]), b, BPM[b], seconds);
+  }
+  for (uint8_t b = 0; b < BUSES; b++) workers[b].join();
+  // Lo que quede en los FIFO, ya sin concurrencia
+  channels.poll(5000);
+
+  bool counted = true, measured = true, climate = true;
+  for (uint8_t b = 0; b < BUSES; b++) {
+    float t = 0.0f, h = 0.0f;
+    bool okClimate = channels.readClimate(b, t, h);
+    printf("  bus %u: %u muestras, %u procesadas, %u sondeos, %.1f lpm (%.0f), %.1f °C\n", b,
+           sites[b].pushed, channels.getSampleCount(b), sites[b].polls, channels.getBPM(b),
+           BPM[b], t);
+    counted &= channels.getSampleCount(b) == sites[b].pushed;
+    measured &= fabsf(channels.getBPM(b) - BPM[b]) < 0.05f * BPM[b];
+    climate &= okClimate && fabsf(t - (20.0f + 10.0f * b)) < 0.1f;
+  }
+  check(counted, "cada canal procesa exactamente las muestras de su chip");
+  check(measured, "cada canal mide el ritmo de su sitio");
+  check(climate, "el clima de cada bus llega a su canal");
+
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
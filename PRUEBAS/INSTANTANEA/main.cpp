@@ -0,0 +1,134 @@
+// Prueba de carga de COMP_INSTANTANEA: un hilo escritor publica sin pausa
+// en un VitalsBoard mientras varios lectores copian la instantánea y
+// comprueban que ningún campo mezcla dos publicaciones (lectura rota) y
+// que la versión nunca retrocede. Informa de publicaciones y lecturas por
+// segundo. También recorre la vuelta del número de secuencia de 32 bits.
+//
+// Compilación (Linux):
+//   g++ -std=c++11 -O2 -pthread -I../../SISTEMA/LIB_SISTEMA main.cpp
+//       ../../SISTEMA/LIB_SISTEMA/COMP_INSTANTANEA.cpp -o instantanea
+//
+// Uso:
+//   ./instantanea [segundos] [lectores]
+// Devuelve 1 si hay alguna lectura rota o la secuencia falla.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "COMP_INSTANTANEA.h"
+
+struct ReaderStats {
+  uint64_t reads;
+  uint64_t torn;
+  uint64_t backwards;
+  uint64_t empty;
+};
+
+// Todos los campos de la publicación n se derivan de n (con dedo y ritmo
+// válido, para que updatePulse() marque también pulseMs)
+static void stage(VitalsBoard &board, uint32_t n) {
+  board.updatePulse(float(n % 1000 + 1), uint8_t(n), uint8_t(n >> 8), true, n);
+  board.updateClimate(float(n) * 0.5f, float(n) * 0.25f, n);
+  board.updateLocation(double(n) * 1e-3, -double(n) * 1e-3, n);
+}
+
+static bool consistent(const VitalsSnapshot &s) {
+  uint32_t n = s.publishedMs;
+  return s.pulseMs == (n ? n : 1) && s.climateMs == (n ? n : 1) && s.locationMs == (n ? n : 1) &&
+         s.bpm == float(n % 1000 + 1) && s.spo2 == uint8_t(n) && s.quality == uint8_t(n >> 8) &&
+         s.fingerPresent &&
+         s.temperature == float(n) * 0.5f && s.humidity == float(n) * 0.25f &&
+         s.latitude == double(n) * 1e-3 && s.longitude == -double(n) * 1e-3 &&
+         s.channel == 3;
+}
+
+// La secuencia da la vuelta tras 2^31 publicaciones (de 0xFFFFFFFE a 2):
+// ninguna lectura debe fallar en ese punto
+static bool sequenceWrap() {
+  SeqLock<uint32_t> lock;
+  uint32_t value = 0;
+  bool ok = true;
+  for (uint64_t i = 1; i <= (1ull << 31) + 2; i++) {
+    lock.store(uint32_t(i));
+    if ((i & 0xFFFFF) != 0 && i < (1ull << 31) - 2) continue;
+    uint32_t seq = lock.load(value, 1);
+    ok &= seq != 0 && (seq & 1) == 0 && value == uint32_t(i);
+  }
+  return ok && lock.version() == 6;
+}
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+  unsigned readers = argc > 2 ? (unsigned)atoi(argv[2]) : 3;
+  int failures = 0;
+
+  printf("Vuelta de la secuencia (2^31 publicaciones)\n");
+  bool wrap = sequenceWrap();
+  printf("  lectura válida en 0xFFFFFFFE -> 2             %s\n", wrap ? "OK" : "FALLO");
+  if (!wrap) failures++;
+
+  VitalsBoard board;
+  board.begin(3);
+  VitalsSnapshot snap;
+  bool empty = !board.read(snap);
+  printf("  sin publicar, read() devuelve false           %s\n", empty ? "OK" : "FALLO");
+  if (!empty) failures++;
+
+  printf("Carga: 1 escritor, %u lectores, %.1f s\n", readers, seconds);
+  std::atomic<bool> stop(false);
+  std::vector<ReaderStats> stats(readers);
+  std::vector<std::thread> threads;
+  for (unsigned r = 0; r < readers; r++) {
+    threads.emplace_back([&, r]() {
+      ReaderStats st = {0, 0, 0, 0};
+      uint32_t lastVersion = 0;
+      VitalsSnapshot s;
+      while (!stop.load(std::memory_order_relaxed)) {
+        if (!board.read(s)) {
+          st.empty++;
+          continue;
+        }
+        st.reads++;
+        if (!consistent(s)) st.torn++;
+        if (s.version < lastVersion) st.backwards++;
+        lastVersion = s.version;
+      }
+      stats[r] = st;
+    });
+  }
+
+  uint64_t writes = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (int i = 0; i < 1000; i++) {
+      uint32_t n = uint32_t(++writes);
+      stage(board, n);
+      board.publish(n);
+    }
+  }
+  stop = true;
+  for (auto &t : threads) t.join();
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  ReaderStats total = {0, 0, 0, 0};
+  for (const auto &st : stats) {
+    total.reads += st.reads;
+    total.torn += st.torn;
+    total.backwards += st.backwards;
+    total.empty += st.empty;
+  }
+  printf("  publicaciones: %.2f M/s\n", writes / elapsed / 1e6);
+  printf("  lecturas:      %.2f M/s (%.2f M/s por lector)\n",
+         total.reads / elapsed / 1e6, total.reads / elapsed / 1e6 / (readers ? readers : 1));
+  printf("  rotas: %llu, versión hacia atrás: %llu, vacías: %llu\n",
+         (unsigned long long)total.torn, (unsigned long long)total.backwards,
+         (unsigned long long)total.empty);
+  if (total.torn || total.backwards || (readers && total.reads == 0)) failures++;
+
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
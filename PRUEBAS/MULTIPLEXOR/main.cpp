@@ -0,0 +1,175 @@
+// Prueba de canales detrás de un multiplexor TCA9548A sobre el bus emulado
+// (COMP_BUS_MOCK): tres sitios con las mismas direcciones I2C en los
+// puertos 0..2 de un multiplexor y un cuarto sitio directo en el segundo
+// controlador. Comprueba que select() aísla cada puerto, que no repite
+// escrituras redundantes y que muestras y clima llegan a su canal. Con el
+// reloj avanzando solo en las transacciones emuladas comprueba además que
+// el presupuesto de pollBus() y getBusTimeUs() cuentan tiempo de bus y no
+// el del procesamiento.
+// El reloj es simulado (PLATFORM_SIMULATED_TIME): 20 s de señal corren en
+// unos milisegundos.
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -DPLATFORM_SIMULATED_TIME -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o multiplexor
+//
+// Uso:
+//   ./multiplexor
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+
+typedef SensorChannelsT<MockBus> Channels;
+
+static const uint8_t MUX_SITES = 3;
+static const uint8_t SITES = MUX_SITES + 1;
+static const uint8_t MAX30102_ADDR = 0x57;
+static const uint8_t SHT31_ADDR = 0x44;
+static const uint8_t MUX_ADDR = 0x70;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Lectura directa del registro PART_ID: indica si hay un MAX30102 visible
+static bool pulseVisible(MockI2CBus &bus) {
+  uint8_t reg = 0xFF, id = 0;
+  return bus.writeRead(MAX30102_ADDR, &reg, 1, &id, 1) && id == 0x15;
+}
+
+int main() {
+  MockI2CBus bus0, bus1;
+  MockTCA9548A muxChip(bus0);
+  MockMAX30102 pulseChip[SITES];
+  MockSHT31 climateChip[SITES];
+
+  bus0.addDevice(MUX_ADDR, &muxChip);
+  for (uint8_t p = 0; p < MUX_SITES; p++) {
+    bus0.addDevice(MAX30102_ADDR, &pulseChip[p], p);
+    bus0.addDevice(SHT31_ADDR, &climateChip[p], p);
+  }
+  bus1.addDevice(MAX30102_ADDR, &pulseChip[MUX_SITES]);
+  bus1.addDevice(SHT31_ADDR, &climateChip[MUX_SITES]);
+
+  TCA9548AT<MockBus> mux{MockBus(bus0)};
+  MAX30102T<MockBus> pulse[SITES] = {
+    MAX30102T<MockBus>{MockBus(bus0)}, MAX30102T<MockBus>{MockBus(bus0)},
+    MAX30102T<MockBus>{MockBus(bus0)}, MAX30102T<MockBus>{MockBus(bus1)}};
+  SHT31T<MockBus> climate[SITES] = {
+    SHT31T<MockBus>{MockBus(bus0)}, SHT31T<MockBus>{MockBus(bus0)},
+    SHT31T<MockBus>{MockBus(bus0)}, SHT31T<MockBus>{MockBus(bus1)}};
+
+  printf("Selección de puertos\n");
+  check(mux.begin(), "begin() del multiplexor");
+  check(!pulseVisible(bus0), "sin puerto seleccionado no hay MAX30102 visible");
+  bool isolated = true;
+  for (uint8_t p = 0; p < MUX_SITES; p++) {
+    isolated &= mux.select(p) && mux.getSelectedPort() == p;
+    uint8_t reg = 0xFF, mask = 0;
+    isolated &= bus0.writeRead(MUX_ADDR, &reg, 0, &mask, 1) && mask == (1 << p);
+    isolated &= pulseVisible(bus0);
+  }
+  check(isolated, "select(p) habilita sólo el puerto p");
+  uint32_t before = bus0.getTransactions();
+  mux.select(MUX_SITES - 1);
+  check(bus0.getTransactions() == before, "select() del puerto activo no escribe");
+  mux.disable();
+  check(!pulseVisible(bus0) && mux.getSelectedPort() == TCA9548AT<MockBus>::NO_PORT,
+        "disable() deja todos los puertos cerrados");
+
+  Channels channels;
+  bool added = true;
+  for (uint8_t p = 0; p < MUX_SITES; p++) {
+    added &= channels.addChannel(&pulse[p], &climate[p], 0, &mux, p) == p;
+  }
+  added &= channels.addChannel(&pulse[MUX_SITES], &climate[MUX_SITES], 1) == MUX_SITES;
+  check(added, "cuatro canales registrados");
+
+  printf("Arranque\n");
+  check(channels.beginAll() == SITES, "beginAll() levanta los cuatro canales");
+  bool configured = true;
+  for (uint8_t s = 0; s < SITES; s++) {
+    // MODE_CONFIG: modo SpO2 escrito en el chip de cada sitio
+    configured &= (pulseChip[s].getRegister(0x09) & 0x07) == 0x03;
+  }
+  check(configured, "cada MAX30102 configurado a través de su puerto");
+
+  printf("Lecturas por canal\n");
+  // Cada sitio late a un ritmo distinto y tiene su propio clima
+  const float bpm[SITES] = {60.0f, 75.0f, 90.0f, 110.0f};
+  for (uint8_t s = 0; s < SITES; s++) climateChip[s].setClimate(20.0f + s, 40.0f + 5.0f * s);
+
+  uint32_t pushed[SITES] = {0};
+  for (uint32_t k = 0; k < 2000; k++) {   // 20 s a 100 Hz
+    for (uint8_t s = 0; s < SITES; s++) {
+      double phase = 2.0 * M_PI * bpm[s] / 60.0 * k / 100.0;
+      double ir = 50000.0 + 1500.0 * sin(phase) + 500.0 * sin(2.0 * phase);
+      pulseChip[s].pushSample((uint32_t)(0.8 * ir), (uint32_t)ir);
+      pushed[s]++;
+    }
+    channels.poll(5000);
+    delay(10);
+  }
+
+  bool samples = true, rates = true;
+  for (uint8_t s = 0; s < SITES; s++) {
+    samples &= channels.getSampleCount(s) == pushed[s];
+    float got = channels.getBPM(s);
+    printf("  canal %u: %u muestras, %.1f lpm (esperado %.0f)\n",
+           s, channels.getSampleCount(s), got, bpm[s]);
+    rates &= fabsf(got - bpm[s]) < 0.05f * bpm[s];
+  }
+  check(samples, "cada canal recibe todas las muestras de su chip");
+  check(rates, "el ritmo de cada canal es el de su chip");
+
+  bool climateOk = true;
+  for (uint8_t s = 0; s < SITES; s++) {
+    float t = 0, h = 0;
+    bool ok = channels.readClimate(s, t, h);
+    printf("  canal %u: %.2f °C, %.1f %%HR\n", s, t, h);
+    climateOk &= ok && fabsf(t - (20.0f + s)) < 0.05f && fabsf(h - (40.0f + 5.0f * s)) < 0.1f;
+    if (s < MUX_SITES) climateOk &= mux.getSelectedPort() == s;
+  }
+  check(climateOk, "el clima de cada canal es el de su SHT31");
+
+  printf("Tiempo de bus: controlador 0 %llu us, controlador 1 %llu us\n",
+         (unsigned long long)bus0.getBusTimeUs(), (unsigned long long)bus1.getBusTimeUs());
+
+  printf("Presupuesto de tiempo de bus\n");
+  // El procesamiento no mueve el reloj simulado: todo lo que mide pollBus()
+  // como bus debe ser tiempo de transacción del controlador emulado
+  bus0.setAdvanceClock(true);
+  for (uint8_t s = 0; s < MUX_SITES; s++) {
+    for (uint8_t i = 0; i < 20; i++) pulseChip[s].pushSample(40000, 50000);
+  }
+  uint32_t counts[MUX_SITES];
+  for (uint8_t s = 0; s < MUX_SITES; s++) counts[s] = channels.getSampleCount(s);
+  uint64_t mockUs = bus0.getBusTimeUs();
+  uint32_t chUs = channels.getBusTimeUs(0), dspUs = channels.getDspTimeUs(0);
+  channels.pollBus(0, 1);
+  uint8_t drained = 0;
+  for (uint8_t s = 0; s < MUX_SITES; s++) drained += channels.getSampleCount(s) != counts[s];
+  uint32_t spent = channels.getBusTimeUs(0) - chUs;
+  printf("  presupuesto 1 us: %u canal(es) atendidos, %u us de bus\n", drained, spent);
+  check(drained == 1, "agotado el presupuesto no se atiende otro canal");
+  check(spent == bus0.getBusTimeUs() - mockUs, "el tiempo contado es el de las transacciones");
+  mockUs = bus0.getBusTimeUs();
+  chUs = channels.getBusTimeUs(0);
+  channels.pollBus(0, 5000);
+  spent = channels.getBusTimeUs(0) - chUs;
+  printf("  presupuesto 5000 us: %u us de bus\n", spent);
+  check(spent == bus0.getBusTimeUs() - mockUs && channels.getDspTimeUs(0) == dspUs,
+        "el procesamiento no se carga al bus");
+  bus0.setAdvanceClock(false);
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
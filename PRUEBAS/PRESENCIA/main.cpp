@@ -0,0 +1,189 @@
+// Prueba de la detección de presencia (COMP_PRESENCIA) sobre el bus emulado
+// (COMP_BUS_MOCK): un canal con la detección activada debe quedarse en
+// reposo (PROFILE_PRESENCE, LED rojo apagado, una lectura cada 640 ms)
+// mientras no hay dedo, despertar al ponerlo, medir el pulso y volver al
+// reposo IDLE_DELAY_MS después de quitarlo. Un destello aislado despierta
+// el canal pero no debe dejarlo activo. Compara además el tráfico de bus
+// en reposo y en adquisición.
+// El chip emulado entrega muestras al ritmo de la configuración escrita en
+// sus registros: 100 Hz con PROFILE_STANDARD y una cada 640 ms en reposo.
+//
+// Compilación (Linux):
+//   S=../../SENSORES; L="$S/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -DPLATFORM_SIMULATED_TIME -I../../SISTEMA/LIB_SISTEMA
+//       -I"$L" -I"$S/SENSOR SHT31/LIB_SHT31" -I"$S/MODULO MUX TCA9548A/LIB_TCA9548A"
+//       main.cpp "$L"/*.cpp "$S/SENSOR SHT31/LIB_SHT31/LIB_SHT31.cpp"
+//       ../../SISTEMA/LIB_SISTEMA/COMP_ESTADISTICAS.cpp -o presencia
+//
+// Uso:
+//   ./presencia
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdio.h>
+#include "COMP_BUS_MOCK.h"
+#include "COMP_CANALES.h"
+
+typedef SensorChannelsT<MockBus> Channels;
+
+static const uint8_t MAX30102_ADDR = 0x57;
+static const uint8_t SHT31_ADDR = 0x44;
+static const float BPM = 72.0f;
+// REG_FIFO_CONFIG y REG_LED1_PA (LED rojo) vienen de LIB_MAX30102.h
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Dedo sobre el sensor o sensor al aire, con el chip al ritmo de su FIFO
+struct Site {
+  MockMAX30102 chip;
+  bool finger = false;
+  bool flash = false;        // una sola muestra brillante
+  uint32_t beat = 0;         // muestras de pulso generadas
+  uint32_t nextMs = 0;
+
+  // SMP_AVE = 32 (FIFO_CONFIG[7:5] = 5) es el perfil de presencia
+  uint32_t periodMs() const {
+    return ((chip.getRegister(REG_FIFO_CONFIG) >> 5) == 5) ? 640 : 10;
+  }
+
+  void tick(uint32_t now) {
+    if ((int32_t)(now - nextMs) < 0) return;
+    nextMs = now + periodMs();
+    if (flash) {
+      flash = false;
+      chip.pushSample(40000, 50000);
+      return;
+    }
+    if (!finger) {
+      chip.pushSample(400, 500);   // luz ambiente
+      return;
+    }
+    double phase = 2.0 * M_PI * BPM / 60.0 * beat++ / 100.0;
+    double ir = 50000.0 + 1500.0 * sin(phase) + 500.0 * sin(2.0 * phase);
+    chip.pushSample((uint32_t)(0.8 * ir), (uint32_t)ir);
+  }
+};
+
+struct Bench {
+  MockI2CBus bus;
+  Site site;
+  MockSHT31 climateChip;
+  MAX30102T<MockBus> pulse{MockBus(bus)};
+  SHT31T<MockBus> climate{MockBus(bus)};
+  Channels channels;
+
+  Bench() {
+    bus.addDevice(MAX30102_ADDR, &site.chip);
+    bus.addDevice(SHT31_ADDR, &climateChip);
+    channels.addChannel(&pulse, &climate);
+  }
+
+  PresenceState state() const { return channels.getPresence(0).getState(); }
+
+  // Avanza ms en pasos de 10 ms; devuelve el tiempo hasta el primer paso en
+  // el estado indicado (o ms si no llega)
+  uint32_t run(uint32_t ms, int until = -1) {
+    uint32_t reached = ms;
+    for (uint32_t t = 0; t < ms; t += 10) {
+      site.tick(millis());
+      channels.poll(5000);
+      if (until >= 0 && reached == ms && state() == (PresenceState)until) reached = t;
+      delay(10);
+    }
+    return reached;
+  }
+};
+
+int main() {
+  Bench b;
+  b.channels.setPresenceDetection(true);
+  uint32_t start = millis();
+
+  printf("Arranque sin dedo\n");
+  check(b.channels.beginAll() == 1, "beginAll() levanta el canal");
+  check(b.state() == PRESENCE_IDLE, "con la detección activa arranca en reposo");
+  check(b.site.periodMs() == 640, "el chip queda con PROFILE_PRESENCE");
+  check(b.site.chip.getRegister(REG_LED1_PA) == 0, "LED rojo apagado en reposo");
+
+  printf("Reposo, 30 s sin dedo\n");
+  uint32_t tx = b.bus.getTransactions();
+  uint64_t busUs = b.bus.getBusTimeUs();
+  b.run(30000);
+  uint32_t idleTx = b.bus.getTransactions() - tx;
+  uint64_t idleBusUs = b.bus.getBusTimeUs() - busUs;
+  printf("  %u transacciones, %llu us de bus\n", idleTx, (unsigned long long)idleBusUs);
+  check(b.state() == PRESENCE_IDLE, "sigue en reposo");
+  check(b.channels.getPresence(0).getWakeCount() == 0, "ningún despertar");
+  check(b.channels.getSampleCount(0) == 0, "sin muestras para el DSP");
+  check(b.channels.isDeviceOnline(0, DEVICE_PULSE), "el sensor no se da por perdido");
+  // Una lectura por periodo del FIFO de presencia (más el clima)
+  check(idleTx < 30000 / PresenceMonitor::CHECK_INTERVAL_MS * 4 + 100,
+        "tráfico de bus acotado al ritmo de comprobación");
+
+  printf("Dedo, 20 s\n");
+  b.site.finger = true;
+  uint32_t wake = b.run(20000, PRESENCE_ACTIVE);
+  printf("  despierta en %u ms, %u muestras, %.1f lpm\n",
+         wake, b.channels.getSampleCount(0), b.channels.getBPM(0));
+  check(wake <= PresenceMonitor::CHECK_INTERVAL_MS + 20, "despierta en un periodo de comprobación");
+  check(b.state() == PRESENCE_ACTIVE && b.channels.isFingerPresent(0), "activo con dedo");
+  check(b.channels.getPresence(0).getWakeCount() == 1, "un despertar");
+  check(b.site.periodMs() == 10 && b.site.chip.getRegister(REG_LED1_PA) != 0,
+        "vuelve al perfil de adquisición con el LED rojo");
+  check(fabsf(b.channels.getBPM(0) - BPM) < 0.05f * BPM, "mide el pulso tras despertar");
+
+  printf("Sin dedo otra vez\n");
+  b.site.finger = false;
+  uint32_t sleep = b.run(10000, PRESENCE_IDLE);
+  printf("  vuelve al reposo en %u ms\n", sleep);
+  check(b.state() == PRESENCE_IDLE, "vuelve al reposo");
+  // El último latido con dedo es de un paso antes de quitarlo
+  check(sleep + 10 >= PresenceMonitor::IDLE_DELAY_MS && sleep <= PresenceMonitor::IDLE_DELAY_MS + 2000,
+        "tras IDLE_DELAY_MS sin dedo");
+  check(b.site.chip.getRegister(REG_LED1_PA) == 0, "LED rojo apagado de nuevo");
+
+  printf("Destello aislado\n");
+  b.run(2000);
+  b.site.flash = true;
+  b.run(PresenceMonitor::IDLE_DELAY_MS + 2000);
+  check(b.channels.getPresence(0).getWakeCount() == 2, "un destello despierta el canal");
+  check(b.state() == PRESENCE_IDLE, "sin dedo confirmado vuelve al reposo");
+
+  printf("Contabilidad\n");
+  const PresenceMonitor &pm = b.channels.getPresence(0);
+  uint32_t now = millis();
+  uint32_t idleMs = pm.getTimeMs(PRESENCE_IDLE, now), activeMs = pm.getTimeMs(PRESENCE_ACTIVE, now);
+  printf("  reposo %u ms, activo %u ms\n", idleMs, activeMs);
+  check(idleMs + activeMs == now - start, "reposo + activo = tiempo transcurrido");
+  check(activeMs >= 20000 && activeMs < 20000 + 2 * (PresenceMonitor::IDLE_DELAY_MS + 2000),
+        "tiempo activo: el del dedo más las esperas");
+
+  printf("Tráfico de bus por segundo\n");
+  b.site.finger = true;
+  b.run(2000);
+  tx = b.bus.getTransactions();
+  busUs = b.bus.getBusTimeUs();
+  b.run(10000);
+  uint32_t activeTx = b.bus.getTransactions() - tx;
+  uint64_t activeBusUs = b.bus.getBusTimeUs() - busUs;
+  printf("  reposo: %.1f transacciones/s, %.0f us/s\n", idleTx / 30.0, idleBusUs / 30.0);
+  printf("  activo: %.1f transacciones/s, %.0f us/s\n", activeTx / 10.0, activeBusUs / 10.0);
+  check(idleBusUs / 30.0 * 10 < activeBusUs / 10.0, "en reposo el bus trabaja al menos 10 veces menos");
+
+  printf("Detección desactivada\n");
+  b.site.finger = false;
+  b.run(PresenceMonitor::IDLE_DELAY_MS + 2000);
+  check(b.state() == PRESENCE_IDLE, "en reposo antes de desactivar");
+  b.channels.setPresenceDetection(false);
+  check(b.state() == PRESENCE_ACTIVE && b.site.periodMs() == 10, "desactivar vuelve a adquisición");
+  b.run(10000);
+  check(b.state() == PRESENCE_ACTIVE, "sin detección no vuelve al reposo");
+
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+// Prueba de la variabilidad cardiaca (COMP_VARIABILIDAD): reproduce series
+// de intervalos entre latidos (IBI) por HRVProcessor y compara, latido a
+// latido, qué intervalos se aceptan y los SDNN, RMSSD y pNN50 de la ventana
+// con un cálculo de referencia que recorre la ventana entera en doble
+// precisión. Mide además el coste por latido.
+// Sin argumentos usa series sintéticas (reposo, ejercicio con deriva,
+// latidos perdidos y extra, ventanas corta y larga); con ficheros de IBI (un
+// intervalo en ms por línea, p. ej. exportados de un registro de referencia)
+// reproduce también esos registros.
+//
+// Compilación (Linux):
+//   L="../../SENSORES/SENSOR MAX30102/LIB_MAX30102"
+//   g++ -std=c++11 -O2 -I"$L" main.cpp "$L/COMP_VARIABILIDAD.cpp" -o variabilidad
+//
+// Uso:
+//   ./variabilidad [ibi.txt ...]
+// Devuelve 1 si alguna comprobación falla.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <vector>
+#include "COMP_VARIABILIDAD.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "OK" : "FALLO");
+  if (!ok) failures++;
+}
+
+// Referencia: misma regla de rechazo que COMP_VARIABILIDAD.h (40..180 bpm,
+// como mucho un 20 % respecto al último aceptado, se re-siembra tras tres
+// rechazos seguidos) y la ventana guardada entera
+class Reference {
+public:
+  explicit Reference(uint32_t windowMs) : windowMs(windowMs) {}
+
+  bool add(uint32_t ibi, uint32_t ts) {
+    bool ok = ibi >= 333 && ibi <= 1500;
+    if (ok && reference > 0) ok = fabs((double)ibi - reference) / reference <= 0.2;
+    if (!ok) {
+      chained = false;
+      if (++rejects >= 3) reference = 0;
+      return false;
+    }
+    rejects = 0;
+    while (!beats.empty() &&
+           (beats.size() >= HRV_MAX_BEATS || ts - beats.front().ts > windowMs)) {
+      beats.pop_front();
+      if (!beats.empty()) beats.front().diff = false;
+    }
+    Beat b = {ibi, ts, chained && !beats.empty()};
+    beats.push_back(b);
+    reference = ibi;
+    chained = true;
+    return true;
+  }
+
+  void gap() { chained = false; }
+
+  size_t count() const { return beats.size(); }
+  uint32_t newest() const { return beats.back().ibi; }
+
+  void stats(double &sdnn, double &rmssd, double &pnn50) const {
+    size_t n = beats.size();
+    double sum = 0.0, sq = 0.0, dsq = 0.0;
+    int diffs = 0, nn50 = 0;
+    for (size_t i = 0; i < n; i++) {
+      sum += beats[i].ibi;
+      if (!beats[i].diff) continue;
+      double d = (double)beats[i].ibi - beats[i - 1].ibi;
+      dsq += d * d;
+      diffs++;
+      if (fabs(d) > 50.0) nn50++;
+    }
+    double mean = n ? sum / n : 0.0;
+    for (size_t i = 0; i < n; i++) sq += (beats[i].ibi - mean) * (beats[i].ibi - mean);
+    sdnn = n > 1 ? sqrt(sq / (n - 1)) : 0.0;
+    rmssd = diffs ? sqrt(dsq / diffs) : 0.0;
+    pnn50 = diffs ? 100.0 * nn50 / diffs : 0.0;
+  }
+
+private:
+  struct Beat {
+    uint32_t ibi;
+    uint32_t ts;
+    bool diff;
+  };
+  std::deque<Beat> beats;
+  uint32_t windowMs;
+  uint32_t reference = 0;
+  bool chained = false;
+  int rejects = 0;
+};
+
+// Reproduce una serie de IBI; un 0 en la serie es un hueco (markGap())
+static void replay(const char *name, const std::vector<uint32_t> &ibis, uint32_t windowMs) {
+  printf("%s: %zu intervalos, ventana %u ms\n", name, ibis.size(), windowMs);
+  HRVProcessor hrv;
+  hrv.setWindow(windowMs);
+  Reference ref(windowMs);
+  uint32_t ts = 5000;
+  size_t accepted = 0, acceptMismatch = 0, countMismatch = 0;
+  double errSDNN = 0.0, errRMSSD = 0.0, errPNN50 = 0.0;
+  for (size_t i = 0; i < ibis.size(); i++) {
+    if (ibis[i] == 0) {
+      hrv.markGap();
+      ref.gap();
+      continue;
+    }
+    ts += ibis[i];
+    bool a = hrv.addInterval(ibis[i], ts);
+    if (a != ref.add(ibis[i], ts)) acceptMismatch++;
+    if (a) accepted++;
+    if (ref.count() == 0) continue;
+    if (hrv.getCount() != ref.count() || hrv.getInterval(0) != ref.newest()) countMismatch++;
+    double sdnn, rmssd, pnn50;
+    ref.stats(sdnn, rmssd, pnn50);
+    errSDNN = fmax(errSDNN, fabs(hrv.getSDNN() - sdnn));
+    errRMSSD = fmax(errRMSSD, fabs(hrv.getRMSSD() - rmssd));
+    errPNN50 = fmax(errPNN50, fabs(hrv.getPNN50() - pnn50));
+  }
+  double sdnn, rmssd, pnn50;
+  ref.stats(sdnn, rmssd, pnn50);
+  printf("  aceptados %zu, rechazados %u; final SDNN %.1f RMSSD %.1f pNN50 %.1f %%\n",
+         accepted, hrv.getRejectedCount(), sdnn, rmssd, pnn50);
+  printf("  error máximo: SDNN %.4f ms, RMSSD %.4f ms, pNN50 %.4f %%\n",
+         errSDNN, errRMSSD, errPNN50);
+  check(acceptMismatch == 0, "mismos intervalos aceptados que la referencia");
+  check(countMismatch == 0, "misma ventana (cuenta e intervalo más reciente)");
+  // Sumas enteras exactas: solo queda el redondeo del float final
+  check(errSDNN <= 0.01 && errRMSSD <= 0.01 && errPNN50 <= 0.001,
+        "SDNN, RMSSD y pNN50 iguales a la referencia");
+}
+
+// Reposo con arritmia respiratoria, deriva lenta de ritmo, latidos perdidos
+// (IBI doble), extra (IBI mitad) y algún hueco de señal
+static std::vector<uint32_t> synthetic(size_t n, float mean, float swing, float noise, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> jitter(0.0f, noise);
+  std::vector<uint32_t> v;
+  v.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    float base = mean + swing * sinf(i * 0.002f) + 40.0f * sinf(i * 0.25f);
+    int ibi = (int)(base + jitter(rng));
+    if (rng() % 50 == 0) ibi *= 2;
+    if (rng() % 70 == 0) ibi /= 2;
+    if (rng() % 500 == 0) v.push_back(0);
+    v.push_back(ibi > 0 ? (uint32_t)ibi : 1);
+  }
+  return v;
+}
+
+static bool load(const char *path, std::vector<uint32_t> &ibis) {
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[64];
+  while (fgets(line, sizeof(line), f)) {
+    char *end;
+    long ms = strtol(line, &end, 10);
+    if (end != line && ms >= 0) ibis.push_back((uint32_t)ms);
+  }
+  fclose(f);
+  return true;
+}
+
+static void bench() {
+  const uint32_t beats = 10000000;
+  HRVProcessor hrv;
+  uint32_t ts = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < beats; i++) {
+    uint32_t ibi = 800 + (i * 37 % 61) - 30;
+    ts += ibi;
+    hrv.addInterval(ibi, ts);
+  }
+  volatile float sink = hrv.getRMSSD() + hrv.getSDNN() + hrv.getPNN50();
+  (void)sink;
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("Rendimiento\n");
+  printf("  addInterval(): %.1f ns por latido (ventana de %u)\n", s / beats * 1e9, hrv.getCount());
+}
+
+int main(int argc, char **argv) {
+  replay("reposo", synthetic(200000, 900.0f, 150.0f, 25.0f, 1), HRV_WINDOW_MS);
+  replay("ejercicio", synthetic(200000, 500.0f, 120.0f, 15.0f, 2), HRV_WINDOW_MS);
+  // Ventana corta: el desalojo por tiempo manda sobre la capacidad del anillo
+  replay("ventana de 10 s", synthetic(50000, 800.0f, 200.0f, 30.0f, 3), 10000);
+  // Ventana de 2 min a 120 bpm: se llena el anillo de HRV_MAX_BEATS
+  replay("ventana de 2 min", synthetic(50000, 500.0f, 60.0f, 15.0f, 4), 120000);
+  for (int i = 1; i < argc; i++) {
+    std::vector<uint32_t> ibis;
+    if (!load(argv[i], ibis)) {
+      printf("%s: no se puede abrir\n", argv[i]);
+      failures++;
+      continue;
+    }
+    replay(argv[i], ibis, HRV_WINDOW_MS);
+  }
+  bench();
+  printf(failures ? "FALLO (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
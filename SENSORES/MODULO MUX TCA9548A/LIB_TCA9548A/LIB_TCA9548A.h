@@ -0,0 +1,94 @@
+#ifndef _TCA9548A_H_
+#define _TCA9548A_H_
+
+#include <stdint.h>
+#include "COMP_BUS.h"
+
+// Multiplexor I2C de 8 puertos sobre cualquier bus de COMP_BUS.h
+template <class Bus>
+class TCA9548AT {
+public:
+    // Direcciones I2C según pines A0..A2
+    static constexpr uint8_t ADDR_BASE = 0x70; // A2..A0 → GND
+    static constexpr uint8_t NUM_PORTS = 8;
+    static constexpr uint8_t NO_PORT   = 0xFF;
+
+    //(bus I2C y dirección opcionales)
+    TCA9548AT(Bus bus = Bus(), uint8_t addr = ADDR_BASE);
+
+    // Verifica que el multiplexor responde y desconecta todos los puertos
+    bool begin();
+
+    // Conecta un único puerto (0..7) al bus principal.
+    // No escribe en el bus si el puerto ya estaba seleccionado.
+    bool select(uint8_t port);
+
+    // Desconecta todos los puertos
+    bool disable();
+
+    // Puerto seleccionado actualmente (NO_PORT si ninguno)
+    uint8_t getSelectedPort() const;
+
+private:
+    Bus     _bus;
+    uint8_t _addr;
+    uint8_t _port;
+
+    static constexpr uint32_t MAX_CLOCK_HZ = 400000;
+
+    // Escribe el registro de control (un bit por puerto)
+    bool writeControl(uint8_t mask);
+};
+
+// Constructor
+template <class Bus>
+TCA9548AT<Bus>::TCA9548AT(Bus bus, uint8_t addr)
+  : _bus(bus), _addr(addr), _port(NO_PORT) {}
+
+// Inicia I2C y desconecta todos los puertos
+template <class Bus>
+bool TCA9548AT<Bus>::begin() {
+    _bus.attach(_addr, MAX_CLOCK_HZ, 0);
+    return disable();
+}
+
+// Selecciona un puerto del multiplexor
+template <class Bus>
+bool TCA9548AT<Bus>::select(uint8_t port) {
+    if (port >= NUM_PORTS) return false;
+    if (port == _port) return true;
+    if (!writeControl(1 << port)) {
+        _port = NO_PORT;
+        return false;
+    }
+    _port = port;
+    return true;
+}
+
+// Desconecta todos los puertos
+template <class Bus>
+bool TCA9548AT<Bus>::disable() {
+    if (!writeControl(0x00)) return false;
+    _port = NO_PORT;
+    return true;
+}
+
+template <class Bus>
+uint8_t TCA9548AT<Bus>::getSelectedPort() const {
+    return _port;
+}
+
+// Escribe el registro de control
+template <class Bus>
+bool TCA9548AT<Bus>::writeControl(uint8_t mask) {
+    return _bus.write(_addr, &mask, 1);
+}
+
+#ifdef ARDUINO
+#include "COMP_BUS_WIRE.h"
+
+// Multiplexor sobre Arduino Wire
+typedef TCA9548AT<WireBus> TCA9548A;
+#endif
+
+#endif // _TCA9548A_H_
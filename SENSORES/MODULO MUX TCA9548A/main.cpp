@@ -0,0 +1,31 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include "LIB_TCA9548A.h"
+
+TCA9548A mux;
+
+void setup() {
+  Serial.begin(115200);
+  delay(100);
+
+  if (!mux.begin()) {
+    Serial.println("Error: TCA9548A no encontrado.");
+    while (true) delay(1000);
+  }
+
+  // Escanea los dispositivos conectados a cada puerto
+  for (uint8_t port = 0; port < TCA9548A::NUM_PORTS; port++) {
+    mux.select(port);
+    Serial.printf("Puerto %u:", port);
+    for (uint8_t addr = 0x08; addr < 0x78; addr++) {
+      if (addr == TCA9548A::ADDR_BASE) continue;
+      Wire.beginTransmission(addr);
+      if (Wire.endTransmission() == 0) Serial.printf(" 0x%02X", addr);
+    }
+    Serial.println();
+  }
+  mux.disable();
+}
+
+void loop() {
+}
@@ -0,0 +1,126 @@
+#include "COMP_CALIDAD.h"
+
+SignalQuality::SignalQuality()
+    : score(0), perfusionIndex(0.0f), kurtosis(0.0f) {
+    reset();
+    resetStats();
+}
+
+void SignalQuality::reset() {
+    count = 0;
+    clipped = 0;
+    crossings = 0;
+    lastPositive = false;
+    mean = m2 = m3 = m4 = 0.0f;
+    minAC = maxAC = 0.0f;
+    sumDC = 0.0f;
+}
+
+void SignalQuality::add(float acIR, uint32_t rawIR, float dcIR) {
+    // Crossings of the running mean: the offset left while DC removal
+    // settles would otherwise hide them
+    bool positive = acIR >= mean;
+    if (count == 0) {
+        minAC = maxAC = acIR;
+    } else {
+        if (positive != lastPositive) crossings++;
+        if (acIR < minAC) minAC = acIR;
+        if (acIR > maxAC) maxAC = acIR;
+    }
+    lastPositive = positive;
+    if (rawIR >= SATURATION) clipped++;
+
+    // Central moments updated per sample (Welford, extended to the 3rd and
+    // 4th order): raw power sums would cancel in float when the AC
+    // component still carries an offset
+    float n1 = count;
+    float n = ++count;
+    float delta = acIR - mean;
+    float deltaN = delta / n;
+    float deltaN2 = deltaN * deltaN;
+    float term = delta * deltaN * n1;
+    mean += deltaN;
+    m4 += term * deltaN2 * (n * n - 3.0f * n + 3.0f) + 6.0f * deltaN2 * m2 - 4.0f * deltaN * m3;
+    m3 += term * deltaN * (n - 2.0f) - 3.0f * deltaN * m2;
+    m2 += term;
+    sumDC += dcIR;
+}
+
+uint8_t SignalQuality::evaluate(uint32_t durationMs) {
+    if (count < 2 || durationMs == 0) {
+        reset();
+        return score;
+    }
+    float n = count;
+    float quality = 1.0f;
+
+    // Clipping
+    float clippedFraction = clipped / n;
+    quality *= (clippedFraction >= MAX_CLIPPED) ? 0.0f : 1.0f - clippedFraction / MAX_CLIPPED;
+
+    // Perfusion index: too small is poor contact, too large is motion
+    float dc = sumDC / n;
+    perfusionIndex = (dc > 0.0f) ? 100.0f * (maxAC - minAC) / dc : 0.0f;
+    if (perfusionIndex < PI_MIN) quality *= penalty(perfusionIndex / PI_MIN);
+    else if (perfusionIndex > PI_MAX) quality *= penalty(PI_MAX / perfusionIndex);
+
+    // Kurtosis: (m4 / n) / (m2 / n)^2
+    if (m2 > 0.0f) {
+        kurtosis = n * m4 / (m2 * m2);
+        if (kurtosis > KURTOSIS_MAX) quality *= penalty(KURTOSIS_MAX / kurtosis);
+    } else {
+        kurtosis = 0.0f;
+        quality = 0.0f;   // flat
+    }
+
+    // Zero crossings: two per cycle, within the heart-rate band
+    float crossingHz = crossings * 500.0f / durationMs;
+    if (crossingHz < ZC_MIN_HZ) quality *= penalty(crossingHz / ZC_MIN_HZ);
+    else if (crossingHz > ZC_MAX_HZ) quality *= penalty(ZC_MAX_HZ / crossingHz);
+
+    score = (uint8_t)(quality * 100.0f + 0.5f);
+    windows++;
+    scoreSum += score;
+    if (score < MIN_SCORE) rejected++;
+    reset();
+    return score;
+}
+
+float SignalQuality::penalty(float ratio) const {
+    // Quadratic: half the limit (or twice it) already gives 0.25
+    return ratio * ratio;
+}
+
+uint16_t SignalQuality::getSampleCount() const {
+    return count;
+}
+
+uint8_t SignalQuality::getScore() const {
+    return score;
+}
+
+float SignalQuality::getPerfusionIndex() const {
+    return perfusionIndex;
+}
+
+float SignalQuality::getKurtosis() const {
+    return kurtosis;
+}
+
+uint32_t SignalQuality::getWindowCount() const {
+    return windows;
+}
+
+uint32_t SignalQuality::getRejectedCount() const {
+    return rejected;
+}
+
+float SignalQuality::getMeanScore() const {
+    return windows ? (float)scoreSum / windows : 0.0f;
+}
+
+void SignalQuality::resetStats() {
+    windows = 0;
+    rejected = 0;
+    scoreSum = 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef COMP_CALIDAD_H
+#define COMP_CALIDAD_H
+
+#include <stdint.h>
+
+/**
+ *  Signal quality index of a PPG window, accumulated in one pass as the
+ *  samples arrive: perfusion index, clipping, kurtosis and the rate of
+ *  crossings of its running mean by the IR AC component. Each check maps to a factor in [0, 1]
+ *  and the score is 100 times their product.
+ */
+class SignalQuality {
+public:
+    // Constructor
+    SignalQuality();
+
+    // Discard the samples of the current window (statistics are kept)
+    void reset();
+
+    /**
+     *  Add one sample to the current window.
+     *  @param acIR   IR value after DC removal
+     *  @param rawIR  Raw IR value (clipping)
+     *  @param dcIR   Current IR DC estimate (perfusion index)
+     */
+    void add(float acIR, uint32_t rawIR, float dcIR);
+
+    /**
+     *  Score the current window and start the next one.
+     *  @param durationMs  Time covered by the window
+     *  @return Score 0-100; below MIN_SCORE the window should be skipped
+     */
+    uint8_t evaluate(uint32_t durationMs);
+
+    // Samples in the current window
+    uint16_t getSampleCount() const;
+
+    // Last evaluated window
+    uint8_t getScore() const;
+    float getPerfusionIndex() const;   // peak-to-peak AC / DC, in %
+    float getKurtosis() const;         // m4 / m2^2 of the IR AC component
+
+    // Windows evaluated and rejected since resetStats()
+    uint32_t getWindowCount() const;
+    uint32_t getRejectedCount() const;
+    float getMeanScore() const;
+    void resetStats();
+
+    static constexpr uint8_t  MIN_SCORE   = 50;
+    static constexpr uint32_t SATURATION  = 0x3FFFF - 1024;
+    static constexpr float    MAX_CLIPPED = 0.05f;  // fraction giving 0
+    static constexpr float    PI_MIN      = 0.05f;  // % (poor contact)
+    static constexpr float    PI_MAX      = 20.0f;  // % (motion)
+    static constexpr float    KURTOSIS_MAX = 5.0f;  // spiky artifacts above
+    static constexpr float    ZC_MIN_HZ   = 0.5f;   // crossing pairs per second
+    static constexpr float    ZC_MAX_HZ   = 4.0f;
+
+private:
+    // Current window
+    uint16_t count;
+    uint16_t clipped;
+    uint16_t crossings;
+    bool     lastPositive;
+    float    mean, m2, m3, m4;        // sums of powers of x - mean
+    float    minAC, maxAC;
+    float    sumDC;
+
+    // Last window and statistics
+    uint8_t  score;
+    float    perfusionIndex;
+    float    kurtosis;
+    uint32_t windows;
+    uint32_t rejected;
+    uint32_t scoreSum;
+
+    // Factor of a metric out of its range; ratio = limit / value (< 1)
+    float penalty(float ratio) const;
+};
+
+#endif // COMP_CALIDAD_H
\ No newline at end of file
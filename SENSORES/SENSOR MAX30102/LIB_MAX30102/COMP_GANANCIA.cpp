@@ -0,0 +1,196 @@
+#include "COMP_GANANCIA.h"
+#include <math.h>
+
+// LED pulse width in µs per PW_CODE_*
+static const uint16_t PULSE_WIDTH_US[4] = { 69, 118, 215, 411 };
+
+LedGainControl::LedGainControl()
+    : refAmplitude(0), refRange(0), redAmplitude(0), irAmplitude(0), adcRange(0),
+      redStep(1.0f), irStep(1.0f), settleUntilMs(0), pulseWidthCode(0), sampleAverageCode(0),
+      energyPerSampleNJ(0) {
+    startInterval(0);
+    resetStats();
+}
+
+void LedGainControl::begin(const AcquisitionProfile &profile, uint32_t nowMs) {
+    refAmplitude = profile.ledAmplitude;
+    refRange = profile.adcRangeCode;
+    redAmplitude = irAmplitude = profile.ledAmplitude;
+    adcRange = profile.adcRangeCode;
+    pulseWidthCode = profile.pulseWidthCode;
+    sampleAverageCode = profile.sampleAverageCode;
+    redStep = irStep = 1.0f;
+    settleUntilMs = nowMs;
+    startInterval(nowMs);
+    updateEnergyPerSample();
+}
+
+bool LedGainControl::update(uint32_t rawRed, uint32_t rawIR, bool valid, uint32_t nowMs) {
+    // Energy is spent on every sample, useful or not
+    energyNJ += energyPerSampleNJ;
+    bool saturated = rawRed >= SATURATION || rawIR >= SATURATION;
+    if (saturated) saturatedSamples++;
+    else if (valid) validSamples++;
+
+    // Samples converted before the last step, or during its transient
+    if ((int32_t)(nowMs - settleUntilMs) < 0) {
+        intervalStartMs = nowMs;
+        return false;
+    }
+    sumRed += rawRed;
+    sumIR += rawIR;
+    intervalCount++;
+    if (rawRed >= SATURATION) intervalSaturated[0] = true;
+    if (rawIR >= SATURATION) intervalSaturated[1] = true;
+    if ((nowMs - intervalStartMs) < INTERVAL_MS) return false;
+
+    uint32_t meanRed = (uint32_t)(sumRed / intervalCount);
+    uint32_t meanIR = (uint32_t)(sumIR / intervalCount);
+    bool satRed = intervalSaturated[0], satIR = intervalSaturated[1];
+    startInterval(nowMs);
+    if (meanIR < MIN_SIGNAL && !satIR) return false;
+
+    uint8_t oldRed = redAmplitude, oldIR = irAmplitude, oldRange = adcRange;
+    int8_t voteRed = adjust(redAmplitude, meanRed, satRed);
+    int8_t voteIR = adjust(irAmplitude, meanIR, satIR);
+
+    // The ADC range is shared: step it only when an LED is at its limit
+    // and the other does not ask for the opposite
+    if ((voteRed > 0 || voteIR > 0) && voteRed >= 0 && voteIR >= 0 && adcRange > 0) {
+        adcRange--;
+    } else if ((voteRed < 0 || voteIR < 0) && voteRed <= 0 && voteIR <= 0 && adcRange < MAX_ADC_RANGE) {
+        adcRange++;
+    }
+    float range = rangeFactor(adcRange) / rangeFactor(oldRange);
+    if (adcRange != oldRange) {
+        // The range step alone is the move of the LED at its limit; take it
+        // out of the other LED's amplitude so that its path still moves by
+        // the ratio it asked for (at most MAX_STEP), not that times the range
+        if (voteRed == 0) redAmplitude = rescale(redAmplitude, 1.0f / range);
+        if (voteIR == 0) irAmplitude = rescale(irAmplitude, 1.0f / range);
+    }
+    if (redAmplitude == oldRed && irAmplitude == oldIR && adcRange == oldRange) return false;
+
+    redStep = (float)redAmplitude / oldRed * range;
+    irStep = (float)irAmplitude / oldIR * range;
+    settleUntilMs = nowMs + SETTLE_MS;
+    stepCount++;
+    updateEnergyPerSample();
+    return true;
+}
+
+void LedGainControl::save(Retained &out) const {
+    out.redAmplitude = redAmplitude;
+    out.irAmplitude = irAmplitude;
+    out.adcRange = adcRange;
+}
+
+void LedGainControl::restore(const AcquisitionProfile &profile, const Retained &in, uint32_t nowMs) {
+    begin(profile, nowMs);
+    if (in.redAmplitude == 0 || in.irAmplitude == 0 || in.adcRange > MAX_ADC_RANGE) return;
+    redAmplitude = in.redAmplitude;
+    irAmplitude = in.irAmplitude;
+    adcRange = in.adcRange;
+    updateEnergyPerSample();
+}
+
+int8_t LedGainControl::adjust(uint8_t &amplitude, uint32_t mean, bool saturated) const {
+    // Hysteresis: inside the band nothing moves; outside, aim at mid-scale
+    float ratio;
+    if (saturated) ratio = 1.0f / MAX_STEP;
+    else if (mean == 0) ratio = MAX_STEP;
+    else if (mean < TARGET_LOW) ratio = (float)TARGET / mean;
+    else if (mean > TARGET_HIGH) ratio = (float)TARGET / mean;
+    else return 0;
+    if (ratio > MAX_STEP) ratio = MAX_STEP;
+    if (ratio < 1.0f / MAX_STEP) ratio = 1.0f / MAX_STEP;
+
+    int32_t next = lroundf(amplitude * ratio);
+    if (next == amplitude) next += (ratio > 1.0f) ? 1 : -1;
+    if (next < MIN_AMPLITUDE) next = MIN_AMPLITUDE;
+    if (next > MAX_AMPLITUDE) next = MAX_AMPLITUDE;
+    if (next == amplitude) return (ratio > 1.0f) ? 1 : -1;   // at the limit
+    amplitude = (uint8_t)next;
+    return 0;
+}
+
+uint8_t LedGainControl::rescale(uint8_t amplitude, float ratio) const {
+    int32_t next = lroundf(amplitude * ratio);
+    if (next < MIN_AMPLITUDE) next = MIN_AMPLITUDE;
+    if (next > MAX_AMPLITUDE) next = MAX_AMPLITUDE;
+    return (uint8_t)next;
+}
+
+float LedGainControl::rangeFactor(uint8_t range) const {
+    // Counts per nA double with every step down of ADC_RGE
+    return (float)(1 << (MAX_ADC_RANGE - range));
+}
+
+void LedGainControl::updateEnergyPerSample() {
+    uint8_t avg = sampleAverageCode < 5 ? sampleAverageCode : 5;
+    float mA = (redAmplitude + irAmplitude) * LED_MA_PER_CODE;
+    // mA x µs = nC; x V = nJ
+    energyPerSampleNJ = (uint32_t)(mA * PULSE_WIDTH_US[pulseWidthCode & 0x03] *
+                                   (float)(1 << avg) * LED_SUPPLY_V);
+}
+
+void LedGainControl::startInterval(uint32_t nowMs) {
+    intervalStartMs = nowMs;
+    sumRed = 0;
+    sumIR = 0;
+    intervalCount = 0;
+    intervalSaturated[0] = intervalSaturated[1] = false;
+}
+
+uint8_t LedGainControl::getRedAmplitude() const {
+    return redAmplitude;
+}
+
+uint8_t LedGainControl::getIRAmplitude() const {
+    return irAmplitude;
+}
+
+uint8_t LedGainControl::getADCRange() const {
+    return adcRange;
+}
+
+float LedGainControl::getRedGain() const {
+    if (refAmplitude == 0) return 1.0f;
+    return (float)redAmplitude / refAmplitude * rangeFactor(adcRange) / rangeFactor(refRange);
+}
+
+float LedGainControl::getIRGain() const {
+    if (refAmplitude == 0) return 1.0f;
+    return (float)irAmplitude / refAmplitude * rangeFactor(adcRange) / rangeFactor(refRange);
+}
+
+float LedGainControl::getRedStep() const {
+    return redStep;
+}
+
+float LedGainControl::getIRStep() const {
+    return irStep;
+}
+
+uint32_t LedGainControl::getStepCount() const {
+    return stepCount;
+}
+
+uint32_t LedGainControl::getValidSamples() const {
+    return validSamples;
+}
+
+uint32_t LedGainControl::getSaturatedSamples() const {
+    return saturatedSamples;
+}
+
+float LedGainControl::getEnergyPerValidSampleUJ() const {
+    return validSamples ? (float)energyNJ / 1000.0f / validSamples : 0.0f;
+}
+
+void LedGainControl::resetStats() {
+    energyNJ = 0;
+    validSamples = 0;
+    saturatedSamples = 0;
+    stepCount = 0;
+}
\ No newline at end of file
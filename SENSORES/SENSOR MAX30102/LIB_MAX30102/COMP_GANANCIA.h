@@ -0,0 +1,120 @@
+#ifndef COMP_GANANCIA_H
+#define COMP_GANANCIA_H
+
+#include <stdint.h>
+#include "COMP_PERFILES.h"
+
+/**
+ *  LED automatic gain control for one MAX30102. The mean raw level of
+ *  each LED is evaluated once per INTERVAL_MS; outside the target band the
+ *  LED amplitude moves towards mid-scale by at most MAX_STEP per interval,
+ *  and the shared ADC range is stepped only when an LED is at its limit.
+ *  It holds no bus: the caller writes the new setting when update()
+ *  returns true. Also accounts the LED energy spent per valid sample.
+ */
+class LedGainControl {
+public:
+    // Constructor
+    LedGainControl();
+
+    /**
+     *  Start from the settings of a profile; they are the reference for
+     *  getRedGain()/getIRGain().
+     */
+    void begin(const AcquisitionProfile &profile, uint32_t nowMs);
+
+    /**
+     *  Feed one raw FIFO sample.
+     *  @param valid  True if the sample reaches the DSP (finger present)
+     *  @return True if a new setting has to be written to the chip
+     */
+    bool update(uint32_t rawRed, uint32_t rawIR, bool valid, uint32_t nowMs);
+
+    // Current setting
+    uint8_t getRedAmplitude() const;
+    uint8_t getIRAmplitude() const;
+    uint8_t getADCRange() const;
+
+    // Gain of each LED path relative to the profile setting
+    float getRedGain() const;
+    float getIRGain() const;
+
+    // Gain ratio of the last step (new / old), to rescale DC estimates
+    float getRedStep() const;
+    float getIRStep() const;
+
+    uint32_t getStepCount() const;
+    uint32_t getValidSamples() const;
+    uint32_t getSaturatedSamples() const;
+
+    // LED energy per valid sample in µJ (0.0 if none)
+    float getEnergyPerValidSampleUJ() const;
+
+    // Clear step, sample and energy counters (setting is kept)
+    void resetStats();
+
+    // Current setting, kept across a deep sleep (the chip keeps it too)
+    struct Retained {
+        uint8_t redAmplitude;
+        uint8_t irAmplitude;
+        uint8_t adcRange;
+    };
+    void save(Retained &out) const;
+
+    // begin() from the profile, then take the saved setting
+    void restore(const AcquisitionProfile &profile, const Retained &in, uint32_t nowMs);
+
+    // Target band of the mean raw level (18-bit, left-justified)
+    static constexpr uint32_t FULL_SCALE      = 0x3FFFF;
+    static constexpr uint32_t TARGET_LOW      = FULL_SCALE / 4;
+    static constexpr uint32_t TARGET          = FULL_SCALE / 2;
+    static constexpr uint32_t TARGET_HIGH     = FULL_SCALE * 3 / 4;
+    static constexpr uint32_t SATURATION      = FULL_SCALE - 1024;
+    // Mean IR below this: nothing on the sensor, gain is held
+    static constexpr uint32_t MIN_SIGNAL      = 2000;
+    // Rate limits: one decision per interval, bounded gain ratio per step
+    static constexpr uint32_t INTERVAL_MS     = 500;
+    static constexpr uint32_t SETTLE_MS       = 50;    // ignored after a step
+    static constexpr float    MAX_STEP        = 2.0f;
+    static constexpr uint8_t  MIN_AMPLITUDE   = 0x02;  // 0.4 mA
+    static constexpr uint8_t  MAX_AMPLITUDE   = 0xFF;  // 50 mA
+    static constexpr uint8_t  MAX_ADC_RANGE   = 0x03;
+    // LED current per amplitude step and supply, for the energy estimate
+    static constexpr float    LED_MA_PER_CODE = 0.2f;
+    static constexpr float    LED_SUPPLY_V    = 3.3f;
+
+private:
+    // Reference (profile) and current setting
+    uint8_t  refAmplitude;
+    uint8_t  refRange;
+    uint8_t  redAmplitude;
+    uint8_t  irAmplitude;
+    uint8_t  adcRange;
+    float    redStep;
+    float    irStep;
+
+    // Accumulation of the current interval
+    uint32_t intervalStartMs;
+    uint32_t settleUntilMs;
+    uint64_t sumRed;
+    uint64_t sumIR;
+    uint16_t intervalCount;
+    bool     intervalSaturated[2];   // red, IR
+
+    // Energy accounting
+    uint8_t  pulseWidthCode;
+    uint8_t  sampleAverageCode;
+    uint32_t energyPerSampleNJ;
+    uint64_t energyNJ;
+    uint32_t validSamples;
+    uint32_t saturatedSamples;
+    uint32_t stepCount;
+
+    int8_t adjust(uint8_t &amplitude, uint32_t mean, bool saturated) const;
+    uint8_t rescale(uint8_t amplitude, float ratio) const;
+    float rangeFactor(uint8_t range) const;
+    void updateEnergyPerSample();
+    void startInterval(uint32_t nowMs);
+};
+
+#endif // COMP_GANANCIA_H
\ No newline at end of file
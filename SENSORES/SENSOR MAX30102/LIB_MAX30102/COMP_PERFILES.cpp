@@ -0,0 +1,37 @@
+#include "COMP_PERFILES.h"
+
+const AcquisitionProfile PROFILE_LOW_POWER = {
+    "low-power", 50, SR_CODE_50HZ, PW_CODE_215US, 0x02, 0x18, SMP_AVE_1, 1
+};
+
+const AcquisitionProfile PROFILE_STANDARD = {
+    "standard", 100, SR_CODE_100HZ, PW_CODE_411US, 0x02, 0x24, SMP_AVE_1, 1
+};
+
+const AcquisitionProfile PROFILE_HIGH_RES_400 = {
+    "high-res-400", 400, SR_CODE_400HZ, PW_CODE_411US, 0x02, 0x24, SMP_AVE_2, 1
+};
+
+// 411 µs is not allowed at 800 Hz in SpO2 mode: 215 µs pulses, with a
+// finer ADC range and brighter LEDs to keep the signal level
+const AcquisitionProfile PROFILE_HIGH_RES_800 = {
+    "high-res-800", 800, SR_CODE_800HZ, PW_CODE_215US, 0x01, 0x2F, SMP_AVE_2, 2
+};
+
+// Short pulses and a finer ADC range partly make up for the dim LED
+const AcquisitionProfile PROFILE_PRESENCE = {
+    "presence", 50, SR_CODE_50HZ, PW_CODE_118US, 0x01, 0x06, SMP_AVE_32, 1
+};
+
+float profileFifoRateHz(const AcquisitionProfile &profile) {
+    return (float)profile.sampleRateHz / (float)(1 << profile.sampleAverageCode);
+}
+
+float profileOutputRateHz(const AcquisitionProfile &profile) {
+    uint8_t decimation = profile.decimation ? profile.decimation : 1;
+    return profileFifoRateHz(profile) / (float)decimation;
+}
+
+float profileSamplePeriodMs(const AcquisitionProfile &profile) {
+    return 1000.0f / profileOutputRateHz(profile);
+}
@@ -0,0 +1,60 @@
+#ifndef COMP_PERFILES_H
+#define COMP_PERFILES_H
+
+#include <stdint.h>
+
+// Register codes (MAX30102 datasheet, SPO2_CONFIG and FIFO_CONFIG)
+#define SR_CODE_50HZ      0x00
+#define SR_CODE_100HZ     0x01
+#define SR_CODE_200HZ     0x02
+#define SR_CODE_400HZ     0x03
+#define SR_CODE_800HZ     0x04
+#define PW_CODE_69US      0x00
+#define PW_CODE_118US     0x01
+#define PW_CODE_215US     0x02
+#define PW_CODE_411US     0x03
+#define SMP_AVE_1         0x00
+#define SMP_AVE_2         0x01
+#define SMP_AVE_4         0x02
+#define SMP_AVE_8         0x03
+#define SMP_AVE_16        0x04
+#define SMP_AVE_32        0x05
+
+/**
+ *  Acquisition profile: chip configuration plus the host-side decimation
+ *  applied before the DSP. The processors derive their timing from the
+ *  resulting output rate.
+ */
+struct AcquisitionProfile {
+    const char *name;
+    uint16_t sampleRateHz;     // ADC conversion rate on the chip
+    uint8_t  sampleRateCode;   // SR_CODE_*
+    uint8_t  pulseWidthCode;   // PW_CODE_*
+    uint8_t  adcRangeCode;     // SPO2_ADC_RGE
+    uint8_t  ledAmplitude;     // LED1/LED2 pulse amplitude
+    uint8_t  sampleAverageCode;// SMP_AVE_* (on-chip averaging)
+    uint8_t  decimation;       // host-side boxcar decimation factor
+};
+
+// Low power: 50 Hz, short pulses, dimmer LEDs (20 ms per sample)
+extern const AcquisitionProfile PROFILE_LOW_POWER;
+// Standard: 100 Hz, 411 µs (10 ms per sample)
+extern const AcquisitionProfile PROFILE_STANDARD;
+// High resolution: 400 Hz averaged by 2 on chip (5 ms per sample)
+extern const AcquisitionProfile PROFILE_HIGH_RES_400;
+// High resolution: 800 Hz averaged by 2 on chip, decimated by 2 (5 ms)
+extern const AcquisitionProfile PROFILE_HIGH_RES_800;
+// Presence detection while idle: dim LEDs, 50 Hz averaged by 32 on chip
+// (one FIFO sample every 640 ms). Not meant for the DSP.
+extern const AcquisitionProfile PROFILE_PRESENCE;
+
+// Samples per second written to the FIFO (after on-chip averaging)
+float profileFifoRateHz(const AcquisitionProfile &profile);
+
+// Samples per second reaching the processors (after decimation)
+float profileOutputRateHz(const AcquisitionProfile &profile);
+
+// Time between samples seen by the processors, in ms
+float profileSamplePeriodMs(const AcquisitionProfile &profile);
+
+#endif // COMP_PERFILES_H
@@ -0,0 +1,82 @@
+#include "COMP_PRESENCIA.h"
+
+PresenceMonitor::PresenceMonitor()
+    : state(PRESENCE_ACTIVE),
+      enteredMs(0),
+      lastCheckMs(0),
+      lastFingerMs(0),
+      wakeCount(0) {
+    for (uint8_t s = 0; s < PRESENCE_STATE_COUNT; s++) {
+        timeMs[s] = 0;
+        busUs[s] = 0;
+    }
+}
+
+void PresenceMonitor::begin(PresenceState initial, uint32_t nowMs) {
+    state = initial;
+    enteredMs = nowMs;
+    lastCheckMs = nowMs;
+    lastFingerMs = nowMs;
+}
+
+bool PresenceMonitor::isCheckDue(uint32_t nowMs) {
+    if (state != PRESENCE_IDLE || (nowMs - lastCheckMs) < CHECK_INTERVAL_MS) return false;
+    lastCheckMs = nowMs;
+    return true;
+}
+
+bool PresenceMonitor::checkIdle(uint32_t rawIR, uint32_t nowMs) {
+    if (state != PRESENCE_IDLE || rawIR <= PRESENCE_TH) return false;
+    enter(PRESENCE_ACTIVE, nowMs);
+    wakeCount++;
+    return true;
+}
+
+bool PresenceMonitor::checkActive(bool fingerPresent, uint32_t nowMs) {
+    if (state != PRESENCE_ACTIVE) return false;
+    if (fingerPresent) {
+        lastFingerMs = nowMs;
+        return false;
+    }
+    if ((nowMs - lastFingerMs) < IDLE_DELAY_MS) return false;
+    enter(PRESENCE_IDLE, nowMs);
+    return true;
+}
+
+void PresenceMonitor::enter(PresenceState next, uint32_t nowMs) {
+    timeMs[state] += nowMs - enteredMs;
+    state = next;
+    enteredMs = nowMs;
+    lastCheckMs = nowMs;
+    lastFingerMs = nowMs;
+}
+
+void PresenceMonitor::addBusTime(uint32_t us) {
+    busUs[state] += us;
+}
+
+PresenceState PresenceMonitor::getState() const {
+    return state;
+}
+
+uint32_t PresenceMonitor::getTimeMs(PresenceState s, uint32_t nowMs) const {
+    if (s >= PRESENCE_STATE_COUNT) return 0;
+    return timeMs[s] + (s == state ? nowMs - enteredMs : 0);
+}
+
+uint32_t PresenceMonitor::getBusTimeUs(PresenceState s) const {
+    return (s < PRESENCE_STATE_COUNT) ? busUs[s] : 0;
+}
+
+uint32_t PresenceMonitor::getWakeCount() const {
+    return wakeCount;
+}
+
+void PresenceMonitor::resetStats(uint32_t nowMs) {
+    for (uint8_t s = 0; s < PRESENCE_STATE_COUNT; s++) {
+        timeMs[s] = 0;
+        busUs[s] = 0;
+    }
+    wakeCount = 0;
+    enteredMs = nowMs;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#ifndef COMP_PRESENCIA_H
+#define COMP_PRESENCIA_H
+
+#include <stdint.h>
+
+// Presence states of a sensor
+enum PresenceState : uint8_t {
+    PRESENCE_IDLE = 0,   // PROFILE_PRESENCE, only the newest sample is checked
+    PRESENCE_ACTIVE,     // acquisition profile, full DSP
+    PRESENCE_STATE_COUNT
+};
+
+/**
+ *  Presence state machine for one MAX30102. It holds no bus: the caller
+ *  reconfigures the chip on every transition it reports and feeds the
+ *  timestamps. Also accounts the time and bus time spent in each state.
+ */
+class PresenceMonitor {
+public:
+    // Constructor
+    PresenceMonitor();
+
+    /**
+     *  Start (or restart) in a given state.
+     *  @param state  Initial state
+     *  @param nowMs  Current time (ms)
+     */
+    void begin(PresenceState state, uint32_t nowMs);
+
+    /**
+     *  Idle: whether the next presence check is due. Spaces the bus reads
+     *  to the FIFO rate of PROFILE_PRESENCE.
+     */
+    bool isCheckDue(uint32_t nowMs);
+
+    /**
+     *  Idle: evaluate the newest IR sample.
+     *  @param rawIR  Raw IR value read with PROFILE_PRESENCE
+     *  @return True if something was detected: switch to ACTIVE
+     */
+    bool checkIdle(uint32_t rawIR, uint32_t nowMs);
+
+    /**
+     *  Active: evaluate the finger detector of the DSP.
+     *  @param fingerPresent  Current finger state (with its own hysteresis)
+     *  @return True if nothing has been seen for IDLE_DELAY: switch to IDLE
+     */
+    bool checkActive(bool fingerPresent, uint32_t nowMs);
+
+    // Add bus time (us) to the current state
+    void addBusTime(uint32_t us);
+
+    PresenceState getState() const;
+
+    // Time in a state (ms), including the current stretch up to nowMs
+    uint32_t getTimeMs(PresenceState state, uint32_t nowMs) const;
+    uint32_t getBusTimeUs(PresenceState state) const;
+    uint32_t getWakeCount() const;
+
+    // Clear time, bus time and wake counters (state is kept)
+    void resetStats(uint32_t nowMs);
+
+    // Raw IR that wakes the sensor, at the presence LED amplitude
+    static constexpr uint32_t PRESENCE_TH       = 2500;
+    // Time between checks while idle (FIFO period of PROFILE_PRESENCE)
+    static constexpr uint32_t CHECK_INTERVAL_MS = 640;
+    // Time without finger before going back to idle; also the time a
+    // wake-up has to confirm a finger
+    static constexpr uint32_t IDLE_DELAY_MS     = 3000;
+
+private:
+    PresenceState state;
+    uint32_t enteredMs;       // start of the current stretch
+    uint32_t lastCheckMs;
+    uint32_t lastFingerMs;
+    uint32_t timeMs[PRESENCE_STATE_COUNT];
+    uint32_t busUs[PRESENCE_STATE_COUNT];
+    uint32_t wakeCount;
+
+    void enter(PresenceState next, uint32_t nowMs);
+};
+
+#endif // COMP_PRESENCIA_H
\ No newline at end of file
@@ -6,7 +6,12 @@ HeartRateProcessor::HeartRateProcessor()
       beatPeriod(0.0f),
       lastMaxValue(0.0f),
       tsLastBeat(0),
-      beatDetectedFlag(false) {
+      lastInterval(0),
+      beatDetectedFlag(false),
+      samplePeriod(DEFAULT_SAMPLE_PERIOD),
+      blankUntil(0),
+      blanking(false),
+      resync(false) {
 }
 
 void HeartRateProcessor::reset() {
@@ -15,10 +20,20 @@ void HeartRateProcessor::reset() {
     beatPeriod = 0.0f;
     lastMaxValue = 0.0f;
     tsLastBeat = 0;
+    lastInterval = 0;
     beatDetectedFlag = false;
+    blanking = false;
+    resync = false;
 }
 
 bool HeartRateProcessor::update(float irACValue, uint32_t timestampMs) {
+    if (blanking) {
+        if ((int32_t)(timestampMs - blankUntil) < 0) {
+            beatDetectedFlag = false;
+            return false;
+        }
+        blanking = false;
+    }
     beatDetectedFlag = checkForBeat(irACValue, timestampMs);
     return beatDetectedFlag;
 }
@@ -35,6 +50,47 @@ bool HeartRateProcessor::isBeatDetected() const {
     return beatDetectedFlag;
 }
 
+uint32_t HeartRateProcessor::getLastInterval() const {
+    return lastInterval;
+}
+
+void HeartRateProcessor::setSamplePeriod(float periodMs) {
+    if (periodMs > 0.0f) samplePeriod = periodMs;
+}
+
+void HeartRateProcessor::notifyGainChange(uint32_t timestampMs) {
+    blankUntil = timestampMs + GAIN_BLANKING;
+    blanking = true;
+    notifyGap();
+}
+
+void HeartRateProcessor::notifyGap() {
+    if (state == INIT) return;
+    state = WAITING;
+    resync = tsLastBeat != 0;
+}
+
+void HeartRateProcessor::save(Retained &out) const {
+    out.running = state != INIT;
+    out.hasBeat = tsLastBeat != 0;
+    out.threshold = threshold;
+    out.beatPeriod = beatPeriod;
+    out.lastMaxValue = lastMaxValue;
+}
+
+void HeartRateProcessor::restore(const Retained &in, uint32_t nowMs) {
+    reset();
+    if (!in.running) return;
+    state = WAITING;
+    threshold = in.threshold;
+    beatPeriod = in.beatPeriod;
+    lastMaxValue = in.lastMaxValue;
+    if (in.hasBeat) {
+        tsLastBeat = nowMs ? nowMs : 1;
+        resync = true;
+    }
+}
+
 bool HeartRateProcessor::checkForBeat(float sample, uint32_t now) {
     bool beatDetected = false;
 
@@ -72,8 +128,13 @@ bool HeartRateProcessor::checkForBeat(float sample, uint32_t now) {
                 beatDetected = true;
                 lastMaxValue = sample;
                 state = MASKING;
-                if (tsLastBeat != 0) {
-                    float delta = (float)(now - tsLastBeat);
+                if (resync) {
+                    // A beat may have fallen in the blanking window
+                    lastInterval = 0;
+                    resync = false;
+                } else if (tsLastBeat != 0) {
+                    lastInterval = now - tsLastBeat;
+                    float delta = (float)lastInterval;
                     beatPeriod = ALPHA * delta + (1 - ALPHA) * beatPeriod;
                 }
                 tsLastBeat = now;
@@ -95,7 +156,7 @@ bool HeartRateProcessor::checkForBeat(float sample, uint32_t now) {
 
 void HeartRateProcessor::decreaseThreshold() {
     if (lastMaxValue > 0.0f && beatPeriod > 0.0f) {
-        threshold -= lastMaxValue * (1.0f - THRESH_FALLOFF) / (beatPeriod / SAMPLE_PERIOD);
+        threshold -= lastMaxValue * (1.0f - THRESH_FALLOFF) / (beatPeriod / samplePeriod);
     } else {
         threshold *= THRESH_DECAY;
     }
@@ -32,6 +32,56 @@ public:
      */
     bool isBeatDetected() const;
 
+    /**
+     *  Raw time between the last two beats, before the period EMA.
+     *  @return Interval in ms (0 until two beats have been seen)
+     */
+    uint32_t getLastInterval() const;
+
+    /**
+     *  Set the time between samples fed to update(). Taken from the active
+     *  acquisition profile; does not reset the detector.
+     *  @param periodMs  Sample period in ms
+     */
+    void setSamplePeriod(float periodMs);
+
+    /**
+     *  Notify an LED gain step. Samples are ignored for GAIN_BLANKING ms
+     *  and the first beat afterwards only re-anchors the beat timing, so
+     *  the step is neither taken as a beat nor stretches an interval.
+     *  @param timestampMs Time (ms) of the step
+     */
+    void notifyGainChange(uint32_t timestampMs);
+
+    /**
+     *  Notify that samples were not fed (e.g. a window rejected for low
+     *  signal quality). Detection restarts on the next rising edge and the
+     *  first beat afterwards only re-anchors the beat timing.
+     */
+    void notifyGap();
+
+    /**
+     *  Detector state kept across a deep sleep (RTC memory). Holds no
+     *  timestamps: millis() restarts on every wake.
+     */
+    struct Retained {
+        bool  running;        // past the INIT hold-off
+        bool  hasBeat;
+        float threshold;
+        float beatPeriod;
+        float lastMaxValue;
+    };
+    void save(Retained &out) const;
+
+    /**
+     *  Resume from a saved state. The INIT hold-off is skipped and the
+     *  sleep is handled like notifyGap(): the filtered period carries over
+     *  and the first beat only re-anchors the timing (INVALID_DELAY counts
+     *  from the resume).
+     *  @param nowMs  Time (ms) of the resume
+     */
+    void restore(const Retained &in, uint32_t nowMs);
+
 private:
     // State machine states for beat detection
     enum State {
@@ -47,7 +97,12 @@ private:
     float beatPeriod;         // filtered beat period in ms
     float lastMaxValue;
     uint32_t tsLastBeat;      // timestamp of last beat (ms)
+    uint32_t lastInterval;    // last beat-to-beat interval (ms)
     bool beatDetectedFlag;
+    float samplePeriod;       // ms between samples (from the profile)
+    uint32_t blankUntil;      // end of the gain-step blanking (ms)
+    bool blanking;
+    bool resync;              // next beat only re-anchors tsLastBeat
 
     // Configuration constants
     static constexpr uint32_t INIT_HOLDOFF      = 2000;  // ms
@@ -59,7 +114,8 @@ private:
     static constexpr float    THRESH_FALLOFF    = 0.3f;  // ratio after beat
     static constexpr float    THRESH_DECAY      = 0.99f; // continuous decay
     static constexpr uint32_t INVALID_DELAY     = 2000;  // ms without beat resets
-    static constexpr uint32_t SAMPLE_PERIOD     = 10;    // ms between samples
+    static constexpr float    DEFAULT_SAMPLE_PERIOD = 10.0f; // ms (100 Hz)
+    static constexpr uint32_t GAIN_BLANKING     = 100;   // ms
 
     // Internal detection methods
     bool checkForBeat(float sample, uint32_t now);
@@ -1,5 +1,4 @@
 #include "COMP_SPO2.h"
-#include <Arduino.h>
 
 // Lookup table for SpO2 values based on ratio index
 const uint8_t SpO2Processor::spO2LUT[43] = {
@@ -10,7 +9,8 @@ const uint8_t SpO2Processor::spO2LUT[43] = {
 };
 
 SpO2Processor::SpO2Processor()
-    : irACSumSq(0), redACSumSq(0), sampleCount(0), beatsDetected(0), spO2(0) {
+    : irACSumSq(0), redACSumSq(0), sampleCount(0), beatsDetected(0), spO2(0),
+      redScale(1.0f), irScale(1.0f) {
 }
 
 void SpO2Processor::reset() {
@@ -22,7 +22,9 @@ void SpO2Processor::reset() {
 }
 
 void SpO2Processor::update(float irAC, float redAC, bool beatDetected) {
-    // Accumulate squared AC components
+    // Accumulate squared AC components at the reference gain
+    irAC *= irScale;
+    redAC *= redScale;
     irACSumSq += irAC * irAC;
     redACSumSq += redAC * redAC;
     sampleCount++;
@@ -39,6 +41,38 @@ uint8_t SpO2Processor::getSpO2() const {
     return spO2;
 }
 
+void SpO2Processor::setLEDGain(float redGain, float irGain) {
+    float red = redGain > 0.0f ? 1.0f / redGain : 1.0f;
+    float ir = irGain > 0.0f ? 1.0f / irGain : 1.0f;
+    if (red == redScale && ir == irScale) return;
+    redScale = red;
+    irScale = ir;
+    irACSumSq = 0;
+    redACSumSq = 0;
+    sampleCount = 0;
+    beatsDetected = 0;
+}
+
+void SpO2Processor::save(Retained &out) const {
+    out.irACSumSq = irACSumSq;
+    out.redACSumSq = redACSumSq;
+    out.sampleCount = sampleCount;
+    out.beatsDetected = beatsDetected;
+    out.spO2 = spO2;
+    out.redScale = redScale;
+    out.irScale = irScale;
+}
+
+void SpO2Processor::restore(const Retained &in) {
+    irACSumSq = in.irACSumSq;
+    redACSumSq = in.redACSumSq;
+    sampleCount = in.sampleCount;
+    beatsDetected = in.beatsDetected;
+    spO2 = in.spO2;
+    redScale = in.redScale;
+    irScale = in.irScale;
+}
+
 void SpO2Processor::computeSpO2() {
     if (sampleCount == 0 || irACSumSq <= 0 || redACSumSq <= 0) {
         spO2 = 0;
@@ -31,6 +31,26 @@ public:
      */
     uint8_t getSpO2() const;
 
+    /**
+     *  Gain of each LED path relative to the reference setting. AC values
+     *  are divided by it so the calibration holds while an AGC moves the
+     *  LEDs; a change discards the partial accumulation.
+     */
+    void setLEDGain(float redGain, float irGain);
+
+    // Accumulators and LED scaling kept across a deep sleep (RTC memory)
+    struct Retained {
+        float    irACSumSq;
+        float    redACSumSq;
+        uint32_t sampleCount;
+        uint8_t  beatsDetected;
+        uint8_t  spO2;
+        float    redScale;
+        float    irScale;
+    };
+    void save(Retained &out) const;
+    void restore(const Retained &in);
+
 private:
     // Sum of squares of AC values for IR and Red
     float irACSumSq;
@@ -45,6 +65,10 @@ private:
     // Last computed SpO2 value
     uint8_t spO2;
 
+    // Inverse LED gains applied to the AC values
+    float redScale;
+    float irScale;
+
     // Lookup table for SpO2 values based on ratio index
     static const uint8_t spO2LUT[43];
 
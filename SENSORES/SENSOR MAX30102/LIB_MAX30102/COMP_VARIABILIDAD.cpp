@@ -0,0 +1,125 @@
+#include "COMP_VARIABILIDAD.h"
+#include <math.h>
+
+HRVProcessor::HRVProcessor()
+    : windowMs(HRV_WINDOW_MS) {
+    reset();
+}
+
+void HRVProcessor::reset() {
+    head = 0;
+    count = 0;
+    sum = 0;
+    sumSq = 0;
+    diffSqSum = 0;
+    diffCount = 0;
+    nn50Count = 0;
+    reference = 0;
+    chained = false;
+    consecutiveRejects = 0;
+    rejected = 0;
+}
+
+void HRVProcessor::setWindow(uint32_t ms) {
+    if (ms > 0) windowMs = ms;
+}
+
+bool HRVProcessor::addInterval(uint32_t ibiMs, uint32_t timestampMs) {
+    // Artifact rejection: physiological range, then at most MAX_DEVIATION
+    // from the previous accepted interval (missed or extra beats)
+    bool accept = ibiMs >= MIN_IBI && ibiMs <= MAX_IBI;
+    if (accept && reference > 0) {
+        float deviation = fabsf((float)ibiMs - reference) / reference;
+        accept = deviation <= MAX_DEVIATION;
+    }
+    if (!accept) {
+        rejected++;
+        chained = false;
+        // A sustained change of rhythm is real: restart from the next
+        // interval in range
+        if (++consecutiveRejects >= MAX_REJECTS) reference = 0;
+        return false;
+    }
+    consecutiveRejects = 0;
+
+    // Slide the window; the newest entry is the last to go
+    while (count > 0 &&
+           (count >= HRV_MAX_BEATS || (timestampMs - beatMs[(head + HRV_MAX_BEATS - count) % HRV_MAX_BEATS]) > windowMs)) {
+        evictOldest();
+    }
+
+    uint16_t value = (uint16_t)ibiMs;
+    bool diff = chained && count > 0;
+    if (diff) {
+        uint16_t prev = ibi[(head + HRV_MAX_BEATS - 1) % HRV_MAX_BEATS];
+        uint32_t d = value > prev ? value - prev : prev - value;
+        diffSqSum += d * d;
+        diffCount++;
+        if (d > NN50_MS) nn50Count++;
+    }
+    ibi[head] = value;
+    beatMs[head] = timestampMs;
+    hasDiff[head] = diff;
+    head = (head + 1) % HRV_MAX_BEATS;
+    count++;
+    sum += value;
+    sumSq += (uint32_t)value * value;
+
+    reference = value;
+    chained = true;
+    return true;
+}
+
+void HRVProcessor::markGap() {
+    chained = false;
+}
+
+void HRVProcessor::evictOldest() {
+    uint16_t tail = (head + HRV_MAX_BEATS - count) % HRV_MAX_BEATS;
+    uint16_t value = ibi[tail];
+    sum -= value;
+    sumSq -= (uint32_t)value * value;
+
+    // The next entry loses its difference with the evicted one
+    uint16_t next = (tail + 1) % HRV_MAX_BEATS;
+    if (count > 1 && hasDiff[next]) {
+        uint32_t d = ibi[next] > value ? ibi[next] - value : value - ibi[next];
+        diffSqSum -= d * d;
+        diffCount--;
+        if (d > NN50_MS) nn50Count--;
+        hasDiff[next] = false;
+    }
+    count--;
+}
+
+uint16_t HRVProcessor::getInterval(uint16_t age) const {
+    if (age >= count) return 0;
+    return ibi[(head + HRV_MAX_BEATS - 1 - age) % HRV_MAX_BEATS];
+}
+
+uint16_t HRVProcessor::getCount() const {
+    return count;
+}
+
+float HRVProcessor::getMeanIBI() const {
+    return count ? (float)sum / count : 0.0f;
+}
+
+float HRVProcessor::getSDNN() const {
+    if (count < 2) return 0.0f;
+    // n*sumSq - sum^2 is exact in 64 bits; no cancellation
+    int64_t num = (int64_t)count * (int64_t)sumSq - (int64_t)sum * sum;
+    return sqrtf((float)num / ((float)count * (count - 1)));
+}
+
+float HRVProcessor::getRMSSD() const {
+    return diffCount ? sqrtf((float)diffSqSum / diffCount) : 0.0f;
+}
+
+float HRVProcessor::getPNN50() const {
+    return diffCount ? 100.0f * nn50Count / diffCount : 0.0f;
+}
+
+uint32_t HRVProcessor::getRejectedCount() const {
+    return rejected;
+}
\ No newline at end of file
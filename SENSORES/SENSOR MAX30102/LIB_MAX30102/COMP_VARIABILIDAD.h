@@ -0,0 +1,112 @@
+#ifndef COMP_VARIABILIDAD_H
+#define COMP_VARIABILIDAD_H
+
+#include <stdint.h>
+
+// Capacity of the inter-beat interval ring (200 bpm for a full minute)
+#ifndef HRV_MAX_BEATS
+#define HRV_MAX_BEATS 200
+#endif
+
+// Default sliding window in ms
+#ifndef HRV_WINDOW_MS
+#define HRV_WINDOW_MS 60000
+#endif
+
+/**
+ *  Heart-rate variability over a sliding window of inter-beat intervals.
+ *  Accepted IBIs are kept in a fixed ring; the sums behind SDNN, RMSSD and
+ *  pNN50 are updated when an interval enters or leaves the window, so each
+ *  beat costs O(1) (amortised over evictions) and reads are O(1).
+ *  Successive differences are only taken between intervals that were
+ *  adjacent in the beat stream: a rejected interval breaks the chain.
+ */
+class HRVProcessor {
+public:
+    // Constructor
+    HRVProcessor();
+
+    // Empty the window and the rejection state
+    void reset();
+
+    /**
+     *  Set the window length. Intervals older than this are evicted on the
+     *  next addInterval(); the ring capacity bounds it as well.
+     *  @param windowMs  Window in ms
+     */
+    void setWindow(uint32_t windowMs);
+
+    /**
+     *  Feed the interval that ended with a detected beat.
+     *  @param ibiMs        Time since the previous beat (ms)
+     *  @param timestampMs  Time of the beat (ms)
+     *  @return True if the interval was accepted, false if it was rejected
+     *          as an artifact
+     */
+    bool addInterval(uint32_t ibiMs, uint32_t timestampMs);
+
+    /**
+     *  Beats were missed (e.g. a skipped window): the next interval is not
+     *  differenced with the previous one.
+     */
+    void markGap();
+
+    /**
+     *  Accepted interval by age.
+     *  @param age  0 for the newest, getCount() - 1 for the oldest
+     *  @return Interval in ms (0 if out of range)
+     */
+    uint16_t getInterval(uint16_t age) const;
+
+    // Intervals in the window
+    uint16_t getCount() const;
+
+    // Mean IBI in ms (0.0 if empty)
+    float getMeanIBI() const;
+
+    // Standard deviation of the IBIs in ms (0.0 with fewer than two)
+    float getSDNN() const;
+
+    // Root mean square of successive differences in ms (0.0 if none)
+    float getRMSSD() const;
+
+    // Percentage of successive differences above 50 ms (0.0 if none)
+    float getPNN50() const;
+
+    // Intervals rejected since the last reset()
+    uint32_t getRejectedCount() const;
+
+private:
+    // Ring of accepted intervals; hasDiff marks a valid difference with
+    // the previous entry
+    uint16_t ibi[HRV_MAX_BEATS];
+    uint32_t beatMs[HRV_MAX_BEATS];
+    bool     hasDiff[HRV_MAX_BEATS];
+    uint16_t head;            // next write position
+    uint16_t count;
+    uint32_t windowMs;
+
+    // Window sums (integers: eviction subtracts exactly)
+    uint32_t sum;
+    uint64_t sumSq;
+    uint64_t diffSqSum;
+    uint16_t diffCount;
+    uint16_t nn50Count;
+
+    // Artifact rejection
+    uint16_t reference;       // last accepted interval, 0 for none
+    bool     chained;         // previous interval was accepted
+    uint8_t  consecutiveRejects;
+    uint32_t rejected;
+
+    // Configuration constants
+    static constexpr uint16_t MIN_IBI        = 333;   // ms (180 bpm)
+    static constexpr uint16_t MAX_IBI        = 1500;  // ms (40 bpm)
+    static constexpr float    MAX_DEVIATION  = 0.2f;  // vs. previous interval
+    static constexpr uint8_t  MAX_REJECTS    = 3;     // then re-seed reference
+    static constexpr uint16_t NN50_MS        = 50;
+
+    void evictOldest();
+};
+
+#endif // COMP_VARIABILIDAD_H
\ No newline at end of file
@@ -1,10 +1,12 @@
 #ifndef LIB_MAX30102_H
 #define LIB_MAX30102_H
 
-#include <Arduino.h>
-#include <Wire.h>
+#include <stdint.h>
 #include <vector>
 #include <utility>
+#include "COMP_BUS.h"
+#include "COMP_PLATAFORMA.h"
+#include "COMP_PERFILES.h"
 
 // I2C address of the MAX30102
 #define MAX30102_ADDRESS       0x57
@@ -33,12 +35,18 @@
 #define REG_REV_ID             0xFE
 #define REG_PART_ID            0xFF
 
-class MAX30102 {
+/**
+ *  MAX30102 driver, templated on the I2C bus (see COMP_BUS.h) so the same
+ *  code runs over Arduino Wire, the ESP-IDF i2c_master driver, the bus
+ *  manager or a host mock with every transfer resolved at compile time.
+ */
+template <class Bus>
+class MAX30102T {
 public:
-    // Constructor with optional TwoWire port
-    MAX30102(TwoWire &wirePort = Wire);
+    // Constructor with optional bus (Arduino: a TwoWire port)
+    MAX30102T(Bus bus = Bus());
 
-    // Initialize sensor (incluye LEDs al máximo)
+    // Initialize sensor (LEDs stay as configured by setup()/applyProfile())
     bool begin(uint8_t i2cAddress = MAX30102_ADDRESS,
                uint32_t i2cSpeed = I2C_SPEED_STANDARD);
 
@@ -46,14 +54,42 @@ public:
     void shutdown();
     void wakeUp();
 
+    /**
+     *  Leave shutdown keeping the configuration (registers survive it) and
+     *  drop the samples left in the FIFO. Returns false if the chip lost
+     *  its configuration (power cycle): setup() is needed then.
+     */
+    bool resume();
+
+    /**
+     *  Liveness check that leaves the FIFO alone (one register read).
+     *  Returns false if the chip does not answer; configured is false if it
+     *  answers with the power-on or shutdown mode, so setup() is needed.
+     */
+    bool isAlive(bool &configured);
+
     // High-level setup: configure LEDs, sample rate, pulse width, ADC range
     void setup();  // ← Nuevo método para configuración predeterminada
 
+    /**
+     *  Switch acquisition profile at runtime. The FIFO is cleared so no
+     *  samples of different rates are mixed; the sensor keeps running.
+     *  Written as register bursts (four transactions).
+     */
+    void applyProfile(const AcquisitionProfile &profile);
+
+    /**
+     *  Idle configuration while nothing is on the sensor: PROFILE_PRESENCE
+     *  with the red LED off. applyProfile() resumes acquisition.
+     */
+    void applyPresenceProfile();
+
     // Configuration
     void setLEDMode(uint8_t mode);
     void setSamplingRate(uint8_t rate);
     void setPulseWidth(uint8_t width);
     void setADCRange(uint8_t range);
+    void setSampleAverage(uint8_t average);
     void setLEDPulseAmplitudeRed(uint8_t amplitude);
     void setLEDPulseAmplitudeIR(uint8_t amplitude);
 
@@ -77,13 +113,19 @@ public:
     uint8_t getRevisionID();
     uint8_t getPartID();
 
+    // Samples fetched per FIFO burst (limited by the bus transfer size)
+    static constexpr uint8_t FIFO_BURST =
+        (Bus::MAX_TRANSFER / 6 < 32) ? Bus::MAX_TRANSFER / 6 : 32;
+
 private:
-    TwoWire *_wire;
+    Bus _bus;
     uint8_t _i2caddr;
 
     // Low-level I2C
     uint8_t readRegister(uint8_t reg);
     void writeRegister(uint8_t reg, uint8_t value);
+    void writeRegisters(uint8_t reg, const uint8_t *data, uint8_t len);
+    bool readRegisters(uint8_t reg, uint8_t *data, uint8_t len);
 
     // FIFO helpers
     uint8_t getWritePtr();
@@ -91,4 +133,264 @@ private:
     uint8_t getFifoCount();
 };
 
+template <class Bus>
+MAX30102T<Bus>::MAX30102T(Bus bus)
+    : _bus(bus), _i2caddr(MAX30102_ADDRESS) {
+}
+
+template <class Bus>
+bool MAX30102T<Bus>::begin(uint8_t i2cAddress, uint32_t i2cSpeed) {
+    _i2caddr = i2cAddress;
+    _bus.attach(_i2caddr, I2C_SPEED_FAST, i2cSpeed);
+
+    uint8_t partID = getPartID();
+    return partID == 0x15;
+}
+
+template <class Bus>
+void MAX30102T<Bus>::setup() {
+    // Configuración predeterminada: modo Red + IR (también sale de
+    // shutdown) y perfil estándar, que limpia la FIFO
+    setLEDMode(0x03);
+    applyProfile(PROFILE_STANDARD); // 100 Hz, 411 µs
+}
+
+template <class Bus>
+void MAX30102T<Bus>::applyProfile(const AcquisitionProfile &profile) {
+    // Every field of FIFO_CONFIG and SPO2_CONFIG comes from the profile,
+    // so no read-modify-write is needed
+    writeRegister(REG_FIFO_CONFIG, (profile.sampleAverageCode & 0x07) << 5);
+    writeRegister(REG_SPO2_CONFIG, ((profile.adcRangeCode & 0x03) << 5) |
+                                   ((profile.sampleRateCode & 0x07) << 2) |
+                                   (profile.pulseWidthCode & 0x03));
+    uint8_t led[2] = { profile.ledAmplitude, profile.ledAmplitude };
+    writeRegisters(REG_LED1_PA, led, 2);
+    clearFIFO();
+}
+
+template <class Bus>
+void MAX30102T<Bus>::applyPresenceProfile() {
+    applyProfile(PROFILE_PRESENCE);
+    setLEDPulseAmplitudeRed(0);
+}
+
+// ---------- Power Control ----------
+
+template <class Bus>
+void MAX30102T<Bus>::shutdown() {
+    uint8_t reg = readRegister(REG_MODE_CONFIG);
+    reg |= 0x80;
+    writeRegister(REG_MODE_CONFIG, reg);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::wakeUp() {
+    uint8_t reg = readRegister(REG_MODE_CONFIG);
+    reg &= ~0x80;
+    writeRegister(REG_MODE_CONFIG, reg);
+}
+
+template <class Bus>
+bool MAX30102T<Bus>::resume() {
+    uint8_t mode = readRegister(REG_MODE_CONFIG);
+    if ((mode & 0x07) == 0) return false;   // power-on default
+    writeRegister(REG_MODE_CONFIG, mode & ~0x80);
+    clearFIFO();
+    return true;
+}
+
+template <class Bus>
+bool MAX30102T<Bus>::isAlive(bool &configured) {
+    uint8_t mode = 0;
+    if (!readRegisters(REG_MODE_CONFIG, &mode, 1)) return false;
+    configured = (mode & 0x07) != 0 && !(mode & 0x80);
+    return true;
+}
+
+// ---------- Configuration Setters ----------
+
+template <class Bus>
+void MAX30102T<Bus>::setLEDMode(uint8_t mode) {
+    writeRegister(REG_MODE_CONFIG, mode & 0x07);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::setSamplingRate(uint8_t rate) {
+    uint8_t reg = readRegister(REG_SPO2_CONFIG);
+    reg = (reg & ~(0x07 << 2)) | ((rate & 0x07) << 2);
+    writeRegister(REG_SPO2_CONFIG, reg);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::setPulseWidth(uint8_t width) {
+    uint8_t reg = readRegister(REG_SPO2_CONFIG);
+    reg = (reg & ~0x03) | (width & 0x03);
+    writeRegister(REG_SPO2_CONFIG, reg);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::setADCRange(uint8_t range) {
+    uint8_t reg = readRegister(REG_SPO2_CONFIG);
+    reg = (reg & ~(0x03 << 5)) | ((range & 0x03) << 5);
+    writeRegister(REG_SPO2_CONFIG, reg);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::setSampleAverage(uint8_t average) {
+    uint8_t reg = readRegister(REG_FIFO_CONFIG);
+    reg = (reg & ~(0x07 << 5)) | ((average & 0x07) << 5);
+    writeRegister(REG_FIFO_CONFIG, reg);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::setLEDPulseAmplitudeRed(uint8_t amplitude) {
+    writeRegister(REG_LED1_PA, amplitude);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::setLEDPulseAmplitudeIR(uint8_t amplitude) {
+    writeRegister(REG_LED2_PA, amplitude);
+}
+
+// ---------- FIFO Management ----------
+
+template <class Bus>
+void MAX30102T<Bus>::clearFIFO() {
+    // WR_PTR, OVF_COUNTER and RD_PTR are contiguous: one transaction
+    uint8_t zero[3] = { 0, 0, 0 };
+    writeRegisters(REG_FIFO_WR_PTR, zero, 3);
+}
+
+template <class Bus>
+uint8_t MAX30102T<Bus>::getWritePtr() {
+    return readRegister(REG_FIFO_WR_PTR);
+}
+
+template <class Bus>
+uint8_t MAX30102T<Bus>::getReadPtr() {
+    return readRegister(REG_FIFO_RD_PTR);
+}
+
+template <class Bus>
+uint8_t MAX30102T<Bus>::getFifoCount() {
+    // WR_PTR, OVF_COUNTER and RD_PTR are contiguous: one transaction
+    uint8_t ptr[3];
+    if (!readRegisters(REG_FIFO_WR_PTR, ptr, 3)) return 0;
+    uint8_t w = ptr[0] & 0x1F;
+    uint8_t r = ptr[2] & 0x1F;
+    // Equal pointers are also a full FIFO: rollover is off, so new samples
+    // are being dropped and OVF_COUNTER counts them until one is read
+    if (w == r && (ptr[1] & 0x1F) != 0) return 32;
+    return (w >= r) ? (w - r) : (w + 32 - r);
+}
+
+template <class Bus>
+bool MAX30102T<Bus>::readFIFO(uint32_t &redLED, uint32_t &irLED) {
+    uint8_t count = getFifoCount();
+    if (count == 0) return false;
+    // Drain the FIFO and keep the newest sample
+    while (count > 0) {
+        uint8_t n = count;
+        if (n > FIFO_BURST) n = FIFO_BURST;
+        uint8_t data[6 * FIFO_BURST];
+        if (!readRegisters(REG_FIFO_DATA, data, 6 * n)) return false;
+
+        const uint8_t *last = data + 6 * (n - 1);
+        redLED = (((uint32_t)last[0] << 16) | ((uint32_t)last[1] << 8) | last[2]) & 0x03FFFF;
+        irLED  = (((uint32_t)last[3] << 16) | ((uint32_t)last[4] << 8) | last[5]) & 0x03FFFF;
+        count -= n;
+    }
+    return true;
+}
+
+template <class Bus>
+bool MAX30102T<Bus>::readAllFIFO(std::vector<std::pair<uint32_t, uint32_t>> &outSamples) {
+    outSamples.clear();
+    uint8_t count = getFifoCount();
+    if (count == 0) return false;
+    while (count > 0) {
+        uint8_t n = count;
+        if (n > FIFO_BURST) n = FIFO_BURST;
+        uint8_t data[6 * FIFO_BURST];
+        if (!readRegisters(REG_FIFO_DATA, data, 6 * n)) return !outSamples.empty();
+
+        for (uint8_t i = 0; i < n; i++) {
+            const uint8_t *d = data + 6 * i;
+            uint32_t tmpRed = ((uint32_t)d[0] << 16) | ((uint32_t)d[1] << 8) | d[2];
+            uint32_t tmpIR  = ((uint32_t)d[3] << 16) | ((uint32_t)d[4] << 8) | d[5];
+            tmpRed &= 0x03FFFF;
+            tmpIR  &= 0x03FFFF;
+            outSamples.emplace_back(tmpRed, tmpIR);
+        }
+        count -= n;
+    }
+    return true;
+}
+
+// ---------- Temperature ----------
+
+template <class Bus>
+void MAX30102T<Bus>::startTemperature() {
+    writeRegister(REG_TEMP_CONFIG, 0x01);
+}
+
+template <class Bus>
+bool MAX30102T<Bus>::isTemperatureReady() {
+    return (readRegister(REG_INTR_STATUS_2) & 0x02) != 0;
+}
+
+template <class Bus>
+float MAX30102T<Bus>::readTemperature() {
+    int8_t tempInt = (int8_t)readRegister(REG_TEMP_INT);
+    uint8_t tempFrac = readRegister(REG_TEMP_FRAC);
+    return (float)tempInt + (tempFrac * 0.0625f);
+}
+
+// ---------- Device Info ----------
+
+template <class Bus>
+uint8_t MAX30102T<Bus>::getRevisionID() {
+    return readRegister(REG_REV_ID);
+}
+
+template <class Bus>
+uint8_t MAX30102T<Bus>::getPartID() {
+    return readRegister(REG_PART_ID);
+}
+
+// ---------- Low-level I2C ----------
+
+template <class Bus>
+uint8_t MAX30102T<Bus>::readRegister(uint8_t reg) {
+    uint8_t value = 0;
+    return readRegisters(reg, &value, 1) ? value : 0;
+}
+
+template <class Bus>
+void MAX30102T<Bus>::writeRegister(uint8_t reg, uint8_t value) {
+    uint8_t tx[2] = { reg, value };
+    _bus.write(_i2caddr, tx, 2);
+}
+
+template <class Bus>
+void MAX30102T<Bus>::writeRegisters(uint8_t reg, const uint8_t *data, uint8_t len) {
+    uint8_t tx[8];
+    if (len > sizeof(tx) - 1) len = sizeof(tx) - 1;
+    tx[0] = reg;
+    for (uint8_t i = 0; i < len; i++) tx[i + 1] = data[i];
+    _bus.write(_i2caddr, tx, len + 1);
+}
+
+template <class Bus>
+bool MAX30102T<Bus>::readRegisters(uint8_t reg, uint8_t *data, uint8_t len) {
+    return _bus.writeRead(_i2caddr, &reg, 1, data, len);
+}
+
+#ifdef ARDUINO
+#include "COMP_BUS_WIRE.h"
+
+// Existing name: driver over Arduino Wire
+typedef MAX30102T<WireBus> MAX30102;
+#endif
+
 #endif // LIB_MAX30102_H
\ No newline at end of file
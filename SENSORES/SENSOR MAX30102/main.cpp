@@ -2,6 +2,7 @@
 #include "LIB_MAX30102.h"
 #include "COMP_RITMO_CARDIACO.h"
 #include "COMP_SPO2.h"
+#include "COMP_PRESENCIA.h"
 
 // Finger‐presence thresholds (with hysteresis)
 constexpr uint32_t FINGER_TH_ON  = 30000;  // rawIR above → finger placed
@@ -17,6 +18,7 @@ constexpr float DC_ALPHA = 0.95f;
 MAX30102           sensor;
 HeartRateProcessor hrProcessor;
 SpO2Processor      spo2Processor;
+PresenceMonitor    presence;
 
 uint32_t lastSerialPrint = 0;
 bool     fingerPresent   = false;
@@ -36,12 +38,36 @@ void setup() {
   }
   sensor.setup();
 
+  // Start idle: dim IR only until something is on the sensor
+  sensor.applyPresenceProfile();
+  presence.begin(PRESENCE_IDLE, millis());
+
   hrProcessor.reset();
   spo2Processor.reset();
   lastSerialPrint = millis();
 }
 
+void printPresenceTimes(uint32_t now) {
+  Serial.print(F("Time active: "));
+  Serial.print(presence.getTimeMs(PRESENCE_ACTIVE, now) / 1000.0f, 1);
+  Serial.print(F(" s, idle: "));
+  Serial.print(presence.getTimeMs(PRESENCE_IDLE, now) / 1000.0f, 1);
+  Serial.println(F(" s"));
+}
+
 void loop() {
+  // 0) Idle: check the newest sample once per FIFO period, no DSP
+  if (presence.getState() == PRESENCE_IDLE) {
+    uint32_t now = millis();
+    uint32_t red, ir;
+    if (presence.isCheckDue(now) && sensor.readFIFO(red, ir) && presence.checkIdle(ir, now)) {
+      Serial.println(F("\n-- Presence detected, full acquisition --"));
+      printPresenceTimes(now);
+      sensor.applyProfile(PROFILE_STANDARD);
+    }
+    return;
+  }
+
   // 1) Read all new samples (no delay if empty)
   std::vector<std::pair<uint32_t,uint32_t>> samples;
   if (!sensor.readAllFIFO(samples)) {
@@ -85,6 +111,18 @@ void loop() {
     spo2Processor.update(acIR, acRed, beat);
   }
 
+  // 2e) Nothing on the sensor for a while: back to idle
+  if (presence.checkActive(fingerPresent, now)) {
+    Serial.println(F("\n-- No presence, sensor idle --"));
+    printPresenceTimes(now);
+    sensor.applyPresenceProfile();
+    hrProcessor.reset();
+    spo2Processor.reset();
+    dcIR = 0.0f;
+    dcRed = 0.0f;
+    return;
+  }
+
   // 3) Periodic Serial update
   if (fingerPresent && (now - lastSerialPrint >= SERIAL_UPDATE_INTERVAL)) {
     // 3a) Get raw BPM and apply plausibility filter (40–180 BPM)
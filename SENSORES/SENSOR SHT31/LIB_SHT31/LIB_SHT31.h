@@ -1,10 +1,13 @@
 #ifndef _SHT31_H_
 #define _SHT31_H_
 
-#include <Arduino.h>
-#include <Wire.h>
+#include <stdint.h>
+#include <math.h>
+#include "COMP_BUS.h"
+#include "COMP_PLATAFORMA.h"
 
-class SHT31 {
+// Parte común del driver (independiente del bus)
+class SHT31Base {
 public:
     // Direcciones I2C según pin ADDR
     static constexpr uint8_t ADDR_0x44 = 0x44; // ADDR→GND
@@ -32,12 +35,65 @@ public:
         ERROR_UNKNOWN
     };
 
+    // Devuelve el último código de error
+    ErrorCode getError() const;
+
+    // Devuelve mensaje de error asociado
+    const char* getErrorMessage() const;
+
+    // Tiempo del soft reset (máx. 1.5 ms según hoja de datos)
+    static constexpr uint32_t RESET_MS = 2;
+
+protected:
+    explicit SHT31Base(uint8_t addr);
+
+    uint8_t  _addr;
+    ErrorCode _error;
+
+    // Estado de la medición no bloqueante
+    uint8_t  _raw[6];
+    bool     _pending;
+    bool     _ready;
+    uint32_t _requestMs;
+
+    // Conversión raw -> valor físico
+    static constexpr float TEMP_OFFSET = -45.0f;
+    static constexpr float TEMP_SCALE  = 175.0f;
+    static constexpr float HUM_SCALE   = 100.0f;
+
+    // Tiempo de conversión en alta repetibilidad (máx. 15 ms)
+    static constexpr uint32_t CONVERSION_MS = 15;
+    static constexpr uint32_t MAX_CLOCK_HZ  = 1000000;
+
+    // Verifica CRC de un bloque de 6 bytes y extrae valores crudos
+    bool parseRaw(const uint8_t *buf, uint16_t &rawTemp, uint16_t &rawHum);
+
+    // Conversión de valores crudos a °C y % RH
+    static void convert(uint16_t rawTemp, uint16_t rawHum,
+                        float &temperature, float &humidity);
+
+    // Fin de la lectura encolada en el gestor de bus
+    static void onReadDone(void *context, bool ok);
+
+    // CRC-8 polinomio 0x31, init 0xFF
+    static uint8_t crc8(const uint8_t *data, uint8_t len);
+};
+
+// Driver SHT31 sobre cualquier bus que cumpla el concepto de COMP_BUS.h
+template <class Bus>
+class SHT31T : public SHT31Base {
+public:
     //(bus I2C y dirección opcionales)
-    SHT31(TwoWire &wire = Wire, uint8_t addr = ADDR_0x44);
+    SHT31T(Bus bus = Bus(), uint8_t addr = ADDR_0x44);
 
     // Inicializa comunicación I2C
     bool begin();
 
+    // Como begin() pero sin esperar el soft reset: el sensor acepta
+    // comandos RESET_MS después. Descarta una medición pendiente (p. ej.
+    // de antes de una desconexión)
+    bool beginAsync();
+
     // Lee temperatura (°C) y humedad (% RH)
     // Devuelve true si la lectura es exitosa
     bool read(float &temperature, float &humidity,
@@ -52,27 +108,24 @@ public:
     float readHumidity(Repeatability rep = REP_HIGH,
                        ClockStretch cs = CS_ENABLE);
 
+    // Medición no bloqueante: envía el comando sin clock-stretching y
+    // deja la lectura encolada (bus con cola) o pendiente de tiempo.
+    bool requestMeasurement();
+
+    // true cuando la conversión solicitada terminó
+    bool isMeasurementReady();
+
+    // Entrega el resultado de requestMeasurement()
+    bool getMeasurement(float &temperature, float &humidity);
+
     // Soft-reset (comando 0x30A2)
     bool softReset();
 
     // Limpia registro de estado (comando 0x3041)
     bool clearStatus();
 
-    // Devuelve el último código de error
-    ErrorCode getError() const;
-
-    // Devuelve mensaje de error asociado
-    const char* getErrorMessage() const;
-
 private:
-    TwoWire &_wire;
-    uint8_t  _addr;
-    ErrorCode _error;
-
-    // Conversión raw -> valor físico
-    static constexpr float TEMP_OFFSET = -45.0f;
-    static constexpr float TEMP_SCALE  = 175.0f;
-    static constexpr float HUM_SCALE   = 100.0f;
+    Bus _bus;
 
     // Envía comando de 16 bits
     bool sendCommand(uint16_t cmd);
@@ -80,8 +133,180 @@ private:
     // Lee datos crudos y verifica CRC
     bool readRaw(uint16_t &rawTemp, uint16_t &rawHum);
 
-    // CRC-8 polinomio 0x31, init 0xFF
-    static uint8_t crc8(const uint8_t *data, uint8_t len);
+    // Lectura de 6 bytes sin comando previo
+    bool readBytes(uint8_t *buf);
 };
 
+// Constructor
+template <class Bus>
+SHT31T<Bus>::SHT31T(Bus bus, uint8_t addr)
+  : SHT31Base(addr), _bus(bus) {}
+
+// Inicia I2C y hace soft reset para verificar conexión
+template <class Bus>
+bool SHT31T<Bus>::begin() {
+    _bus.attach(_addr, MAX_CLOCK_HZ, 0);
+    if (!softReset()) {
+        _error = ERROR_NOT_CONNECTED;
+        return false;
+    }
+    _error = ERROR_NONE;
+    return true;
+}
+
+// Inicio sin bloqueo: soft reset enviado, sin esperar a que termine
+template <class Bus>
+bool SHT31T<Bus>::beginAsync() {
+    _bus.attach(_addr, MAX_CLOCK_HZ, 0);
+    _pending = false;
+    _ready = false;
+    if (!sendCommand(0x30A2)) {
+        _error = ERROR_NOT_CONNECTED;
+        return false;
+    }
+    _error = ERROR_NONE;
+    return true;
+}
+
+// Lectura de temperatura y humedad (usa readRaw y conversión)
+template <class Bus>
+bool SHT31T<Bus>::read(float &temperature, float &humidity,
+                       Repeatability /*rep*/, ClockStretch /*cs*/) {
+    uint16_t rawT, rawH;
+    if (!readRaw(rawT, rawH)) {
+        return false;
+    }
+    convert(rawT, rawH, temperature, humidity);
+    return true;
+}
+
+// Lee solo temperatura
+template <class Bus>
+float SHT31T<Bus>::readTemperature(Repeatability rep, ClockStretch cs) {
+    float h;
+    float t;
+    if (read(t, h, rep, cs)) return t;
+    return NAN;
+}
+
+// Lee solo humedad
+template <class Bus>
+float SHT31T<Bus>::readHumidity(Repeatability rep, ClockStretch cs) {
+    float t;
+    float h;
+    if (read(t, h, rep, cs)) return h;
+    return NAN;
+}
+
+// Solicita una medición sin bloquear (alta repetibilidad, sin clock-stretching)
+template <class Bus>
+bool SHT31T<Bus>::requestMeasurement() {
+    if (_pending) return false;
+    uint8_t cmd[2] = { 0x24, 0x00 };
+    _ready = false;
+    _requestMs = millis();
+    if (Bus::DEFERRED) {
+        // Comando y lectura quedan en la cola de baja prioridad
+        uint32_t nowUs = micros();
+        if (!_bus.submit(_addr, cmd, 2, nullptr, 0, nowUs, nullptr, nullptr) ||
+            !_bus.submit(_addr, nullptr, 0, _raw, 6, nowUs + CONVERSION_MS * 1000,
+                         onReadDone, static_cast<SHT31Base *>(this))) {
+            _error = ERROR_TIMEOUT;
+            return false;
+        }
+    } else if (!sendCommand(0x2400)) {
+        _error = ERROR_NOT_CONNECTED;
+        return false;
+    }
+    _pending = true;
+    return true;
+}
+
+// Indica si la conversión solicitada terminó
+template <class Bus>
+bool SHT31T<Bus>::isMeasurementReady() {
+    if (Bus::DEFERRED) return _ready;
+    return _pending && (millis() - _requestMs >= CONVERSION_MS);
+}
+
+// Devuelve el resultado de la medición solicitada
+template <class Bus>
+bool SHT31T<Bus>::getMeasurement(float &temperature, float &humidity) {
+    if (!isMeasurementReady()) return false;
+    if (!Bus::DEFERRED) {
+        _pending = false;
+        if (!readBytes(_raw)) {
+            _error = ERROR_TIMEOUT;
+            return false;
+        }
+    }
+    _ready = false;
+
+    uint16_t rawT, rawH;
+    if (!parseRaw(_raw, rawT, rawH)) return false;
+    convert(rawT, rawH, temperature, humidity);
+    return true;
+}
+
+// Soft reset (comando 0x30A2)
+template <class Bus>
+bool SHT31T<Bus>::softReset() {
+    if (!sendCommand(0x30A2)) {
+        _error = ERROR_NOT_CONNECTED;
+        return false;
+    }
+    delay(1);
+    _error = ERROR_NONE;
+    return true;
+}
+
+// Limpia registro de estado (comando 0x3041)
+template <class Bus>
+bool SHT31T<Bus>::clearStatus() {
+    if (!sendCommand(0x3041)) {
+        _error = ERROR_NOT_CONNECTED;
+        return false;
+    }
+    _error = ERROR_NONE;
+    return true;
+}
+
+// Envía comando de 16 bits al sensor
+template <class Bus>
+bool SHT31T<Bus>::sendCommand(uint16_t cmd) {
+    uint8_t tx[2] = { uint8_t(cmd >> 8), uint8_t(cmd & 0xFF) };
+    return _bus.write(_addr, tx, 2);
+}
+
+// Lee datos crudos y verifica CRC
+template <class Bus>
+bool SHT31T<Bus>::readRaw(uint16_t &rawTemp, uint16_t &rawHum) {
+    _error = ERROR_NONE;
+    if (!sendCommand(0x2C06)) { // High repeatability + CRC
+        _error = ERROR_NOT_CONNECTED;
+        return false;
+    }
+    delay(15); 
+
+    uint8_t buf[6];
+    if (!readBytes(buf)) {
+        _error = ERROR_TIMEOUT;
+        return false;
+    }
+    return parseRaw(buf, rawTemp, rawHum);
+}
+
+// Lee 6 bytes del sensor
+template <class Bus>
+bool SHT31T<Bus>::readBytes(uint8_t *buf) {
+    return _bus.writeRead(_addr, nullptr, 0, buf, 6);
+}
+
+#ifdef ARDUINO
+#include "COMP_BUS_WIRE.h"
+
+// Nombre existente: driver sobre Arduino Wire
+typedef SHT31T<WireBus> SHT31;
+#endif
+
 #endif // _SHT31_H_
@@ -0,0 +1,85 @@
+#ifndef COMP_BUS_H
+#define COMP_BUS_H
+
+#include <stdint.h>
+
+// Completion callback for deferred transactions
+typedef void (*I2CCallback)(void *context, bool ok);
+
+/**
+ *  I2C bus concept used as template parameter by the drivers.
+ *
+ *  A bus is a small copyable handle to the real controller. Drivers keep
+ *  it by value and call it directly, so every transfer is resolved at
+ *  compile time (no virtual calls). A conforming type provides:
+ *
+ *    static constexpr bool    DEFERRED;      // submit() is implemented
+ *    static constexpr uint8_t MAX_TRANSFER;  // largest single read (bytes)
+ *
+ *    bool attach(uint8_t address, uint32_t maxClockHz, uint32_t clockHz);
+ *    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen);
+ *    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+ *                   uint8_t *rx, uint8_t rxLen);
+ *    bool submit(uint8_t address, const uint8_t *tx, uint8_t txLen,
+ *                uint8_t *rx, uint8_t rxLen, uint32_t notBeforeUs,
+ *                I2CCallback done, void *context);
+ *
+ *  attach() is called by a driver's begin(): maxClockHz is the fastest
+ *  clock the device supports and clockHz the clock it asks for (0 keeps
+ *  the current one). writeRead() uses a repeated start between phases;
+ *  txLen or rxLen may be 0.
+ */
+#if defined(__cpp_concepts) && __cpp_concepts >= 201907L
+#include <concepts>
+
+template <class B>
+concept I2CBus = requires(B b, uint8_t a, const uint8_t *tx, uint8_t *rx, uint8_t n,
+                          uint32_t hz, I2CCallback cb, void *ctx) {
+    { B::DEFERRED } -> std::convertible_to<bool>;
+    { B::MAX_TRANSFER } -> std::convertible_to<uint8_t>;
+    { b.attach(a, hz, hz) } -> std::same_as<bool>;
+    { b.write(a, tx, n) } -> std::same_as<bool>;
+    { b.writeRead(a, tx, n, rx, n) } -> std::same_as<bool>;
+    { b.submit(a, tx, n, rx, n, hz, cb, ctx) } -> std::same_as<bool>;
+};
+
+#define I2C_BUS_CHECK(B) static_assert(I2CBus<B>, "type does not model the I2C bus concept")
+#else
+#define I2C_BUS_CHECK(B) static_assert(sizeof(B) > 0, "")
+#endif
+
+/**
+ *  Handle to a bus object that must be shared (e.g. the bus manager):
+ *  forwards every call to the referenced instance.
+ */
+template <class Target>
+class BusRef {
+public:
+    static constexpr bool    DEFERRED     = Target::DEFERRED;
+    static constexpr uint8_t MAX_TRANSFER = Target::MAX_TRANSFER;
+
+    BusRef(Target &target) : _target(&target) {}
+
+    bool attach(uint8_t address, uint32_t maxClockHz, uint32_t clockHz) {
+        return _target->attach(address, maxClockHz, clockHz);
+    }
+    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen) {
+        return _target->write(address, tx, txLen);
+    }
+    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                   uint8_t *rx, uint8_t rxLen) {
+        return _target->writeRead(address, tx, txLen, rx, rxLen);
+    }
+    bool submit(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                uint8_t *rx, uint8_t rxLen, uint32_t notBeforeUs,
+                I2CCallback done, void *context) {
+        return _target->submit(address, tx, txLen, rx, rxLen, notBeforeUs, done, context);
+    }
+
+    Target &target() { return *_target; }
+
+private:
+    Target *_target;
+};
+
+#endif // COMP_BUS_H
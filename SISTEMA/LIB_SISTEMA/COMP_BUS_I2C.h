@@ -0,0 +1,303 @@
+#ifndef COMP_BUS_I2C_H
+#define COMP_BUS_I2C_H
+
+#include <stdint.h>
+#include "COMP_BUS.h"
+#include "COMP_PLATAFORMA.h"
+
+// Maximum number of devices registered on one bus
+#ifndef I2C_BUS_MAX_DEVICES
+#define I2C_BUS_MAX_DEVICES 8
+#endif
+
+// Depth of the deferred (low priority) transaction queue
+#ifndef I2C_BUS_QUEUE_SIZE
+#define I2C_BUS_QUEUE_SIZE 8
+#endif
+
+// Per-device traffic counters
+struct I2CDeviceStats {
+    uint8_t  address;
+    uint32_t maxClockHz;      // fastest clock the device supports
+    uint32_t transactions;
+    uint32_t errors;          // transactions that failed after all retries
+    uint32_t retries;
+    uint32_t totalLatencyUs;
+    uint32_t maxLatencyUs;
+};
+
+/**
+ *  Owner of one I2C controller (any type modelling the bus concept, see
+ *  COMP_BUS.h). Devices attach with the clock they support and the bus
+ *  runs at the fastest speed all of them accept.
+ *  High priority transactions run immediately; low priority ones are
+ *  queued and only executed from process(), so a sensor conversion
+ *  never sits in front of a PPG FIFO drain.
+ *  Drivers use it through BusRef<I2CBusManagerT<...>>.
+ */
+template <class Bus>
+class I2CBusManagerT {
+public:
+    static constexpr bool    DEFERRED     = true;
+    static constexpr uint8_t MAX_TRANSFER = Bus::MAX_TRANSFER;
+
+    // Bus speeds
+    static constexpr uint32_t CLOCK_STANDARD  = 100000;
+    static constexpr uint32_t CLOCK_FAST      = 400000;
+    static constexpr uint32_t CLOCK_FAST_PLUS = 1000000;
+
+    I2CBusManagerT(Bus bus);
+
+    // Reset statistics; devices may attach before or after
+    bool begin();
+    uint32_t getClock() const;
+
+    /**
+     *  Register a device and renegotiate the bus clock.
+     *  @param address     7-bit I2C address
+     *  @param maxClockHz  Fastest clock supported by the device
+     *  @param clockHz     Ignored: the manager picks the clock
+     *  @return false if the device table is full
+     */
+    bool attach(uint8_t address, uint32_t maxClockHz, uint32_t clockHz = 0);
+
+    /**
+     *  Write then (optionally) read with a repeated start. NACKs and short
+     *  reads are retried with bounded exponential backoff.
+     *  @return true on success
+     */
+    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                   uint8_t *rx, uint8_t rxLen);
+    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen);
+
+    /**
+     *  Queue a low priority transaction. It runs from process() once
+     *  notBeforeUs has been reached (micros() timestamp).
+     *  @return false if the queue is full
+     */
+    bool submit(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                uint8_t *rx, uint8_t rxLen, uint32_t notBeforeUs,
+                I2CCallback done = nullptr, void *context = nullptr);
+
+    /**
+     *  Run queued transactions that are due, spending at most budgetUs.
+     *  Call it after the high priority work of each loop iteration.
+     */
+    void process(uint32_t budgetUs);
+
+    // Statistics
+    const I2CDeviceStats *getDeviceStats(uint8_t address) const;
+    uint8_t getDeviceCount() const;
+    const I2CDeviceStats &getDeviceStatsAt(uint8_t index) const;
+    float getUtilization() const;   // busy time / elapsed time since resetStats()
+    uint8_t getQueueLength() const;
+    void resetStats();
+
+    Bus &bus();
+
+private:
+    struct Job {
+        uint8_t  address;
+        uint8_t  tx[4];
+        uint8_t  txLen;
+        uint8_t *rx;
+        uint8_t  rxLen;
+        uint32_t notBeforeUs;
+        I2CCallback done;
+        void    *context;
+    };
+
+    Bus      _bus;
+    uint32_t _clock;
+
+    I2CDeviceStats _devices[I2C_BUS_MAX_DEVICES];
+    uint8_t _deviceCount;
+
+    Job     _queue[I2C_BUS_QUEUE_SIZE];
+    uint8_t _queueLen;
+
+    uint32_t _busyUs;
+    uint32_t _statsStartUs;
+
+    static constexpr uint8_t  MAX_RETRIES      = 3;
+    static constexpr uint32_t BACKOFF_START_US = 50;
+
+    I2CDeviceStats *findDevice(uint8_t address);
+};
+
+template <class Bus>
+I2CBusManagerT<Bus>::I2CBusManagerT(Bus bus)
+    : _bus(bus), _clock(CLOCK_STANDARD), _deviceCount(0), _queueLen(0),
+      _busyUs(0), _statsStartUs(0) {
+}
+
+template <class Bus>
+bool I2CBusManagerT<Bus>::begin() {
+    resetStats();
+    return true;
+}
+
+template <class Bus>
+uint32_t I2CBusManagerT<Bus>::getClock() const {
+    return _clock;
+}
+
+template <class Bus>
+bool I2CBusManagerT<Bus>::attach(uint8_t address, uint32_t maxClockHz, uint32_t /*clockHz*/) {
+    I2CDeviceStats *dev = findDevice(address);
+    if (dev == nullptr) {
+        if (_deviceCount >= I2C_BUS_MAX_DEVICES) return false;
+        dev = &_devices[_deviceCount++];
+        dev->address = address;
+        dev->transactions = 0;
+        dev->errors = 0;
+        dev->retries = 0;
+        dev->totalLatencyUs = 0;
+        dev->maxLatencyUs = 0;
+    }
+    dev->maxClockHz = maxClockHz;
+
+    // Fastest clock every attached device accepts
+    uint32_t clock = CLOCK_FAST_PLUS;
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        if (_devices[i].maxClockHz < clock) clock = _devices[i].maxClockHz;
+    }
+    _clock = clock;
+    return _bus.attach(address, maxClockHz, _clock);
+}
+
+// ---------- Transactions ----------
+
+template <class Bus>
+bool I2CBusManagerT<Bus>::writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                                    uint8_t *rx, uint8_t rxLen) {
+    I2CDeviceStats *dev = findDevice(address);
+    uint32_t start = micros();
+    uint32_t backoff = BACKOFF_START_US;
+    bool ok = _bus.writeRead(address, tx, txLen, rx, rxLen);
+    for (uint8_t attempt = 0; !ok && attempt < MAX_RETRIES; attempt++) {
+        delayMicroseconds(backoff);
+        backoff *= 2;
+        if (dev != nullptr) dev->retries++;
+        ok = _bus.writeRead(address, tx, txLen, rx, rxLen);
+    }
+    uint32_t elapsed = micros() - start;
+    _busyUs += elapsed;
+
+    if (dev != nullptr) {
+        dev->transactions++;
+        if (!ok) dev->errors++;
+        dev->totalLatencyUs += elapsed;
+        if (elapsed > dev->maxLatencyUs) dev->maxLatencyUs = elapsed;
+    }
+    return ok;
+}
+
+template <class Bus>
+bool I2CBusManagerT<Bus>::write(uint8_t address, const uint8_t *tx, uint8_t txLen) {
+    return writeRead(address, tx, txLen, nullptr, 0);
+}
+
+template <class Bus>
+bool I2CBusManagerT<Bus>::submit(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                                 uint8_t *rx, uint8_t rxLen, uint32_t notBeforeUs,
+                                 I2CCallback done, void *context) {
+    if (_queueLen >= I2C_BUS_QUEUE_SIZE || txLen > sizeof(_queue[0].tx)) return false;
+    Job &job = _queue[_queueLen++];
+    job.address = address;
+    for (uint8_t i = 0; i < txLen; i++) job.tx[i] = tx[i];
+    job.txLen = txLen;
+    job.rx = rx;
+    job.rxLen = rxLen;
+    job.notBeforeUs = notBeforeUs;
+    job.done = done;
+    job.context = context;
+    return true;
+}
+
+template <class Bus>
+void I2CBusManagerT<Bus>::process(uint32_t budgetUs) {
+    uint32_t start = micros();
+    uint8_t i = 0;
+    while (i < _queueLen && (micros() - start) < budgetUs) {
+        // Due when notBeforeUs is not in the future (wrap-safe)
+        if ((int32_t)(micros() - _queue[i].notBeforeUs) < 0) {
+            i++;
+            continue;
+        }
+        Job job = _queue[i];
+        for (uint8_t k = i + 1; k < _queueLen; k++) _queue[k - 1] = _queue[k];
+        _queueLen--;
+
+        bool ok = writeRead(job.address, job.tx, job.txLen, job.rx, job.rxLen);
+        if (job.done != nullptr) job.done(job.context, ok);
+    }
+}
+
+// ---------- Statistics ----------
+
+template <class Bus>
+const I2CDeviceStats *I2CBusManagerT<Bus>::getDeviceStats(uint8_t address) const {
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        if (_devices[i].address == address) return &_devices[i];
+    }
+    return nullptr;
+}
+
+template <class Bus>
+uint8_t I2CBusManagerT<Bus>::getDeviceCount() const {
+    return _deviceCount;
+}
+
+template <class Bus>
+const I2CDeviceStats &I2CBusManagerT<Bus>::getDeviceStatsAt(uint8_t index) const {
+    return _devices[index];
+}
+
+template <class Bus>
+float I2CBusManagerT<Bus>::getUtilization() const {
+    uint32_t elapsed = micros() - _statsStartUs;
+    if (elapsed == 0) return 0.0f;
+    return (float)_busyUs / (float)elapsed;
+}
+
+template <class Bus>
+uint8_t I2CBusManagerT<Bus>::getQueueLength() const {
+    return _queueLen;
+}
+
+template <class Bus>
+void I2CBusManagerT<Bus>::resetStats() {
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        _devices[i].transactions = 0;
+        _devices[i].errors = 0;
+        _devices[i].retries = 0;
+        _devices[i].totalLatencyUs = 0;
+        _devices[i].maxLatencyUs = 0;
+    }
+    _busyUs = 0;
+    _statsStartUs = micros();
+}
+
+template <class Bus>
+Bus &I2CBusManagerT<Bus>::bus() {
+    return _bus;
+}
+
+template <class Bus>
+I2CDeviceStats *I2CBusManagerT<Bus>::findDevice(uint8_t address) {
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        if (_devices[i].address == address) return &_devices[i];
+    }
+    return nullptr;
+}
+
+#ifdef ARDUINO
+#include "COMP_BUS_WIRE.h"
+
+// Manager over Arduino Wire, and the handle drivers use to reach it
+typedef I2CBusManagerT<WireBus> I2CBusManager;
+typedef BusRef<I2CBusManager>   ManagedBus;
+#endif
+
+#endif // COMP_BUS_I2C_H
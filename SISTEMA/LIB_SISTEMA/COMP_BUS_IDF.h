@@ -0,0 +1,105 @@
+#ifndef COMP_BUS_IDF_H
+#define COMP_BUS_IDF_H
+
+// Bus adapter for the ESP-IDF (>= 5.2) i2c_master driver. Transfers go
+// straight to the controller, so a whole MAX30102 FIFO (32 samples,
+// 192 bytes) is fetched in a single burst instead of Wire-sized chunks.
+#if defined(ESP_PLATFORM) && defined(__has_include)
+#if __has_include(<driver/i2c_master.h>)
+
+#include <driver/i2c_master.h>
+#include "COMP_BUS.h"
+
+#ifndef IDF_BUS_MAX_DEVICES
+#define IDF_BUS_MAX_DEVICES 8
+#endif
+
+// Owner of an i2c_master bus handle and its per-address device handles
+class IdfI2CController {
+public:
+    static constexpr int TIMEOUT_MS = 10;
+
+    explicit IdfI2CController(i2c_master_bus_handle_t bus)
+        : _bus(bus), _count(0) {}
+
+    bool attach(uint8_t address, uint32_t maxClockHz, uint32_t clockHz) {
+        if (find(address) != nullptr) return true;
+        if (_count >= IDF_BUS_MAX_DEVICES) return false;
+
+        // The IDF clocks each device separately: use its full speed unless
+        // the driver asked for less
+        uint32_t hz = (clockHz != 0 && clockHz < maxClockHz) ? clockHz : maxClockHz;
+        i2c_device_config_t cfg = {};
+        cfg.dev_addr_length = I2C_ADDR_BIT_LEN_7;
+        cfg.device_address = address;
+        cfg.scl_speed_hz = hz;
+        i2c_master_dev_handle_t dev;
+        if (i2c_master_bus_add_device(_bus, &cfg, &dev) != ESP_OK) return false;
+        _address[_count] = address;
+        _dev[_count] = dev;
+        _count++;
+        return true;
+    }
+
+    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen) {
+        i2c_master_dev_handle_t dev = find(address);
+        if (dev == nullptr) return false;
+        return i2c_master_transmit(dev, tx, txLen, TIMEOUT_MS) == ESP_OK;
+    }
+
+    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                   uint8_t *rx, uint8_t rxLen) {
+        i2c_master_dev_handle_t dev = find(address);
+        if (dev == nullptr) return false;
+        if (rxLen == 0) return i2c_master_transmit(dev, tx, txLen, TIMEOUT_MS) == ESP_OK;
+        if (txLen == 0) return i2c_master_receive(dev, rx, rxLen, TIMEOUT_MS) == ESP_OK;
+        return i2c_master_transmit_receive(dev, tx, txLen, rx, rxLen, TIMEOUT_MS) == ESP_OK;
+    }
+
+private:
+    i2c_master_bus_handle_t _bus;
+    uint8_t _address[IDF_BUS_MAX_DEVICES];
+    i2c_master_dev_handle_t _dev[IDF_BUS_MAX_DEVICES];
+    uint8_t _count;
+
+    i2c_master_dev_handle_t find(uint8_t address) {
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_address[i] == address) return _dev[i];
+        }
+        return nullptr;
+    }
+};
+
+// Copyable handle used as the drivers' Bus parameter
+class IdfBus {
+public:
+    static constexpr bool    DEFERRED     = false;
+    static constexpr uint8_t MAX_TRANSFER = 255;
+
+    IdfBus(IdfI2CController &controller) : _ctl(&controller) {}
+
+    bool attach(uint8_t address, uint32_t maxClockHz, uint32_t clockHz) {
+        return _ctl->attach(address, maxClockHz, clockHz);
+    }
+    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen) {
+        return _ctl->write(address, tx, txLen);
+    }
+    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                   uint8_t *rx, uint8_t rxLen) {
+        return _ctl->writeRead(address, tx, txLen, rx, rxLen);
+    }
+    bool submit(uint8_t, const uint8_t *, uint8_t, uint8_t *, uint8_t,
+                uint32_t, I2CCallback, void *) {
+        return false;
+    }
+
+private:
+    IdfI2CController *_ctl;
+};
+
+I2C_BUS_CHECK(IdfBus);
+
+#endif // __has_include(<driver/i2c_master.h>)
+#endif // ESP_PLATFORM
+
+#endif // COMP_BUS_IDF_H
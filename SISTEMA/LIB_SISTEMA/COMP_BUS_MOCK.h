@@ -0,0 +1,291 @@
+#ifndef COMP_BUS_MOCK_H
+#define COMP_BUS_MOCK_H
+
+// Host-side emulated I2C bus and devices. Lets the drivers, the bus
+// manager and the channel table run on Linux for fuzzing, benchmarks and
+// multi-sensor verification. Not meant for the target.
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "COMP_BUS.h"
+#include "COMP_PLATAFORMA.h"
+
+#ifndef MOCK_BUS_MAX_DEVICES
+#define MOCK_BUS_MAX_DEVICES 16
+#endif
+
+// Emulated device interface (host only, so virtual calls are fine here)
+class MockI2CDevice {
+public:
+    virtual ~MockI2CDevice() {}
+    // Bytes written in one transaction; false = NACK
+    virtual bool onWrite(const uint8_t *data, uint8_t len) = 0;
+    // Bytes requested by a read; false = NACK
+    virtual bool onRead(uint8_t *data, uint8_t len) = 0;
+};
+
+// Shared emulated controller
+class MockI2CBus {
+public:
+    static constexpr uint8_t NO_MUX = 0xFF;
+
+    MockI2CBus()
+        : _count(0), _muxMask(0), _clockHz(100000), _failNext(0),
+          _advanceClock(false), _transactions(0), _bytes(0), _busTimeUs(0) {}
+
+    /**
+     *  Connect an emulated device.
+     *  @param port  TCA9548A port it sits behind, NO_MUX if direct
+     */
+    bool addDevice(uint8_t address, MockI2CDevice *dev, uint8_t port = NO_MUX) {
+        if (_count >= MOCK_BUS_MAX_DEVICES) return false;
+        _address[_count] = address;
+        _port[_count] = port;
+        _dev[_count] = dev;
+        _count++;
+        return true;
+    }
+
+    // Ports currently enabled by the emulated multiplexer
+    void setMuxMask(uint8_t mask) { _muxMask = mask; }
+
+    // Fault injection: NACK the next n transactions
+    void failNext(uint32_t n) { _failNext = n; }
+
+    // Let every transaction take its bus time on the platform clock, so
+    // with PLATFORM_SIMULATED_TIME only I2C moves micros()
+    void setAdvanceClock(bool enable) { _advanceClock = enable; }
+
+    bool attach(uint8_t, uint32_t, uint32_t clockHz) {
+        if (clockHz != 0) _clockHz = clockHz;
+        return true;
+    }
+
+    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen) {
+        return writeRead(address, tx, txLen, nullptr, 0);
+    }
+
+    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                   uint8_t *rx, uint8_t rxLen) {
+        _transactions++;
+        _bytes += txLen + rxLen;
+        // 9 clocks per byte plus address bytes and start/stop
+        uint32_t clocks = 9 * (txLen + rxLen) + 9 * ((txLen > 0) + (rxLen > 0)) + 2;
+        uint32_t us = (uint32_t)((uint64_t)clocks * 1000000ull / _clockHz);
+        _busTimeUs += us;
+        if (_advanceClock) delayMicroseconds(us);
+
+        if (_failNext > 0) {
+            _failNext--;
+            return false;
+        }
+        MockI2CDevice *dev = find(address);
+        if (dev == nullptr) return false;
+        if (txLen > 0 && !dev->onWrite(tx, txLen)) return false;
+        if (rxLen > 0 && !dev->onRead(rx, rxLen)) return false;
+        return true;
+    }
+
+    uint32_t getClock() const { return _clockHz; }
+    uint32_t getTransactions() const { return _transactions; }
+    uint64_t getBytes() const { return _bytes; }
+    uint64_t getBusTimeUs() const { return _busTimeUs; }
+
+private:
+    uint8_t _address[MOCK_BUS_MAX_DEVICES];
+    uint8_t _port[MOCK_BUS_MAX_DEVICES];
+    MockI2CDevice *_dev[MOCK_BUS_MAX_DEVICES];
+    uint8_t _count;
+    uint8_t _muxMask;
+    uint32_t _clockHz;
+    uint32_t _failNext;
+    bool     _advanceClock;
+    uint32_t _transactions;
+    uint64_t _bytes;
+    uint64_t _busTimeUs;
+
+    MockI2CDevice *find(uint8_t address) {
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_address[i] != address) continue;
+            if (_port[i] == NO_MUX || (_muxMask & (1 << _port[i]))) return _dev[i];
+        }
+        return nullptr;
+    }
+};
+
+// Copyable handle used as the drivers' Bus parameter
+class MockBus {
+public:
+    static constexpr bool    DEFERRED     = false;
+    static constexpr uint8_t MAX_TRANSFER = 255;
+
+    MockBus(MockI2CBus &bus) : _bus(&bus) {}
+
+    bool attach(uint8_t address, uint32_t maxClockHz, uint32_t clockHz) {
+        return _bus->attach(address, maxClockHz, clockHz);
+    }
+    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen) {
+        return _bus->write(address, tx, txLen);
+    }
+    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                   uint8_t *rx, uint8_t rxLen) {
+        return _bus->writeRead(address, tx, txLen, rx, rxLen);
+    }
+    bool submit(uint8_t, const uint8_t *, uint8_t, uint8_t *, uint8_t,
+                uint32_t, I2CCallback, void *) {
+        return false;
+    }
+
+private:
+    MockI2CBus *_bus;
+};
+
+I2C_BUS_CHECK(MockBus);
+
+// ---------- Emulated devices ----------
+
+// TCA9548A: control register selects the enabled ports on the mock bus
+class MockTCA9548A : public MockI2CDevice {
+public:
+    explicit MockTCA9548A(MockI2CBus &bus) : _bus(bus), _mask(0) {}
+
+    bool onWrite(const uint8_t *data, uint8_t len) override {
+        _mask = data[len - 1];
+        _bus.setMuxMask(_mask);
+        return true;
+    }
+    bool onRead(uint8_t *data, uint8_t len) override {
+        for (uint8_t i = 0; i < len; i++) data[i] = _mask;
+        return true;
+    }
+
+private:
+    MockI2CBus &_bus;
+    uint8_t _mask;
+};
+
+// MAX30102: register file with a 32-sample FIFO fed by the test. A full
+// FIFO behaves as on the chip: WR_PTR == RD_PTR with OVF_COUNTER counting
+// the lost samples, which are the new ones unless FIFO_ROLLOVER_EN is set.
+class MockMAX30102 : public MockI2CDevice {
+public:
+    MockMAX30102() : _reg(0), _wr(0), _rd(0), _ovf(0), _full(false) {
+        powerOnReset();
+    }
+
+    // Register defaults and an empty FIFO, as after a power cycle
+    void powerOnReset() {
+        memset(_regs, 0, sizeof(_regs));
+        _regs[0xFF] = 0x15;  // part ID
+        _reg = 0;
+        _wr = _rd = _ovf = 0;
+        _full = false;
+    }
+
+    // Queue one sample as the chip would after a conversion
+    void pushSample(uint32_t red, uint32_t ir) {
+        if (_full) {
+            if (_ovf < 0x1F) _ovf++;
+            if (!(_regs[0x08] & 0x10)) return;
+            _rd = (_rd + 1) & 0x1F;
+        }
+        _fifo[_wr][0] = red & 0x03FFFF;
+        _fifo[_wr][1] = ir & 0x03FFFF;
+        _wr = (_wr + 1) & 0x1F;
+        _full = (_wr == _rd);
+    }
+
+    uint8_t getRegister(uint8_t reg) const { return _regs[reg]; }
+
+    bool onWrite(const uint8_t *data, uint8_t len) override {
+        _reg = data[0];
+        for (uint8_t i = 1; i < len; i++) {
+            uint8_t r = _reg;
+            _regs[r] = data[i];
+            if (r == 0x04) { _wr = data[i] & 0x1F; _full = false; }
+            if (r == 0x05) _ovf = data[i] & 0x1F;
+            if (r == 0x06) { _rd = data[i] & 0x1F; _full = false; }
+            if (r != 0x07) _reg++;
+        }
+        return true;
+    }
+
+    bool onRead(uint8_t *data, uint8_t len) override {
+        uint8_t i = 0;
+        while (i < len) {
+            if (_reg == 0x07) {
+                // FIFO data: 3 bytes red + 3 bytes IR per sample, no auto-increment
+                uint8_t sample[6] = {0};
+                if (_rd != _wr || _full) {
+                    uint32_t red = _fifo[_rd][0], ir = _fifo[_rd][1];
+                    sample[0] = red >> 16; sample[1] = red >> 8; sample[2] = red;
+                    sample[3] = ir >> 16;  sample[4] = ir >> 8;  sample[5] = ir;
+                    _rd = (_rd + 1) & 0x1F;
+                    _ovf = 0;      // cleared by a complete sample read
+                    _full = false;
+                }
+                for (uint8_t k = 0; k < 6 && i < len; k++) data[i++] = sample[k];
+                continue;
+            }
+            if (_reg == 0x04)      data[i] = _wr;
+            else if (_reg == 0x05) data[i] = _ovf;
+            else if (_reg == 0x06) data[i] = _rd;
+            else                   data[i] = _regs[_reg];
+            i++;
+            _reg++;
+        }
+        return true;
+    }
+
+private:
+    uint8_t  _regs[256];
+    uint8_t  _reg;
+    uint32_t _fifo[32][2];
+    uint8_t  _wr, _rd, _ovf;
+    bool     _full;
+};
+
+// SHT31: answers measurement commands with the configured values
+class MockSHT31 : public MockI2CDevice {
+public:
+    MockSHT31() : _temperature(25.0f), _humidity(50.0f), _measured(false) {}
+
+    void setClimate(float t, float h) { _temperature = t; _humidity = h; }
+
+    bool onWrite(const uint8_t *data, uint8_t len) override {
+        if (len < 2) return true;
+        uint16_t cmd = (uint16_t(data[0]) << 8) | data[1];
+        // 0x2Cxx / 0x24xx: single-shot measurement
+        _measured = ((cmd & 0xFF00) == 0x2C00 || (cmd & 0xFF00) == 0x2400);
+        return true;
+    }
+
+    bool onRead(uint8_t *data, uint8_t len) override {
+        if (!_measured || len < 6) return false;
+        uint16_t t = (uint16_t)lroundf((_temperature + 45.0f) * 65535.0f / 175.0f);
+        uint16_t h = (uint16_t)lroundf(_humidity * 65535.0f / 100.0f);
+        data[0] = t >> 8; data[1] = t; data[2] = crc8(data, 2);
+        data[3] = h >> 8; data[4] = h; data[5] = crc8(data + 3, 2);
+        _measured = false;
+        return true;
+    }
+
+private:
+    float _temperature;
+    float _humidity;
+    bool  _measured;
+
+    static uint8_t crc8(const uint8_t *data, uint8_t len) {
+        uint8_t crc = 0xFF;
+        for (uint8_t i = 0; i < len; i++) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+            }
+        }
+        return crc;
+    }
+};
+
+#endif // COMP_BUS_MOCK_H
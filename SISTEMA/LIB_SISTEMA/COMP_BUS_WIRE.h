@@ -0,0 +1,63 @@
+#ifndef COMP_BUS_WIRE_H
+#define COMP_BUS_WIRE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "COMP_BUS.h"
+
+// Largest transfer the Wire RX buffer can hold
+#ifdef I2C_BUFFER_LENGTH
+#define WIRE_BUS_MAX_TRANSFER (I2C_BUFFER_LENGTH > 255 ? 255 : I2C_BUFFER_LENGTH)
+#else
+#define WIRE_BUS_MAX_TRANSFER 32
+#endif
+
+// Bus adapter for the Arduino TwoWire API
+class WireBus {
+public:
+    static constexpr bool    DEFERRED     = false;
+    static constexpr uint8_t MAX_TRANSFER = WIRE_BUS_MAX_TRANSFER;
+
+    WireBus(TwoWire &wire = Wire) : _wire(&wire) {}
+
+    bool attach(uint8_t /*address*/, uint32_t /*maxClockHz*/, uint32_t clockHz) {
+        _wire->begin();
+        if (clockHz != 0) _wire->setClock(clockHz);
+        return true;
+    }
+
+    bool write(uint8_t address, const uint8_t *tx, uint8_t txLen) {
+        _wire->beginTransmission(address);
+        _wire->write(tx, txLen);
+        return _wire->endTransmission() == 0;
+    }
+
+    bool writeRead(uint8_t address, const uint8_t *tx, uint8_t txLen,
+                   uint8_t *rx, uint8_t rxLen) {
+        if (txLen > 0) {
+            _wire->beginTransmission(address);
+            _wire->write(tx, txLen);
+            // Repeated start when a read follows
+            if (_wire->endTransmission(rxLen == 0) != 0) return false;
+        }
+        if (rxLen == 0) return true;
+        if (_wire->requestFrom(address, rxLen) < rxLen) return false;
+        for (uint8_t i = 0; i < rxLen; i++) rx[i] = _wire->read();
+        return true;
+    }
+
+    // Plain Wire has no queue; drivers fall back to timed polling
+    bool submit(uint8_t, const uint8_t *, uint8_t, uint8_t *, uint8_t,
+                uint32_t, I2CCallback, void *) {
+        return false;
+    }
+
+    TwoWire &wire() { return *_wire; }
+
+private:
+    TwoWire *_wire;
+};
+
+I2C_BUS_CHECK(WireBus);
+
+#endif // COMP_BUS_WIRE_H
@@ -0,0 +1,1007 @@
+#ifndef COMP_CANALES_H
+#define COMP_CANALES_H
+
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <utility>
+#include "LIB_MAX30102.h"
+#include "LIB_SHT31.h"
+#include "LIB_TCA9548A.h"
+#include "COMP_RITMO_CARDIACO.h"
+#include "COMP_SPO2.h"
+#include "COMP_VARIABILIDAD.h"
+#include "COMP_PRESENCIA.h"
+#include "COMP_GANANCIA.h"
+#include "COMP_CALIDAD.h"
+#include "COMP_ESTADISTICAS.h"
+#include "COMP_PLATAFORMA.h"
+
+// Maximum number of measurement sites handled by one unit
+#ifndef SENSOR_MAX_CHANNELS
+#define SENSOR_MAX_CHANNELS 8
+#endif
+
+// Independent I2C controllers (ESP32: Wire and Wire1)
+#ifndef SENSOR_MAX_BUSES
+#define SENSOR_MAX_BUSES 2
+#endif
+
+// Signal-quality window: closed after SQI_WINDOW_MS or SQI_MAX_SAMPLES
+// samples (1 s at the 200 Hz of the high-resolution profiles)
+#ifndef SQI_WINDOW_MS
+#define SQI_WINDOW_MS 1000
+#endif
+
+#ifndef SQI_MAX_SAMPLES
+#define SQI_MAX_SAMPLES 200
+#endif
+
+// Vitals summarised per reporting window
+enum Vital : uint8_t {
+    VITAL_BPM = 0,
+    VITAL_SPO2,
+    VITAL_TEMPERATURE,
+    VITAL_HUMIDITY,
+    VITAL_COUNT
+};
+
+// Devices a channel may hold, for per-device state and startup timing
+enum DeviceKind : uint8_t {
+    DEVICE_PULSE = 0,   // MAX30102
+    DEVICE_CLIMATE,     // SHT31
+    DEVICE_KIND_COUNT
+};
+
+/**
+ *  Table of sensor channels. A channel is one measurement site with an
+ *  optional MAX30102 and an optional SHT31, reached through a given I2C
+ *  controller and, optionally, one port of a TCA9548A multiplexer.
+ *  Per-channel processing state is kept as parallel arrays indexed by
+ *  channel number. All devices of one table share the Bus type.
+ */
+template <class Bus>
+class SensorChannelsT {
+public:
+    static constexpr int8_t INVALID_CHANNEL = -1;
+
+    typedef MAX30102T<Bus>  Pulse;
+    typedef SHT31T<Bus>     Climate;
+    typedef TCA9548AT<Bus>  Mux;
+
+    /**
+     *  Processing state of one channel kept across a deep sleep: DC
+     *  filters, finger and presence state, beat detector, SpO2
+     *  accumulators and LED setting. Plain data, meant for RTC memory.
+     *  HRV and the reporting windows are not kept.
+     */
+    struct RetainedChannel {
+        float    dcIR;
+        float    dcRed;
+        float    lastValidBPM;
+        bool     fingerPresent;
+        uint8_t  presenceState;
+        HeartRateProcessor::Retained hr;
+        SpO2Processor::Retained      spo2;
+        LedGainControl::Retained     gain;
+    };
+
+    SensorChannelsT();
+
+    /**
+     *  Register a measurement site.
+     *  @param pulse    MAX30102 of this site (nullptr if none)
+     *  @param climate  SHT31 of this site (nullptr if none)
+     *  @param bus      Index of the I2C controller the devices hang from
+     *  @param mux      Multiplexer in front of the devices (nullptr if direct)
+     *  @param muxPort  Multiplexer port of the devices
+     *  @return Channel index, or INVALID_CHANNEL if the table is full
+     */
+    int8_t addChannel(Pulse *pulse, Climate *climate, uint8_t bus = 0,
+                      Mux *mux = nullptr, uint8_t muxPort = 0);
+
+    /**
+     *  Start the devices of every channel without waiting on any of them:
+     *  the MAX30102 configuration is written in register bursts and the
+     *  SHT31 soft reset completes while the other devices are set up (its
+     *  first measurement is requested from pollBus() once it is done).
+     *  Devices that do not answer are probed again from pollBus() every
+     *  PROBE_INTERVAL_MS, so the unit runs degraded rather than halting.
+     *  @return Number of channels whose devices all answered
+     */
+    uint8_t beginAll();
+
+    /**
+     *  Duty cycling. suspendAll() shuts every MAX30102 down (registers are
+     *  kept) and saves one RetainedChannel per channel into out. After the
+     *  wake, resumeAll() replaces beginAll(): a MAX30102 that kept its
+     *  configuration is only woken up and the processing state is
+     *  restored, so neither the beat detector hold-off nor the DC filters
+     *  and gain control have to settle again. A chip that lost power gets
+     *  the full bring-up. Profile, presence and gain settings must match
+     *  the ones in force at suspendAll().
+     *  @return Number of channels whose devices all answered
+     */
+    void suspendAll(RetainedChannel *out);
+    uint8_t resumeAll(const RetainedChannel *in);
+
+    /**
+     *  Switch the acquisition profile of one channel (or all) at runtime.
+     *  The chip is reconfigured and the processors take the new timing
+     *  without being reset. Channels start with PROFILE_STANDARD.
+     */
+    void setProfile(uint8_t ch, const AcquisitionProfile &profile);
+    void setProfile(const AcquisitionProfile &profile);
+    const AcquisitionProfile &getProfile(uint8_t ch) const;
+
+    /**
+     *  Low-power presence detection. While nothing is on a sensor it runs
+     *  PROFILE_PRESENCE (red LED off, dim IR) and only the newest sample is
+     *  read once per FIFO period, with no DSP; the channel profile is
+     *  restored when the IR level rises and dropped again after
+     *  PresenceMonitor::IDLE_DELAY_MS without a finger. Off by default.
+     */
+    void setPresenceDetection(bool enable);
+    const PresenceMonitor &getPresence(uint8_t ch) const;
+    void resetPresenceStats(uint8_t ch);
+
+    /**
+     *  LED automatic gain control. While something is on an active sensor
+     *  the LED amplitudes (and ADC range if needed) track the target DC
+     *  band; the DSP is told about every step. Disabling it restores the
+     *  profile setting. Off by default.
+     */
+    void setGainControl(bool enable);
+    const LedGainControl &getGainControl(uint8_t ch) const;
+    void resetGainStats(uint8_t ch);
+
+    /**
+     *  Drain MAX30102 FIFOs round-robin on every bus, spending at most
+     *  budgetUs of bus time per bus in this call.
+     */
+    void poll(uint32_t budgetUs);
+
+    /**
+     *  Same as poll() restricted to one bus, so each controller can be
+     *  serviced from its own task. A call only touches the state of the
+     *  channels on that bus and the per-bus cursor, bus time and FIFO
+     *  scratch buffer, so calls for different buses may run concurrently.
+     *  Configuration (addChannel, begin/resume, profile, presence and gain
+     *  settings) must not overlap any pollBus() call, and the getters of a
+     *  channel must not overlap pollBus() of its bus (use VitalsBoard to
+     *  publish across tasks).
+     */
+    void pollBus(uint8_t bus, uint32_t budgetUs);
+
+    /**
+     *  Temperature/humidity of a channel's SHT31. Direct channels return
+     *  the latest background measurement (refreshed from pollBus() without
+     *  blocking); channels behind a mux are read synchronously.
+     */
+    bool readClimate(uint8_t ch, float &temperature, float &humidity);
+
+    uint8_t getChannelCount() const;
+    bool isChannelOnline(uint8_t ch) const;   // any of its devices
+
+    /**
+     *  Per-device state. A device goes offline when it stops delivering
+     *  data (a MAX30102 with no FIFO samples for PULSE_TIMEOUT_MS that does
+     *  not answer either, CLIMATE_MAX_AGE_MS without a reading, or a failed
+     *  read behind a mux) and comes back through the background probe; each
+     *  bring-up counts as an attach, including that of a MAX30102 found
+     *  back in its power-on mode.
+     */
+    bool isDeviceOnline(uint8_t ch, DeviceKind kind) const;
+    uint32_t getAttachCount(uint8_t ch, DeviceKind kind) const;
+
+    /**
+     *  Time from the last bring-up of a device to its first valid vital
+     *  (a BPM in range for the MAX30102, a reading for the SHT31).
+     *  @return Milliseconds, or UINT32_MAX if none yet
+     */
+    uint32_t getTimeToFirstVital(uint8_t ch, DeviceKind kind) const;
+    bool isFingerPresent(uint8_t ch) const;
+    float getBPM(uint8_t ch) const;
+    uint8_t getSpO2(uint8_t ch) const;
+    uint32_t getSampleCount(uint8_t ch) const;
+
+    /**
+     *  Signal quality of the PPG. Samples are scored per window as they
+     *  arrive; a window below SignalQuality::MIN_SCORE is dropped without
+     *  running beat detection or SpO2 on it. BPM and SpO2 therefore lag
+     *  the samples by up to one window.
+     */
+    uint8_t getSignalQuality(uint8_t ch) const;
+    const SignalQuality &getQuality(uint8_t ch) const;
+    void resetQualityStats(uint8_t ch);
+
+    /**
+     *  Statistics of a vital since the last resetWindows(ch): BPM and SpO2
+     *  on every beat, temperature/humidity on every SHT31 reading.
+     */
+    const WindowStats &getWindow(uint8_t ch, Vital vital) const;
+    void resetWindows(uint8_t ch);
+
+    /**
+     *  Heart-rate variability over the last HRV_WINDOW_MS of accepted
+     *  inter-beat intervals. Not cleared by resetWindows(); restarts when
+     *  the finger is placed or removed.
+     */
+    const HRVProcessor &getHRV(uint8_t ch) const;
+
+    /**
+     *  Time spent by pollBus() per bus: I2C transfers (FIFO reads, probes,
+     *  climate) count against the budget, the DSP run on the samples read
+     *  is kept apart.
+     */
+    uint32_t getBusTimeUs(uint8_t bus) const;
+    uint32_t getDspTimeUs(uint8_t bus) const;
+
+    // Finger-presence thresholds (with hysteresis) and DC removal constant
+    // (DC_ALPHA is per sample at 100 Hz; other rates keep the same time constant)
+    static constexpr uint32_t FINGER_TH_ON  = 30000;
+    static constexpr uint32_t FINGER_TH_OFF = 20000;
+    static constexpr float    DC_ALPHA      = 0.95f;
+
+    // Background SHT31 refresh period and maximum age of a cached value
+    static constexpr uint32_t CLIMATE_REFRESH_MS = 5000;
+    static constexpr uint32_t CLIMATE_MAX_AGE_MS = 3 * CLIMATE_REFRESH_MS;
+
+    // Loss detection and background probing of offline devices
+    static constexpr uint32_t PULSE_TIMEOUT_MS   = 2000;
+    static constexpr uint32_t PROBE_INTERVAL_MS  = 2000;
+
+private:
+    uint8_t channelCount;
+
+    // Device wiring
+    Pulse    *pulse[SENSOR_MAX_CHANNELS];
+    Climate  *climate[SENSOR_MAX_CHANNELS];
+    Mux      *mux[SENSOR_MAX_CHANNELS];
+    uint8_t   muxPort[SENSOR_MAX_CHANNELS];
+    uint8_t   bus[SENSOR_MAX_CHANNELS];
+
+    // Device state: online flag, last bring-up or probe, last data seen,
+    // first valid vital (0 = none yet) and bring-up count
+    bool      online[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+    uint32_t  bringUpMs[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+    uint32_t  probeMs[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+    uint32_t  lastSeenMs[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+    uint32_t  firstVitalMs[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+    uint32_t  attachCount[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+
+    // Acquisition profile and derived timing
+    const AcquisitionProfile *profile[SENSOR_MAX_CHANNELS];
+    float    fifoPeriodMs[SENSOR_MAX_CHANNELS];
+    float    dcAlpha[SENSOR_MAX_CHANNELS];
+
+    // Host-side decimation accumulators
+    uint32_t decimRed[SENSOR_MAX_CHANNELS];
+    uint32_t decimIR[SENSOR_MAX_CHANNELS];
+    uint8_t  decimCount[SENSOR_MAX_CHANNELS];
+
+    // Signal processing state
+    float    dcIR[SENSOR_MAX_CHANNELS];
+    float    dcRed[SENSOR_MAX_CHANNELS];
+    bool     fingerPresent[SENSOR_MAX_CHANNELS];
+    float    lastValidBPM[SENSOR_MAX_CHANNELS];
+    uint32_t sampleCount[SENSOR_MAX_CHANNELS];
+    HeartRateProcessor hrProcessor[SENSOR_MAX_CHANNELS];
+    SpO2Processor      spo2Processor[SENSOR_MAX_CHANNELS];
+    HRVProcessor       hrvProcessor[SENSOR_MAX_CHANNELS];
+
+    // Samples of the window being scored (AC values and timestamps)
+    SignalQuality quality[SENSOR_MAX_CHANNELS];
+    float    windowIR[SENSOR_MAX_CHANNELS][SQI_MAX_SAMPLES];
+    float    windowRed[SENSOR_MAX_CHANNELS][SQI_MAX_SAMPLES];
+    uint32_t windowTs[SENSOR_MAX_CHANNELS][SQI_MAX_SAMPLES];
+    uint16_t windowCount[SENSOR_MAX_CHANNELS];
+
+    // Presence state machine per channel
+    bool            presenceEnabled;
+    PresenceMonitor presence[SENSOR_MAX_CHANNELS];
+
+    // LED gain control per channel
+    bool           gainEnabled;
+    LedGainControl gain[SENSOR_MAX_CHANNELS];
+
+    // Reporting window per vital
+    WindowStats windows[SENSOR_MAX_CHANNELS][VITAL_COUNT];
+
+    // Cached climate readings
+    float    temperature[SENSOR_MAX_CHANNELS];
+    float    humidity[SENSOR_MAX_CHANNELS];
+    bool     climateValid[SENSOR_MAX_CHANNELS];
+    uint32_t climateRequestMs[SENSOR_MAX_CHANNELS];
+    uint32_t climateReadMs[SENSOR_MAX_CHANNELS];
+
+    // Round-robin cursor and accumulated bus and DSP time per controller
+    uint8_t  nextChannel[SENSOR_MAX_BUSES];
+    uint32_t busTimeUs[SENSOR_MAX_BUSES];
+    uint32_t dspTimeUs[SENSOR_MAX_BUSES];
+
+    // Scratch buffer reused by every FIFO drain, one per bus
+    std::vector<std::pair<uint32_t, uint32_t>> samples[SENSOR_MAX_BUSES];
+
+    bool selectChannel(uint8_t ch);
+    bool bringUpPulse(uint8_t ch, uint32_t now);
+    bool bringUpClimate(uint8_t ch, uint32_t now);
+    bool resumePulse(uint8_t ch, const RetainedChannel &in, uint32_t now);
+    void markOnline(uint8_t ch, DeviceKind kind, uint32_t now);
+    void markOffline(uint8_t ch, DeviceKind kind, uint32_t now);
+    void markFirstVital(uint8_t ch, DeviceKind kind);
+    void checkPulse(uint8_t ch, uint32_t now);
+    uint32_t drainChannel(uint8_t ch);   // returns its I2C time (us)
+    void processWindow(uint8_t ch);
+    void restartPulse(uint8_t ch);
+    void updateClimate(uint8_t ch);
+    void resetProcessing(uint8_t ch);
+    void enterIdle(uint8_t ch);
+    void enterActive(uint8_t ch);
+    void applyGain(uint8_t ch, uint32_t timestampMs);
+    void restartGain(uint8_t ch);
+    static float ledScale(uint8_t amplitude, uint8_t adcRange);
+};
+
+template <class Bus>
+SensorChannelsT<Bus>::SensorChannelsT()
+    : channelCount(0), presenceEnabled(false), gainEnabled(false) {
+    for (uint8_t b = 0; b < SENSOR_MAX_BUSES; b++) {
+        nextChannel[b] = 0;
+        busTimeUs[b] = 0;
+        dspTimeUs[b] = 0;
+        samples[b].reserve(32);  // FIFO depth of the MAX30102
+    }
+}
+
+template <class Bus>
+int8_t SensorChannelsT<Bus>::addChannel(Pulse *pulseSensor, Climate *climateSensor,
+                                        uint8_t busIndex, Mux *muxDevice, uint8_t port) {
+    if (channelCount >= SENSOR_MAX_CHANNELS || busIndex >= SENSOR_MAX_BUSES) {
+        return INVALID_CHANNEL;
+    }
+    uint8_t ch = channelCount++;
+    pulse[ch] = pulseSensor;
+    climate[ch] = climateSensor;
+    mux[ch] = muxDevice;
+    muxPort[ch] = port;
+    bus[ch] = busIndex;
+    for (uint8_t k = 0; k < DEVICE_KIND_COUNT; k++) {
+        online[ch][k] = false;
+        bringUpMs[ch][k] = 0;
+        probeMs[ch][k] = 0;
+        lastSeenMs[ch][k] = 0;
+        firstVitalMs[ch][k] = 0;
+        attachCount[ch][k] = 0;
+    }
+    lastValidBPM[ch] = 0.0f;
+    sampleCount[ch] = 0;
+    climateValid[ch] = false;
+    climateRequestMs[ch] = 0;
+    climateReadMs[ch] = 0;
+    profile[ch] = &PROFILE_STANDARD;
+    presence[ch].begin(PRESENCE_ACTIVE, millis());
+    resetProcessing(ch);
+    setProfile(ch, PROFILE_STANDARD);
+    return (int8_t)ch;
+}
+
+template <class Bus>
+uint8_t SensorChannelsT<Bus>::beginAll() {
+    uint8_t ok = 0;
+    uint32_t now = millis();
+    for (uint8_t ch = 0; ch < channelCount; ch++) {
+        // Every device is tried, a missing one does not hide the others
+        bool up = true;
+        if (climate[ch] != nullptr && !bringUpClimate(ch, now)) up = false;
+        if (pulse[ch] != nullptr && !bringUpPulse(ch, now)) up = false;
+        if (up) ok++;
+    }
+    return ok;
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::suspendAll(RetainedChannel *out) {
+    for (uint8_t ch = 0; ch < channelCount; ch++) {
+        if (pulse[ch] != nullptr && online[ch][DEVICE_PULSE] && selectChannel(ch)) {
+            pulse[ch]->shutdown();
+        }
+        RetainedChannel &r = out[ch];
+        r.dcIR = dcIR[ch];
+        r.dcRed = dcRed[ch];
+        r.lastValidBPM = lastValidBPM[ch];
+        r.fingerPresent = fingerPresent[ch];
+        r.presenceState = presence[ch].getState();
+        hrProcessor[ch].save(r.hr);
+        spo2Processor[ch].save(r.spo2);
+        gain[ch].save(r.gain);
+    }
+}
+
+template <class Bus>
+uint8_t SensorChannelsT<Bus>::resumeAll(const RetainedChannel *in) {
+    uint8_t ok = 0;
+    uint32_t now = millis();
+    for (uint8_t ch = 0; ch < channelCount; ch++) {
+        bool up = true;
+        if (climate[ch] != nullptr && !bringUpClimate(ch, now)) up = false;
+        if (pulse[ch] != nullptr && !resumePulse(ch, in[ch], now)) up = false;
+        if (up) ok++;
+    }
+    return ok;
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::resumePulse(uint8_t ch, const RetainedChannel &in, uint32_t now) {
+    probeMs[ch][DEVICE_PULSE] = now;
+    if (!selectChannel(ch) || !pulse[ch]->begin()) return false;
+    if (!pulse[ch]->resume()) return bringUpPulse(ch, now);
+
+    resetProcessing(ch);
+    dcIR[ch] = in.dcIR;
+    dcRed[ch] = in.dcRed;
+    fingerPresent[ch] = in.fingerPresent;
+    lastValidBPM[ch] = in.lastValidBPM;
+    hrProcessor[ch].restore(in.hr, now);
+    spo2Processor[ch].restore(in.spo2);
+    if (gainEnabled) gain[ch].restore(*profile[ch], in.gain, now);
+    presence[ch].begin(in.presenceState == PRESENCE_IDLE ? PRESENCE_IDLE : PRESENCE_ACTIVE, now);
+    decimRed[ch] = 0;
+    decimIR[ch] = 0;
+    decimCount[ch] = 0;
+    markOnline(ch, DEVICE_PULSE, now);
+    return true;
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::bringUpPulse(uint8_t ch, uint32_t now) {
+    probeMs[ch][DEVICE_PULSE] = now;
+    if (!selectChannel(ch) || !pulse[ch]->begin()) return false;
+    pulse[ch]->setup();
+    if (profile[ch] != &PROFILE_STANDARD) pulse[ch]->applyProfile(*profile[ch]);
+    if (presenceEnabled) pulse[ch]->applyPresenceProfile();
+    presence[ch].begin(presenceEnabled ? PRESENCE_IDLE : PRESENCE_ACTIVE, now);
+    restartGain(ch);
+    decimRed[ch] = 0;
+    decimIR[ch] = 0;
+    decimCount[ch] = 0;
+    resetProcessing(ch);
+    markOnline(ch, DEVICE_PULSE, now);
+    return true;
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::bringUpClimate(uint8_t ch, uint32_t now) {
+    probeMs[ch][DEVICE_CLIMATE] = now;
+    if (!selectChannel(ch) || !climate[ch]->beginAsync()) return false;
+    climateValid[ch] = false;
+    // First background measurement as soon as the soft reset is over
+    climateRequestMs[ch] = now + Climate::RESET_MS - CLIMATE_REFRESH_MS;
+    markOnline(ch, DEVICE_CLIMATE, now);
+    return true;
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::markOnline(uint8_t ch, DeviceKind kind, uint32_t now) {
+    online[ch][kind] = true;
+    bringUpMs[ch][kind] = now;
+    lastSeenMs[ch][kind] = now;
+    firstVitalMs[ch][kind] = 0;
+    attachCount[ch][kind]++;
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::markOffline(uint8_t ch, DeviceKind kind, uint32_t now) {
+    online[ch][kind] = false;
+    probeMs[ch][kind] = now;
+    if (kind == DEVICE_PULSE) {
+        resetProcessing(ch);
+        lastValidBPM[ch] = 0.0f;
+    } else {
+        climateValid[ch] = false;
+    }
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::markFirstVital(uint8_t ch, DeviceKind kind) {
+    if (firstVitalMs[ch][kind] != 0) return;
+    uint32_t now = millis();
+    firstVitalMs[ch][kind] = now ? now : 1;
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::setProfile(uint8_t ch, const AcquisitionProfile &p) {
+    if (ch >= channelCount) return;
+    // LED setting in force before the switch: that of the gain control, or
+    // the old profile's
+    bool running = online[ch][DEVICE_PULSE] && presence[ch].getState() == PRESENCE_ACTIVE;
+    float oldRed = ledScale(gainEnabled ? gain[ch].getRedAmplitude() : profile[ch]->ledAmplitude,
+                            gainEnabled ? gain[ch].getADCRange() : profile[ch]->adcRangeCode);
+    float oldIR = ledScale(gainEnabled ? gain[ch].getIRAmplitude() : profile[ch]->ledAmplitude,
+                           gainEnabled ? gain[ch].getADCRange() : profile[ch]->adcRangeCode);
+    // The window holds samples of the old setting: close it first
+    if (running) processWindow(ch);
+
+    profile[ch] = &p;
+    fifoPeriodMs[ch] = 1000.0f / profileFifoRateHz(p);
+    float periodMs = profileSamplePeriodMs(p);
+    dcAlpha[ch] = powf(DC_ALPHA, periodMs / 10.0f);
+    hrProcessor[ch].setSamplePeriod(periodMs);
+    restartGain(ch);
+    decimRed[ch] = 0;
+    decimIR[ch] = 0;
+    decimCount[ch] = 0;
+
+    // An idle sensor picks the profile up when it wakes
+    if (running && selectChannel(ch)) {
+        pulse[ch]->applyProfile(p);
+        // Same as a gain step: keep the DC estimates on the new scale and
+        // blank the beat detector over the transient
+        float newScale = ledScale(p.ledAmplitude, p.adcRangeCode);
+        dcRed[ch] *= newScale / oldRed;
+        dcIR[ch]  *= newScale / oldIR;
+        hrProcessor[ch].notifyGainChange(millis());
+    }
+}
+
+template <class Bus>
+float SensorChannelsT<Bus>::ledScale(uint8_t amplitude, uint8_t adcRange) {
+    // Counts follow the LED current and double with every step down of
+    // ADC_RGE; pulse width and averaging do not change the scale
+    if (amplitude == 0) amplitude = 1;
+    return (float)amplitude * (float)(1 << (LedGainControl::MAX_ADC_RANGE - adcRange));
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::setProfile(const AcquisitionProfile &p) {
+    for (uint8_t ch = 0; ch < channelCount; ch++) setProfile(ch, p);
+}
+
+template <class Bus>
+const AcquisitionProfile &SensorChannelsT<Bus>::getProfile(uint8_t ch) const {
+    return *profile[ch];
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::setPresenceDetection(bool enable) {
+    presenceEnabled = enable;
+    for (uint8_t ch = 0; ch < channelCount; ch++) {
+        if (!online[ch][DEVICE_PULSE]) continue;
+        PresenceState state = presence[ch].getState();
+        if (enable && state == PRESENCE_ACTIVE && !fingerPresent[ch]) {
+            presence[ch].begin(PRESENCE_IDLE, millis());
+            enterIdle(ch);
+        } else if (!enable && state == PRESENCE_IDLE) {
+            presence[ch].begin(PRESENCE_ACTIVE, millis());
+            enterActive(ch);
+        }
+    }
+}
+
+template <class Bus>
+const PresenceMonitor &SensorChannelsT<Bus>::getPresence(uint8_t ch) const {
+    return presence[ch];
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::resetPresenceStats(uint8_t ch) {
+    if (ch < channelCount) presence[ch].resetStats(millis());
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::setGainControl(bool enable) {
+    if (enable == gainEnabled) return;
+    gainEnabled = enable;
+    for (uint8_t ch = 0; ch < channelCount; ch++) {
+        restartGain(ch);
+        // Disabling: back to the profile setting
+        if (!enable && online[ch][DEVICE_PULSE] &&
+            presence[ch].getState() == PRESENCE_ACTIVE && selectChannel(ch)) {
+            pulse[ch]->applyProfile(*profile[ch]);
+            resetProcessing(ch);
+        }
+    }
+}
+
+template <class Bus>
+const LedGainControl &SensorChannelsT<Bus>::getGainControl(uint8_t ch) const {
+    return gain[ch];
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::resetGainStats(uint8_t ch) {
+    if (ch < channelCount) gain[ch].resetStats();
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::poll(uint32_t budgetUs) {
+    for (uint8_t b = 0; b < SENSOR_MAX_BUSES; b++) {
+        pollBus(b, budgetUs);
+    }
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::pollBus(uint8_t b, uint32_t budgetUs) {
+    if (b >= SENSOR_MAX_BUSES || channelCount == 0) return;
+
+    // Only I2C time counts against the budget; the DSP of a drain is
+    // what is left of its duration once its transfers are taken out
+    uint32_t spentUs = 0;
+    uint8_t ch = nextChannel[b] % channelCount;
+    for (uint8_t visited = 0; visited < channelCount; visited++) {
+        if (bus[ch] == b) {
+            if (spentUs >= budgetUs) break;
+            uint32_t visitStart = micros();
+            uint32_t dspUs = 0;
+            if (pulse[ch] != nullptr) {
+                if (online[ch][DEVICE_PULSE]) {
+                    uint32_t busUs = drainChannel(ch);
+                    dspUs = micros() - visitStart - busUs;
+                    presence[ch].addBusTime(busUs);
+                    uint32_t now = millis();
+                    if ((now - lastSeenMs[ch][DEVICE_PULSE]) > PULSE_TIMEOUT_MS) {
+                        checkPulse(ch, now);
+                    }
+                } else if ((millis() - probeMs[ch][DEVICE_PULSE]) >= PROBE_INTERVAL_MS) {
+                    bringUpPulse(ch, millis());
+                }
+            }
+            if (climate[ch] != nullptr) {
+                if (online[ch][DEVICE_CLIMATE]) {
+                    updateClimate(ch);
+                } else if ((millis() - probeMs[ch][DEVICE_CLIMATE]) >= PROBE_INTERVAL_MS) {
+                    bringUpClimate(ch, millis());
+                }
+            }
+            spentUs += micros() - visitStart - dspUs;
+            dspTimeUs[b] += dspUs;
+        }
+        ch = (ch + 1) % channelCount;
+    }
+    // Resume after the last channel serviced so no site starves
+    nextChannel[b] = ch;
+    busTimeUs[b] += spentUs;
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::readClimate(uint8_t ch, float &t, float &h) {
+    if (ch >= channelCount || climate[ch] == nullptr || !online[ch][DEVICE_CLIMATE]) return false;
+    if (mux[ch] != nullptr) {
+        // Read on demand only: a failed read is the loss signal
+        if (!selectChannel(ch) || !climate[ch]->read(t, h)) {
+            markOffline(ch, DEVICE_CLIMATE, millis());
+            return false;
+        }
+        lastSeenMs[ch][DEVICE_CLIMATE] = millis();
+        markFirstVital(ch, DEVICE_CLIMATE);
+        windows[ch][VITAL_TEMPERATURE].add(t);
+        windows[ch][VITAL_HUMIDITY].add(h);
+        return true;
+    }
+    if (!climateValid[ch] || (millis() - climateReadMs[ch]) > CLIMATE_MAX_AGE_MS) return false;
+    t = temperature[ch];
+    h = humidity[ch];
+    return true;
+}
+
+template <class Bus>
+uint8_t SensorChannelsT<Bus>::getChannelCount() const {
+    return channelCount;
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::isChannelOnline(uint8_t ch) const {
+    return ch < channelCount && (online[ch][DEVICE_PULSE] || online[ch][DEVICE_CLIMATE]);
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::isDeviceOnline(uint8_t ch, DeviceKind kind) const {
+    return ch < channelCount && kind < DEVICE_KIND_COUNT && online[ch][kind];
+}
+
+template <class Bus>
+uint32_t SensorChannelsT<Bus>::getAttachCount(uint8_t ch, DeviceKind kind) const {
+    return (ch < channelCount && kind < DEVICE_KIND_COUNT) ? attachCount[ch][kind] : 0;
+}
+
+template <class Bus>
+uint32_t SensorChannelsT<Bus>::getTimeToFirstVital(uint8_t ch, DeviceKind kind) const {
+    if (ch >= channelCount || kind >= DEVICE_KIND_COUNT || firstVitalMs[ch][kind] == 0) {
+        return UINT32_MAX;
+    }
+    return firstVitalMs[ch][kind] - bringUpMs[ch][kind];
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::isFingerPresent(uint8_t ch) const {
+    return ch < channelCount && fingerPresent[ch];
+}
+
+template <class Bus>
+float SensorChannelsT<Bus>::getBPM(uint8_t ch) const {
+    return (ch < channelCount) ? lastValidBPM[ch] : 0.0f;
+}
+
+template <class Bus>
+uint8_t SensorChannelsT<Bus>::getSpO2(uint8_t ch) const {
+    return (ch < channelCount) ? spo2Processor[ch].getSpO2() : 0;
+}
+
+template <class Bus>
+uint32_t SensorChannelsT<Bus>::getSampleCount(uint8_t ch) const {
+    return (ch < channelCount) ? sampleCount[ch] : 0;
+}
+
+template <class Bus>
+uint8_t SensorChannelsT<Bus>::getSignalQuality(uint8_t ch) const {
+    return (ch < channelCount && fingerPresent[ch]) ? quality[ch].getScore() : 0;
+}
+
+template <class Bus>
+const SignalQuality &SensorChannelsT<Bus>::getQuality(uint8_t ch) const {
+    return quality[ch];
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::resetQualityStats(uint8_t ch) {
+    if (ch < channelCount) quality[ch].resetStats();
+}
+
+template <class Bus>
+uint32_t SensorChannelsT<Bus>::getBusTimeUs(uint8_t b) const {
+    return (b < SENSOR_MAX_BUSES) ? busTimeUs[b] : 0;
+}
+
+template <class Bus>
+uint32_t SensorChannelsT<Bus>::getDspTimeUs(uint8_t b) const {
+    return (b < SENSOR_MAX_BUSES) ? dspTimeUs[b] : 0;
+}
+
+template <class Bus>
+bool SensorChannelsT<Bus>::selectChannel(uint8_t ch) {
+    if (mux[ch] == nullptr) return true;
+    return mux[ch]->select(muxPort[ch]);
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::checkPulse(uint8_t ch, uint32_t now) {
+    // No samples for PULSE_TIMEOUT_MS: ask the chip before dropping it. One
+    // that answers and keeps its mode is still there (the FIFO stalled), so
+    // its pointers are restarted; one back in the power-on mode was power
+    // cycled or swapped and is brought up again at once
+    bool configured = false;
+    if (!selectChannel(ch) || !pulse[ch]->isAlive(configured)) {
+        markOffline(ch, DEVICE_PULSE, now);
+    } else if (configured) {
+        pulse[ch]->clearFIFO();
+        lastSeenMs[ch][DEVICE_PULSE] = now;
+    } else {
+        markOffline(ch, DEVICE_PULSE, now);
+        bringUpPulse(ch, now);
+    }
+}
+
+template <class Bus>
+uint32_t SensorChannelsT<Bus>::drainChannel(uint8_t ch) {
+    uint32_t readStart = micros();
+    if (presence[ch].getState() == PRESENCE_IDLE) {
+        // Idle: newest sample once per FIFO period, no DSP
+        uint32_t now = millis();
+        if (!presence[ch].isCheckDue(now)) return 0;
+        uint32_t red, ir;
+        bool read = selectChannel(ch) && pulse[ch]->readFIFO(red, ir);
+        if (read) {
+            lastSeenMs[ch][DEVICE_PULSE] = now;
+            if (presence[ch].checkIdle(ir, now)) enterActive(ch);   // register writes
+        }
+        return micros() - readStart;
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> &batch = samples[bus[ch]];
+    bool read = selectChannel(ch) && pulse[ch]->readAllFIFO(batch);
+    uint32_t busUs = micros() - readStart;
+    if (!read) return busUs;
+
+    uint32_t t = millis();
+    lastSeenMs[ch][DEVICE_PULSE] = t;
+    bool gainStep = false;
+    uint8_t decimation = profile[ch]->decimation ? profile[ch]->decimation : 1;
+    size_t n = batch.size();
+    for (size_t i = 0; i < n; i++) {
+        uint32_t rawRed = batch[i].first;
+        uint32_t rawIR  = batch[i].second;
+
+        // AGC on the raw FIFO level; a new setting is written after the
+        // batch, every sample in the FIFO was converted with the old one
+        if (gainEnabled && gain[ch].update(rawRed, rawIR, fingerPresent[ch], t)) gainStep = true;
+
+        // Host-side decimation (boxcar average)
+        if (decimation > 1) {
+            decimRed[ch] += rawRed;
+            decimIR[ch]  += rawIR;
+            if (++decimCount[ch] < decimation) continue;
+            rawRed = decimRed[ch] / decimation;
+            rawIR  = decimIR[ch] / decimation;
+            decimRed[ch] = 0;
+            decimIR[ch] = 0;
+            decimCount[ch] = 0;
+        }
+
+        // Samples were taken one FIFO period apart, the newest just now
+        uint32_t ts = t - (uint32_t)((float)(n - 1 - i) * fifoPeriodMs[ch]);
+
+        // Finger detection with hysteresis
+        if (!fingerPresent[ch] && rawIR > FINGER_TH_ON) {
+            fingerPresent[ch] = true;
+            restartPulse(ch);
+        } else if (fingerPresent[ch] && rawIR < FINGER_TH_OFF) {
+            fingerPresent[ch] = false;
+            restartPulse(ch);
+            continue;
+        }
+        if (!fingerPresent[ch]) continue;
+
+        // DC removal; the AC values wait in the window until it is scored
+        dcIR[ch]  = dcAlpha[ch] * dcIR[ch]  + (1.0f - dcAlpha[ch]) * rawIR;
+        dcRed[ch] = dcAlpha[ch] * dcRed[ch] + (1.0f - dcAlpha[ch]) * rawRed;
+        float acIR  = float(rawIR)  - dcIR[ch];
+        float acRed = float(rawRed) - dcRed[ch];
+        uint16_t k = windowCount[ch]++;
+        windowIR[ch][k] = acIR;
+        windowRed[ch][k] = acRed;
+        windowTs[ch][k] = ts;
+        quality[ch].add(acIR, rawIR, dcIR[ch]);
+        if (windowCount[ch] >= SQI_MAX_SAMPLES || (ts - windowTs[ch][0]) >= SQI_WINDOW_MS) {
+            processWindow(ch);
+        }
+        sampleCount[ch]++;
+    }
+    if (gainStep) {
+        // The window holds samples of the old gain: close it first
+        processWindow(ch);
+        uint32_t writeStart = micros();
+        applyGain(ch, t);
+        busUs += micros() - writeStart;
+    }
+    if (presenceEnabled && presence[ch].checkActive(fingerPresent[ch], t)) {
+        uint32_t writeStart = micros();
+        enterIdle(ch);
+        busUs += micros() - writeStart;
+    }
+    return busUs;
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::processWindow(uint8_t ch) {
+    uint16_t n = windowCount[ch];
+    windowCount[ch] = 0;
+    if (n == 0) return;
+    uint32_t durationMs = windowTs[ch][n - 1] - windowTs[ch][0];
+
+    // Too short to score (cut by a gain step) or unusable: skip the DSP
+    if (durationMs < SQI_WINDOW_MS / 4 || quality[ch].evaluate(durationMs) < SignalQuality::MIN_SCORE) {
+        quality[ch].reset();
+        hrProcessor[ch].notifyGap();
+        hrvProcessor[ch].markGap();
+        return;
+    }
+
+    for (uint16_t i = 0; i < n; i++) {
+        uint32_t ts = windowTs[ch][i];
+        bool beat = hrProcessor[ch].update(windowIR[ch][i], ts);
+        spo2Processor[ch].update(windowIR[ch][i], windowRed[ch][i], beat);
+        if (!beat) continue;
+        float rawBPM = hrProcessor[ch].getBPM();
+        if (rawBPM >= 40.0f && rawBPM <= 180.0f) {
+            lastValidBPM[ch] = rawBPM;
+            windows[ch][VITAL_BPM].add(rawBPM);
+            markFirstVital(ch, DEVICE_PULSE);
+        }
+        if (hrProcessor[ch].getLastInterval() > 0) {
+            hrvProcessor[ch].addInterval(hrProcessor[ch].getLastInterval(), ts);
+        }
+        if (spo2Processor[ch].getSpO2() > 0) {
+            windows[ch][VITAL_SPO2].add(spo2Processor[ch].getSpO2());
+        }
+    }
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::restartPulse(uint8_t ch) {
+    hrProcessor[ch].reset();
+    spo2Processor[ch].reset();
+    hrvProcessor[ch].reset();
+    quality[ch].reset();
+    windowCount[ch] = 0;
+}
+
+template <class Bus>
+const WindowStats &SensorChannelsT<Bus>::getWindow(uint8_t ch, Vital vital) const {
+    return windows[ch][vital];
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::resetWindows(uint8_t ch) {
+    if (ch >= channelCount) return;
+    for (uint8_t v = 0; v < VITAL_COUNT; v++) windows[ch][v].reset();
+}
+
+template <class Bus>
+const HRVProcessor &SensorChannelsT<Bus>::getHRV(uint8_t ch) const {
+    return hrvProcessor[ch];
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::updateClimate(uint8_t ch) {
+    // Only direct channels: a queued read could run with the mux elsewhere
+    if (climate[ch] == nullptr || mux[ch] != nullptr) return;
+
+    uint32_t now = millis();
+    if (climate[ch]->isMeasurementReady()) {
+        if (climate[ch]->getMeasurement(temperature[ch], humidity[ch])) {
+            climateValid[ch] = true;
+            climateReadMs[ch] = now;
+            lastSeenMs[ch][DEVICE_CLIMATE] = now;
+            markFirstVital(ch, DEVICE_CLIMATE);
+            windows[ch][VITAL_TEMPERATURE].add(temperature[ch]);
+            windows[ch][VITAL_HUMIDITY].add(humidity[ch]);
+        }
+    } else if ((now - climateRequestMs[ch]) >= CLIMATE_REFRESH_MS) {
+        if (climate[ch]->requestMeasurement()) climateRequestMs[ch] = now;
+    }
+    if ((now - lastSeenMs[ch][DEVICE_CLIMATE]) > CLIMATE_MAX_AGE_MS) {
+        markOffline(ch, DEVICE_CLIMATE, now);
+    }
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::resetProcessing(uint8_t ch) {
+    dcIR[ch] = 0.0f;
+    dcRed[ch] = 0.0f;
+    fingerPresent[ch] = false;
+    restartPulse(ch);
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::applyGain(uint8_t ch, uint32_t timestampMs) {
+    const LedGainControl &g = gain[ch];
+    pulse[ch]->setLEDPulseAmplitudeRed(g.getRedAmplitude());
+    pulse[ch]->setLEDPulseAmplitudeIR(g.getIRAmplitude());
+    pulse[ch]->setADCRange(g.getADCRange());
+
+    // Keep the DC estimates on the new scale and warn the processors
+    dcRed[ch] *= g.getRedStep();
+    dcIR[ch]  *= g.getIRStep();
+    hrProcessor[ch].notifyGainChange(timestampMs);
+    spo2Processor[ch].setLEDGain(g.getRedGain(), g.getIRGain());
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::restartGain(uint8_t ch) {
+    gain[ch].begin(*profile[ch], millis());
+    spo2Processor[ch].setLEDGain(1.0f, 1.0f);
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::enterIdle(uint8_t ch) {
+    if (selectChannel(ch)) pulse[ch]->applyPresenceProfile();
+    resetProcessing(ch);
+}
+
+template <class Bus>
+void SensorChannelsT<Bus>::enterActive(uint8_t ch) {
+    if (selectChannel(ch)) pulse[ch]->applyProfile(*profile[ch]);
+    restartGain(ch);
+    decimRed[ch] = 0;
+    decimIR[ch] = 0;
+    decimCount[ch] = 0;
+    resetProcessing(ch);
+}
+
+#ifdef ARDUINO
+#include "COMP_BUS_WIRE.h"
+
+// Channel table over Arduino Wire
+typedef SensorChannelsT<WireBus> SensorChannels;
+#endif
+
+#endif // COMP_CANALES_H
@@ -0,0 +1,240 @@
+#include "COMP_COMPRESION.h"
+#include <math.h>
+#include <string.h>
+
+// Channel resolutions (units per LSB): 0.01 °C, 0.01 %RH, 0.1 BPM, 1 %, 1e-6 deg
+static constexpr float SCALE_TEMPERATURE = 100.0f;
+static constexpr float SCALE_HUMIDITY    = 100.0f;
+static constexpr float SCALE_BPM         = 10.0f;
+static constexpr float SCALE_SPO2        = 1.0f;
+static constexpr float SCALE_DEGREES     = 1000000.0f;
+
+// ---------- Varint helpers ----------
+
+uint32_t zigZagEncode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t zigZagDecode(uint32_t value) {
+    return (int32_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+size_t writeVarint(uint8_t *out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+size_t readVarint(const uint8_t *in, size_t available, uint32_t &value) {
+    value = 0;
+    for (size_t n = 0; n < available && n < 5; n++) {
+        value |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if ((in[n] & 0x80) == 0) return n + 1;
+    }
+    return 0;  // truncated or over-long
+}
+
+// ---------- Channels ----------
+
+TimestampChannel::TimestampChannel()
+    : lastValue(0), lastDelta(0) {
+}
+
+void TimestampChannel::reset() {
+    lastValue = 0;
+    lastDelta = 0;
+}
+
+int32_t TimestampChannel::encode(uint32_t timestamp) {
+    int32_t delta = (int32_t)(timestamp - lastValue);
+    int32_t dod = (int32_t)((uint32_t)delta - (uint32_t)lastDelta);
+    lastValue = timestamp;
+    lastDelta = delta;
+    return dod;
+}
+
+uint32_t TimestampChannel::decode(int32_t deltaOfDelta) {
+    lastDelta = (int32_t)((uint32_t)lastDelta + (uint32_t)deltaOfDelta);
+    lastValue += (uint32_t)lastDelta;
+    return lastValue;
+}
+
+ScaledChannel::ScaledChannel(float scale)
+    : scale(scale), lastValue(0) {
+}
+
+void ScaledChannel::reset() {
+    lastValue = 0;
+}
+
+int32_t ScaledChannel::encode(double value) {
+    int32_t q = (int32_t)lround(value * (double)scale);
+    int32_t delta = (int32_t)((uint32_t)q - (uint32_t)lastValue);
+    lastValue = q;
+    return delta;
+}
+
+double ScaledChannel::decode(int32_t delta) {
+    lastValue = (int32_t)((uint32_t)lastValue + (uint32_t)delta);
+    return (double)lastValue / (double)scale;
+}
+
+// ---------- Encoder ----------
+
+TimeSeriesEncoder::TimeSeriesEncoder()
+    : buffer(nullptr), capacity(0), length(0), recordCount(0),
+      temperatureCh(SCALE_TEMPERATURE), humidityCh(SCALE_HUMIDITY),
+      bpmCh(SCALE_BPM), spo2Ch(SCALE_SPO2),
+      latitudeCh(SCALE_DEGREES), longitudeCh(SCALE_DEGREES) {
+}
+
+void TimeSeriesEncoder::begin(uint8_t *buf, size_t cap) {
+    buffer = buf;
+    capacity = cap;
+    length = 0;
+    recordCount = 0;
+    timestampCh.reset();
+    temperatureCh.reset();
+    humidityCh.reset();
+    bpmCh.reset();
+    spo2Ch.reset();
+    latitudeCh.reset();
+    longitudeCh.reset();
+}
+
+bool TimeSeriesEncoder::append(const VitalsRecord &r) {
+    if (buffer == nullptr) return false;
+
+    // Encode against copies of the channel state so a full buffer leaves
+    // the block untouched
+    uint8_t tmp[MAX_RECORD_BYTES];
+    size_t n = 0;
+    TimestampChannel ts = timestampCh;
+    ScaledChannel t = temperatureCh, h = humidityCh, b = bpmCh, s = spo2Ch;
+    ScaledChannel la = latitudeCh, lo = longitudeCh;
+
+    tmp[n++] = r.flags;
+    n += writeVarint(tmp + n, zigZagEncode(ts.encode(r.timestamp)));
+    if (r.flags & REC_HAS_TEMPERATURE) n += writeVarint(tmp + n, zigZagEncode(t.encode(r.temperature)));
+    if (r.flags & REC_HAS_HUMIDITY)    n += writeVarint(tmp + n, zigZagEncode(h.encode(r.humidity)));
+    if (r.flags & REC_HAS_BPM)         n += writeVarint(tmp + n, zigZagEncode(b.encode(r.bpm)));
+    if (r.flags & REC_HAS_SPO2)        n += writeVarint(tmp + n, zigZagEncode(s.encode(r.spo2)));
+    if (r.flags & REC_HAS_LOCATION) {
+        n += writeVarint(tmp + n, zigZagEncode(la.encode(r.latitude)));
+        n += writeVarint(tmp + n, zigZagEncode(lo.encode(r.longitude)));
+    }
+
+    if (length + n > capacity) return false;
+    memcpy(buffer + length, tmp, n);
+    length += n;
+    recordCount++;
+
+    timestampCh = ts;
+    temperatureCh = t;
+    humidityCh = h;
+    bpmCh = b;
+    spo2Ch = s;
+    latitudeCh = la;
+    longitudeCh = lo;
+    return true;
+}
+
+size_t TimeSeriesEncoder::size() const {
+    return length;
+}
+
+uint32_t TimeSeriesEncoder::getRecordCount() const {
+    return recordCount;
+}
+
+void TimeSeriesEncoder::save(Retained &out) const {
+    out.length = (uint32_t)length;
+    out.recordCount = recordCount;
+    out.lastTimestamp = timestampCh.getLastValue();
+    out.lastDelta = timestampCh.getLastDelta();
+    out.lastValue[0] = temperatureCh.getLastValue();
+    out.lastValue[1] = humidityCh.getLastValue();
+    out.lastValue[2] = bpmCh.getLastValue();
+    out.lastValue[3] = spo2Ch.getLastValue();
+    out.lastValue[4] = latitudeCh.getLastValue();
+    out.lastValue[5] = longitudeCh.getLastValue();
+}
+
+void TimeSeriesEncoder::restore(uint8_t *buf, size_t cap, const Retained &in) {
+    begin(buf, cap);
+    if (in.length > cap || (in.length == 0) != (in.recordCount == 0)) return;
+    length = in.length;
+    recordCount = in.recordCount;
+    timestampCh.restore(in.lastTimestamp, in.lastDelta);
+    temperatureCh.restore(in.lastValue[0]);
+    humidityCh.restore(in.lastValue[1]);
+    bpmCh.restore(in.lastValue[2]);
+    spo2Ch.restore(in.lastValue[3]);
+    latitudeCh.restore(in.lastValue[4]);
+    longitudeCh.restore(in.lastValue[5]);
+}
+
+// ---------- Decoder ----------
+
+TimeSeriesDecoder::TimeSeriesDecoder(const uint8_t *buf, size_t len)
+    : buffer(buf), length(len), position(0),
+      temperatureCh(SCALE_TEMPERATURE), humidityCh(SCALE_HUMIDITY),
+      bpmCh(SCALE_BPM), spo2Ch(SCALE_SPO2),
+      latitudeCh(SCALE_DEGREES), longitudeCh(SCALE_DEGREES) {
+}
+
+bool TimeSeriesDecoder::next(VitalsRecord &r) {
+    if (position >= length) return false;
+
+    size_t pos = position;
+    uint32_t raw;
+    r.flags = buffer[pos++];
+
+    size_t used = readVarint(buffer + pos, length - pos, raw);
+    if (used == 0) return false;
+    pos += used;
+    r.timestamp = timestampCh.decode(zigZagDecode(raw));
+
+    r.temperature = NAN;
+    r.humidity = NAN;
+    r.bpm = 0.0f;
+    r.spo2 = 0;
+    r.latitude = 0.0;
+    r.longitude = 0.0;
+
+    if (r.flags & REC_HAS_TEMPERATURE) {
+        if ((used = readVarint(buffer + pos, length - pos, raw)) == 0) return false;
+        pos += used;
+        r.temperature = (float)temperatureCh.decode(zigZagDecode(raw));
+    }
+    if (r.flags & REC_HAS_HUMIDITY) {
+        if ((used = readVarint(buffer + pos, length - pos, raw)) == 0) return false;
+        pos += used;
+        r.humidity = (float)humidityCh.decode(zigZagDecode(raw));
+    }
+    if (r.flags & REC_HAS_BPM) {
+        if ((used = readVarint(buffer + pos, length - pos, raw)) == 0) return false;
+        pos += used;
+        r.bpm = (float)bpmCh.decode(zigZagDecode(raw));
+    }
+    if (r.flags & REC_HAS_SPO2) {
+        if ((used = readVarint(buffer + pos, length - pos, raw)) == 0) return false;
+        pos += used;
+        r.spo2 = (uint8_t)spo2Ch.decode(zigZagDecode(raw));
+    }
+    if (r.flags & REC_HAS_LOCATION) {
+        if ((used = readVarint(buffer + pos, length - pos, raw)) == 0) return false;
+        pos += used;
+        r.latitude = latitudeCh.decode(zigZagDecode(raw));
+        if ((used = readVarint(buffer + pos, length - pos, raw)) == 0) return false;
+        pos += used;
+        r.longitude = longitudeCh.decode(zigZagDecode(raw));
+    }
+
+    position = pos;
+    return true;
+}
@@ -0,0 +1,159 @@
+#ifndef COMP_COMPRESION_H
+#define COMP_COMPRESION_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Field validity flags stored in front of every encoded record
+#define REC_HAS_TEMPERATURE   0x01
+#define REC_HAS_HUMIDITY      0x02
+#define REC_HAS_BPM           0x04
+#define REC_HAS_SPO2          0x08
+#define REC_HAS_LOCATION      0x10
+
+// Alerts the device raised on the window behind the record; the fields
+// keep the window means, so the extreme that fired an alert is not stored
+#define REC_ALERT_TEMPERATURE 0x20
+#define REC_ALERT_HEART_RATE  0x40
+#define REC_ALERT_GEOFENCE    0x80
+
+// One report as produced by the monitoring loop
+struct VitalsRecord {
+    uint32_t timestamp;     // seconds (epoch or uptime)
+    float    temperature;   // °C
+    float    humidity;      // % RH
+    float    bpm;           // beats per minute
+    uint8_t  spo2;          // %
+    double   latitude;      // degrees
+    double   longitude;     // degrees
+    uint8_t  flags;         // REC_HAS_* valid fields | REC_ALERT_* raised alerts
+};
+
+// Delta-of-delta timestamp channel (seconds)
+class TimestampChannel {
+public:
+    TimestampChannel();
+    void reset();
+    int32_t encode(uint32_t timestamp);
+    uint32_t decode(int32_t deltaOfDelta);
+    uint32_t getLastValue() const { return lastValue; }
+    int32_t getLastDelta() const { return lastDelta; }
+    void restore(uint32_t value, int32_t delta) { lastValue = value; lastDelta = delta; }
+
+private:
+    uint32_t lastValue;
+    int32_t  lastDelta;
+};
+
+// Fixed-point delta channel: value is scaled to an integer and the
+// difference against the previous valid value is emitted.
+class ScaledChannel {
+public:
+    explicit ScaledChannel(float scale);
+    void reset();
+    int32_t encode(double value);
+    double decode(int32_t delta);
+    int32_t getLastValue() const { return lastValue; }
+    void restore(int32_t value) { lastValue = value; }
+
+private:
+    float   scale;
+    int32_t lastValue;
+};
+
+/**
+ *  Streaming time-series encoder for VitalsRecord.
+ *  Writes into a caller-owned buffer, never allocates, and keeps a
+ *  fixed amount of state per channel.
+ */
+class TimeSeriesEncoder {
+public:
+    TimeSeriesEncoder();
+
+    /**
+     *  Start a new block over the given buffer. Channel state is reset so
+     *  each block can be decoded on its own.
+     *  @param buffer    Output storage
+     *  @param capacity  Size of buffer in bytes
+     */
+    void begin(uint8_t *buffer, size_t capacity);
+
+    /**
+     *  Append one record to the current block.
+     *  @return false if the record does not fit; the block is left intact.
+     */
+    bool append(const VitalsRecord &record);
+
+    size_t size() const;
+    uint32_t getRecordCount() const;
+
+    /**
+     *  Block state kept across a deep sleep, next to the buffer (both in
+     *  RTC memory). Plain data.
+     */
+    struct Retained {
+        uint32_t length;
+        uint32_t recordCount;
+        uint32_t lastTimestamp;
+        int32_t  lastDelta;
+        int32_t  lastValue[6];   // temperature, humidity, BPM, SpO2, lat, lon
+    };
+    void save(Retained &out) const;
+
+    /**
+     *  Continue the block saved with save() over the same buffer, whose
+     *  contents must have survived the sleep. Starts a new block if the
+     *  saved length does not fit in capacity.
+     */
+    void restore(uint8_t *buffer, size_t capacity, const Retained &in);
+
+    // Upper bound of the encoded size of a single record
+    static constexpr size_t MAX_RECORD_BYTES = 1 + 7 * 5;
+
+private:
+    uint8_t *buffer;
+    size_t   capacity;
+    size_t   length;
+    uint32_t recordCount;
+
+    TimestampChannel timestampCh;
+    ScaledChannel    temperatureCh;
+    ScaledChannel    humidityCh;
+    ScaledChannel    bpmCh;
+    ScaledChannel    spo2Ch;
+    ScaledChannel    latitudeCh;
+    ScaledChannel    longitudeCh;
+};
+
+// Decoder counterpart; reads one block produced by TimeSeriesEncoder
+class TimeSeriesDecoder {
+public:
+    TimeSeriesDecoder(const uint8_t *buffer, size_t length);
+
+    /**
+     *  Decode the next record.
+     *  @return false at the end of the block or on a malformed stream.
+     */
+    bool next(VitalsRecord &record);
+
+private:
+    const uint8_t *buffer;
+    size_t length;
+    size_t position;
+
+    TimestampChannel timestampCh;
+    ScaledChannel    temperatureCh;
+    ScaledChannel    humidityCh;
+    ScaledChannel    bpmCh;
+    ScaledChannel    spo2Ch;
+    ScaledChannel    latitudeCh;
+    ScaledChannel    longitudeCh;
+};
+
+// Zig-zag + LEB128 varint helpers (shared with other encoders)
+uint32_t zigZagEncode(int32_t value);
+int32_t zigZagDecode(uint32_t value);
+size_t writeVarint(uint8_t *out, uint32_t value);
+size_t readVarint(const uint8_t *in, size_t available, uint32_t &value);
+
+#endif // COMP_COMPRESION_H
@@ -0,0 +1,157 @@
+#include "COMP_ESTADISTICAS.h"
+#include <math.h>
+
+// ---------- P2Quantile ----------
+
+P2Quantile::P2Quantile(float p) : p(p) {
+    reset();
+}
+
+void P2Quantile::reset() {
+    count = 0;
+    for (uint8_t i = 0; i < 5; i++) {
+        height[i] = 0.0f;
+        position[i] = i + 1;
+    }
+    desired[0] = 1.0f;
+    desired[1] = 1.0f + 2.0f * p;
+    desired[2] = 1.0f + 4.0f * p;
+    desired[3] = 3.0f + 2.0f * p;
+    desired[4] = 5.0f;
+}
+
+void P2Quantile::add(float x) {
+    // The first five samples are kept sorted as the initial markers
+    if (count < 5) {
+        uint8_t i = count++;
+        while (i > 0 && height[i - 1] > x) {
+            height[i] = height[i - 1];
+            i--;
+        }
+        height[i] = x;
+        return;
+    }
+    count++;
+
+    // Cell k holding x; extremes move with it
+    uint8_t k;
+    if (x < height[0]) {
+        height[0] = x;
+        k = 0;
+    } else if (x < height[1]) {
+        k = 0;
+    } else if (x < height[2]) {
+        k = 1;
+    } else if (x < height[3]) {
+        k = 2;
+    } else if (x <= height[4]) {
+        k = 3;
+    } else {
+        height[4] = x;
+        k = 3;
+    }
+    for (uint8_t i = k + 1; i < 5; i++) position[i]++;
+    desired[1] += p / 2.0f;
+    desired[2] += p;
+    desired[3] += (1.0f + p) / 2.0f;
+    desired[4] += 1.0f;
+
+    // Move the middle markers towards their desired positions
+    for (uint8_t i = 1; i <= 3; i++) {
+        float d = desired[i] - position[i];
+        if ((d >= 1.0f && position[i + 1] - position[i] > 1) ||
+            (d <= -1.0f && position[i - 1] - position[i] < -1)) {
+            int8_t s = d > 0 ? 1 : -1;
+            float h = parabolic(i, s);
+            if (height[i - 1] < h && h < height[i + 1]) height[i] = h;
+            else height[i] = linear(i, s);
+            position[i] += s;
+        }
+    }
+}
+
+float P2Quantile::parabolic(uint8_t i, int8_t d) const {
+    float n0 = position[i - 1], n1 = position[i], n2 = position[i + 1];
+    return height[i] + d / (n2 - n0) *
+           ((n1 - n0 + d) * (height[i + 1] - height[i]) / (n2 - n1) +
+            (n2 - n1 - d) * (height[i] - height[i - 1]) / (n1 - n0));
+}
+
+float P2Quantile::linear(uint8_t i, int8_t d) const {
+    return height[i] + d * (height[i + d] - height[i]) / (position[i + d] - position[i]);
+}
+
+float P2Quantile::get() const {
+    if (count == 0) return 0.0f;
+    if (count < 5) {
+        // Nearest rank over the sorted samples
+        uint8_t rank = (uint8_t)lroundf(p * (count - 1));
+        return height[rank];
+    }
+    return height[2];
+}
+
+// ---------- WindowStats ----------
+
+WindowStats::WindowStats() : p5(0.05f), p50(0.5f), p95(0.95f) {
+    reset();
+}
+
+void WindowStats::reset() {
+    count = 0;
+    min = 0.0f;
+    max = 0.0f;
+    mean = 0.0f;
+    m2 = 0.0f;
+    p5.reset();
+    p50.reset();
+    p95.reset();
+}
+
+void WindowStats::add(float x) {
+    count++;
+    if (count == 1 || x < min) min = x;
+    if (count == 1 || x > max) max = x;
+    float delta = x - mean;
+    mean += delta / count;
+    m2 += delta * (x - mean);
+    p5.add(x);
+    p50.add(x);
+    p95.add(x);
+}
+
+uint32_t WindowStats::getCount() const {
+    return count;
+}
+
+float WindowStats::getMin() const {
+    return min;
+}
+
+float WindowStats::getMax() const {
+    return max;
+}
+
+float WindowStats::getMean() const {
+    return mean;
+}
+
+float WindowStats::getVariance() const {
+    return count > 1 ? m2 / (count - 1) : 0.0f;
+}
+
+float WindowStats::getStdDev() const {
+    return sqrtf(getVariance());
+}
+
+float WindowStats::getP5() const {
+    return p5.get();
+}
+
+float WindowStats::getP50() const {
+    return p50.get();
+}
+
+float WindowStats::getP95() const {
+    return p95.get();
+}
@@ -0,0 +1,61 @@
+#ifndef COMP_ESTADISTICAS_H
+#define COMP_ESTADISTICAS_H
+
+#include <stdint.h>
+
+/**
+ *  Streaming quantile estimate with the P² algorithm (Jain & Chlamtac).
+ *  Five markers track the minimum, p/2, p, (1+p)/2 and the maximum;
+ *  every update is O(1) and the state is fixed size.
+ */
+class P2Quantile {
+public:
+    explicit P2Quantile(float p = 0.5f);
+    void reset();
+    void add(float x);
+    float get() const;
+
+private:
+    float    p;
+    uint32_t count;
+    float    height[5];     // marker heights
+    int32_t  position[5];   // actual marker positions (1-based)
+    float    desired[5];    // desired marker positions
+
+    float parabolic(uint8_t i, int8_t d) const;
+    float linear(uint8_t i, int8_t d) const;
+};
+
+/**
+ *  Summary of one vital over a reporting window: min, max, mean and
+ *  variance (Welford) plus approximate p5/p50/p95. O(1) per sample,
+ *  no heap.
+ */
+class WindowStats {
+public:
+    WindowStats();
+    void reset();
+    void add(float x);
+
+    uint32_t getCount() const;
+    float getMin() const;
+    float getMax() const;
+    float getMean() const;
+    float getVariance() const;   // sample variance
+    float getStdDev() const;
+    float getP5() const;
+    float getP50() const;
+    float getP95() const;
+
+private:
+    uint32_t count;
+    float    min;
+    float    max;
+    float    mean;
+    float    m2;
+    P2Quantile p5;
+    P2Quantile p50;
+    P2Quantile p95;
+};
+
+#endif // COMP_ESTADISTICAS_H
@@ -0,0 +1,176 @@
+#include "COMP_GEOCERCA.h"
+
+Geofence::Geofence() {
+    clear();
+}
+
+void Geofence::clear() {
+    zoneCount = 0;
+    vertexCount = 0;
+    built = false;
+    insideCount = 0;
+    gridLat = gridLon = 0.0f;
+    cellsPerLat = cellsPerLon = 0.0f;
+}
+
+bool Geofence::addZone(uint16_t id, const float *latitudes, const float *longitudes, uint16_t count) {
+    if (count < 3 || zoneCount >= GEOFENCE_MAX_ZONES ||
+        (uint32_t)vertexCount + count > GEOFENCE_MAX_VERTICES) return false;
+
+    Zone &zone = zones[zoneCount];
+    zone.id = id;
+    zone.firstVertex = vertexCount;
+    zone.vertexCount = count;
+    zone.minLat = zone.maxLat = latitudes[0];
+    zone.minLon = zone.maxLon = longitudes[0];
+    for (uint16_t i = 0; i < count; i++) {
+        float lat = latitudes[i], lon = longitudes[i];
+        vertexLat[vertexCount] = lat;
+        vertexLon[vertexCount] = lon;
+        vertexCount++;
+        if (lat < zone.minLat) zone.minLat = lat;
+        if (lat > zone.maxLat) zone.maxLat = lat;
+        if (lon < zone.minLon) zone.minLon = lon;
+        if (lon > zone.maxLon) zone.maxLon = lon;
+    }
+    zoneCount++;
+    built = false;
+    return true;
+}
+
+bool Geofence::build() {
+    built = false;
+    insideCount = 0;
+    if (zoneCount == 0) return true;
+
+    // Grid over the union of the bounding boxes
+    float minLat = zones[0].minLat, maxLat = zones[0].maxLat;
+    float minLon = zones[0].minLon, maxLon = zones[0].maxLon;
+    for (uint16_t z = 1; z < zoneCount; z++) {
+        if (zones[z].minLat < minLat) minLat = zones[z].minLat;
+        if (zones[z].maxLat > maxLat) maxLat = zones[z].maxLat;
+        if (zones[z].minLon < minLon) minLon = zones[z].minLon;
+        if (zones[z].maxLon > maxLon) maxLon = zones[z].maxLon;
+    }
+    float spanLat = maxLat - minLat, spanLon = maxLon - minLon;
+    if (spanLat <= 0.0f) spanLat = 1e-6f;
+    if (spanLon <= 0.0f) spanLon = 1e-6f;
+    gridLat = minLat;
+    gridLon = minLon;
+    // Slightly smaller than GRID / span so the far edge stays in the last cell
+    cellsPerLat = GEOFENCE_GRID / (spanLat * 1.0001f);
+    cellsPerLon = GEOFENCE_GRID / (spanLon * 1.0001f);
+
+    // Two passes: count the zones per cell, then fill the flat list. A
+    // cell holds at most GEOFENCE_MAX_ZONES entries, so the per-cell
+    // counts fit cellStart; the running total is checked in 32 bits
+    const uint32_t CELLS = (uint32_t)GEOFENCE_GRID * GEOFENCE_GRID;
+    for (uint32_t c = 0; c <= CELLS; c++) cellStart[c] = 0;
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint16_t z = 0; z < zoneCount; z++) {
+            int32_t r0 = (int32_t)((zones[z].minLat - gridLat) * cellsPerLat);
+            int32_t r1 = (int32_t)((zones[z].maxLat - gridLat) * cellsPerLat);
+            int32_t c0 = (int32_t)((zones[z].minLon - gridLon) * cellsPerLon);
+            int32_t c1 = (int32_t)((zones[z].maxLon - gridLon) * cellsPerLon);
+            if (r1 >= GEOFENCE_GRID) r1 = GEOFENCE_GRID - 1;
+            if (c1 >= GEOFENCE_GRID) c1 = GEOFENCE_GRID - 1;
+            for (int32_t r = r0; r <= r1; r++) {
+                for (int32_t c = c0; c <= c1; c++) {
+                    uint32_t cell = (uint32_t)(r * GEOFENCE_GRID + c);
+                    if (pass == 0) cellStart[cell + 1]++;
+                    else cellZones[cellStart[cell]++] = z;
+                }
+            }
+        }
+        if (pass == 0) {
+            uint32_t total = 0;
+            for (uint32_t c = 0; c < CELLS; c++) {
+                total += cellStart[c + 1];
+                if (total > GEOFENCE_MAX_CELL_ENTRIES) return false;
+                cellStart[c + 1] = (uint16_t)total;
+            }
+        } else {
+            // The fill advanced every start to the next cell's; shift back
+            for (uint32_t c = CELLS; c > 0; c--) cellStart[c] = cellStart[c - 1];
+            cellStart[0] = 0;
+        }
+    }
+    built = true;
+    return true;
+}
+
+int32_t Geofence::cellOf(float latitude, float longitude) const {
+    float r = (latitude - gridLat) * cellsPerLat;
+    float c = (longitude - gridLon) * cellsPerLon;
+    if (r < 0.0f || c < 0.0f || r >= GEOFENCE_GRID || c >= GEOFENCE_GRID) return -1;
+    return (int32_t)r * GEOFENCE_GRID + (int32_t)c;
+}
+
+bool Geofence::contains(const Zone &zone, float latitude, float longitude) const {
+    if (latitude < zone.minLat || latitude > zone.maxLat ||
+        longitude < zone.minLon || longitude > zone.maxLon) return false;
+
+    // Ray casting along the longitude axis
+    const float *lat = &vertexLat[zone.firstVertex];
+    const float *lon = &vertexLon[zone.firstVertex];
+    bool in = false;
+    for (uint16_t i = 0, j = zone.vertexCount - 1; i < zone.vertexCount; j = i++) {
+        if ((lat[i] > latitude) != (lat[j] > latitude) &&
+            longitude < (lon[j] - lon[i]) * (latitude - lat[i]) / (lat[j] - lat[i]) + lon[i]) {
+            in = !in;
+        }
+    }
+    return in;
+}
+
+uint8_t Geofence::update(float latitude, float longitude, GeofenceEvent *events, uint8_t maxEvents) {
+    if (!built) return 0;
+
+    // Zones of this cell that contain the fix
+    uint16_t now[GEOFENCE_MAX_INSIDE];
+    uint8_t nowCount = 0;
+    int32_t cell = cellOf(latitude, longitude);
+    if (cell >= 0) {
+        for (uint16_t k = cellStart[cell]; k < cellStart[cell + 1] && nowCount < GEOFENCE_MAX_INSIDE; k++) {
+            if (contains(zones[cellZones[k]], latitude, longitude)) now[nowCount++] = cellZones[k];
+        }
+    }
+
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < insideCount; i++) {
+        bool still = false;
+        for (uint8_t j = 0; j < nowCount && !still; j++) still = now[j] == inside[i];
+        if (!still && n < maxEvents) events[n++] = { zones[inside[i]].id, false };
+    }
+    for (uint8_t j = 0; j < nowCount; j++) {
+        bool before = false;
+        for (uint8_t i = 0; i < insideCount && !before; i++) before = inside[i] == now[j];
+        if (!before && n < maxEvents) events[n++] = { zones[now[j]].id, true };
+    }
+
+    for (uint8_t j = 0; j < nowCount; j++) inside[j] = now[j];
+    insideCount = nowCount;
+    return n;
+}
+
+int32_t Geofence::findZone(float latitude, float longitude) const {
+    if (!built) return -1;
+    int32_t cell = cellOf(latitude, longitude);
+    if (cell < 0) return -1;
+    for (uint16_t k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+        if (contains(zones[cellZones[k]], latitude, longitude)) return zones[cellZones[k]].id;
+    }
+    return -1;
+}
+
+uint16_t Geofence::getZoneCount() const {
+    return zoneCount;
+}
+
+uint8_t Geofence::getInsideCount() const {
+    return insideCount;
+}
+
+uint16_t Geofence::getInsideZoneId(uint8_t index) const {
+    return zones[inside[index]].id;
+}
@@ -0,0 +1,122 @@
+#ifndef COMP_GEOCERCA_H
+#define COMP_GEOCERCA_H
+
+#include <stdint.h>
+
+// Capacity of the zone table (all storage is static). The defaults are
+// sized for the firmware, about 5 KB of DRAM; a build with many zones
+// raises them
+#ifndef GEOFENCE_MAX_ZONES
+#define GEOFENCE_MAX_ZONES 16
+#endif
+
+#ifndef GEOFENCE_MAX_VERTICES
+#define GEOFENCE_MAX_VERTICES 256
+#endif
+
+// Cells per side of the uniform grid
+#ifndef GEOFENCE_GRID
+#define GEOFENCE_GRID 16
+#endif
+
+// (cell, zone) pairs stored by the grid: a zone alone spans every cell
+// of a grid fitted to it
+#ifndef GEOFENCE_MAX_CELL_ENTRIES
+#define GEOFENCE_MAX_CELL_ENTRIES 1024
+#endif
+
+// Overlapping zones a position can be inside at the same time
+#ifndef GEOFENCE_MAX_INSIDE
+#define GEOFENCE_MAX_INSIDE 8
+#endif
+
+// Zone membership change produced by Geofence::update()
+struct GeofenceEvent {
+    uint16_t zoneId;
+    bool     entered;   // false: exited
+};
+
+/**
+ *  Polygon zones with a uniform-grid index.
+ *  Vertices of all zones live in two flat arrays; every grid cell lists
+ *  the zones whose bounding box overlaps it, so a fix is only tested
+ *  against the few polygons of its cell. Evaluation never allocates.
+ */
+class Geofence {
+public:
+    Geofence();
+
+    // Remove all zones and the membership state
+    void clear();
+
+    /**
+     *  Add a polygon (vertices in order, not closed). Call build() after
+     *  the last zone.
+     *  @return false if the zone or vertex table is full
+     */
+    bool addZone(uint16_t id, const float *latitudes, const float *longitudes, uint16_t count);
+
+    /**
+     *  Build the grid index over the zones added so far.
+     *  @return false if the cell table is too small
+     */
+    bool build();
+
+    /**
+     *  Evaluate a fix and report entries/exits since the previous one.
+     *  @param events     Output array
+     *  @param maxEvents  Size of events
+     *  @return Number of events written
+     */
+    uint8_t update(float latitude, float longitude, GeofenceEvent *events, uint8_t maxEvents);
+
+    // Id of the first zone containing the point, or -1
+    int32_t findZone(float latitude, float longitude) const;
+
+    uint16_t getZoneCount() const;
+    uint8_t getInsideCount() const;
+    uint16_t getInsideZoneId(uint8_t index) const;
+
+private:
+    struct Zone {
+        float    minLat, maxLat, minLon, maxLon;
+        uint16_t firstVertex;
+        uint16_t vertexCount;
+        uint16_t id;
+    };
+
+    Zone     zones[GEOFENCE_MAX_ZONES];
+    uint16_t zoneCount;
+
+    float    vertexLat[GEOFENCE_MAX_VERTICES];
+    float    vertexLon[GEOFENCE_MAX_VERTICES];
+    uint16_t vertexCount;
+
+    // Zone, vertex and cell-entry indices are stored as uint16_t
+    static_assert(GEOFENCE_MAX_ZONES >= 1 && GEOFENCE_MAX_ZONES <= 0xFFFF,
+                  "GEOFENCE_MAX_ZONES must be 1..65535");
+    static_assert(GEOFENCE_MAX_VERTICES >= 3 && GEOFENCE_MAX_VERTICES <= 0xFFFF,
+                  "GEOFENCE_MAX_VERTICES must be 3..65535");
+    static_assert(GEOFENCE_MAX_CELL_ENTRIES >= 1 && GEOFENCE_MAX_CELL_ENTRIES <= 0xFFFF,
+                  "GEOFENCE_MAX_CELL_ENTRIES must be 1..65535");
+    static_assert(GEOFENCE_GRID >= 1 && GEOFENCE_GRID <= 1024,
+                  "GEOFENCE_GRID must be 1..1024");
+    static_assert(GEOFENCE_MAX_INSIDE >= 1 && GEOFENCE_MAX_INSIDE <= 0xFF,
+                  "GEOFENCE_MAX_INSIDE must be 1..255");
+
+    // Grid: zones of cell c are cellZones[cellStart[c] .. cellStart[c + 1])
+    float    gridLat, gridLon;           // south-west corner
+    float    cellsPerLat, cellsPerLon;   // inverse cell size
+    uint16_t cellStart[GEOFENCE_GRID * GEOFENCE_GRID + 1];
+    uint16_t cellZones[GEOFENCE_MAX_CELL_ENTRIES];
+    bool     built;
+
+    // Zones (indices) containing the last fix
+    uint16_t inside[GEOFENCE_MAX_INSIDE];
+    uint8_t  insideCount;
+
+    int32_t cellOf(float latitude, float longitude) const;
+    bool contains(const Zone &zone, float latitude, float longitude) const;
+};
+
+#endif // COMP_GEOCERCA_H
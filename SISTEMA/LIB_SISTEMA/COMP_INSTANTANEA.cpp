@@ -0,0 +1,50 @@
+#include "COMP_INSTANTANEA.h"
+
+VitalsBoard::VitalsBoard() {
+    begin(0);
+}
+
+void VitalsBoard::begin(uint8_t channel) {
+    memset(&staging, 0, sizeof(staging));
+    staging.channel = channel;
+}
+
+void VitalsBoard::updatePulse(float bpm, uint8_t spo2, uint8_t quality, bool fingerPresent, uint32_t nowMs) {
+    staging.fingerPresent = fingerPresent;
+    staging.bpm = bpm;
+    staging.spo2 = spo2;
+    staging.quality = quality;
+    if (fingerPresent && bpm > 0.0f) staging.pulseMs = nowMs ? nowMs : 1;
+}
+
+void VitalsBoard::updateClimate(float temperature, float humidity, uint32_t nowMs) {
+    staging.temperature = temperature;
+    staging.humidity = humidity;
+    staging.climateMs = nowMs ? nowMs : 1;
+}
+
+void VitalsBoard::updateLocation(double latitude, double longitude, uint32_t nowMs) {
+    staging.latitude = latitude;
+    staging.longitude = longitude;
+    staging.locationMs = nowMs ? nowMs : 1;
+}
+
+void VitalsBoard::publish(uint32_t nowMs) {
+    // The version stored inside is the sequence number the copy will carry
+    staging.version = SeqLock<VitalsSnapshot>::next(published.version());
+    staging.publishedMs = nowMs;
+    published.store(staging);
+}
+
+bool VitalsBoard::read(VitalsSnapshot &out) const {
+    return published.load(out) != 0;
+}
+
+uint32_t VitalsBoard::version() const {
+    return published.version();
+}
+
+uint32_t VitalsBoard::ageMs(uint32_t fieldMs, uint32_t nowMs) {
+    if (fieldMs == VITALS_NEVER) return UINT32_MAX;
+    return nowMs - fieldMs;
+}
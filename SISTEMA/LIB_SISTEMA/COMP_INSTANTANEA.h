@@ -0,0 +1,144 @@
+#ifndef COMP_INSTANTANEA_H
+#define COMP_INSTANTANEA_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ *  Single-writer sequence lock.
+ *  The writer never waits: it bumps the sequence to an odd value, copies
+ *  the payload and bumps it again. Readers copy the payload and retry if
+ *  the sequence was odd or changed meanwhile, so they always get a
+ *  consistent (torn-free) copy and never block the writer.
+ *  The payload is stored as relaxed atomic words so concurrent copies are
+ *  well defined.
+ */
+template <class T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() : seq(0) {
+        for (size_t i = 0; i < WORDS; i++) words[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Producer side (one writer only). Wait-free.
+    void store(const T &value) {
+        uint32_t tmp[WORDS] = {};
+        memcpy(tmp, &value, sizeof(T));
+
+        uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) words[i].store(tmp[i], std::memory_order_relaxed);
+        seq.store(next(s), std::memory_order_release);
+    }
+
+    // Sequence number of the store that follows s. 0 means "nothing stored"
+    // to load(), so the wrap goes from 0xFFFFFFFE straight to 2.
+    static uint32_t next(uint32_t s) {
+        return (s + 2 != 0) ? s + 2 : 2;
+    }
+
+    /**
+     *  Consumer side. Copies the latest complete value.
+     *  @param maxAttempts  Give up after this many torn reads (0 = never)
+     *  @return Sequence number of the copy (even), or 0 if it gave up or
+     *          nothing has been stored yet
+     */
+    uint32_t load(T &out, uint32_t maxAttempts = 0) const {
+        uint32_t tmp[WORDS];
+        for (uint32_t attempt = 0; maxAttempts == 0 || attempt < maxAttempts; attempt++) {
+            uint32_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 & 1) continue;   // write in progress
+            for (size_t i = 0; i < WORDS; i++) tmp[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) != s1) continue;
+            memcpy(&out, tmp, sizeof(T));
+            return s1;
+        }
+        return 0;
+    }
+
+    // Current sequence number; changes every time a new value is stored
+    uint32_t version() const {
+        return seq.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> words[WORDS];
+};
+
+// Freshness value of a field that has never been updated
+#define VITALS_NEVER 0
+
+/**
+ *  Consistent view of one measurement site. Every group of fields keeps
+ *  the millis() time of its last valid update (VITALS_NEVER if none), so
+ *  consumers can decide for themselves what is too old.
+ */
+struct VitalsSnapshot {
+    uint32_t version;       // sequence number of the publication
+    uint32_t publishedMs;   // millis() at publication
+    uint8_t  channel;
+
+    // Pulse (MAX30102)
+    bool     fingerPresent;
+    float    bpm;
+    uint8_t  spo2;
+    uint8_t  quality;       // signal quality of the last PPG window (0-100)
+    uint32_t pulseMs;
+
+    // Climate (SHT31)
+    float    temperature;
+    float    humidity;
+    uint32_t climateMs;
+
+    // Location (GPS)
+    double   latitude;
+    double   longitude;
+    uint32_t locationMs;
+};
+
+/**
+ *  Publication point for the vitals of one site.
+ *  The sampling loop updates fields on a private staging copy and calls
+ *  publish(); any number of consumers (display, logger, alerts) call
+ *  read() from other tasks without taking a lock.
+ */
+class VitalsBoard {
+public:
+    VitalsBoard();
+
+    // Producer side (single task)
+    void begin(uint8_t channel);
+    void updatePulse(float bpm, uint8_t spo2, uint8_t quality, bool fingerPresent, uint32_t nowMs);
+    void updateClimate(float temperature, float humidity, uint32_t nowMs);
+    void updateLocation(double latitude, double longitude, uint32_t nowMs);
+    void publish(uint32_t nowMs);
+
+    /**
+     *  Consumer side.
+     *  @return false if nothing has been published yet
+     */
+    bool read(VitalsSnapshot &out) const;
+    uint32_t version() const;
+
+    /**
+     *  Age of a field group in milliseconds.
+     *  @return UINT32_MAX if the field was never updated
+     */
+    static uint32_t ageMs(uint32_t fieldMs, uint32_t nowMs);
+
+private:
+    VitalsSnapshot staging;
+    SeqLock<VitalsSnapshot> published;
+};
+
+#endif // COMP_INSTANTANEA_H
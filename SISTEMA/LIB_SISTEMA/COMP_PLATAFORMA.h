@@ -0,0 +1,62 @@
+#ifndef COMP_PLATAFORMA_H
+#define COMP_PLATAFORMA_H
+
+#include <stdint.h>
+
+// Timebase used by drivers and processors. On the target it is the
+// Arduino core; on a host build the same names map to std::chrono so the
+// libraries compile and run unchanged. Host tests can define
+// PLATFORM_SIMULATED_TIME: time then only moves with delay() and
+// delayMicroseconds(), so minutes of signal replay in milliseconds.
+#ifdef ARDUINO
+#include <Arduino.h>
+#elif defined(PLATFORM_SIMULATED_TIME)
+inline uint64_t &platformSimulatedUs() {
+    static uint64_t us = 0;
+    return us;
+}
+
+inline uint32_t micros() {
+    return (uint32_t)platformSimulatedUs();
+}
+
+inline uint32_t millis() {
+    return (uint32_t)(platformSimulatedUs() / 1000);
+}
+
+inline void delay(uint32_t ms) {
+    platformSimulatedUs() += (uint64_t)ms * 1000;
+}
+
+inline void delayMicroseconds(uint32_t us) {
+    platformSimulatedUs() += us;
+}
+#else
+#include <chrono>
+#include <thread>
+
+inline std::chrono::steady_clock::duration platformUptime() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::steady_clock::now() - origin;
+}
+
+// Each one wraps on its own width, as on the target: micros() after about
+// 71.6 minutes, millis() after about 49.7 days
+inline uint32_t micros() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(platformUptime()).count();
+}
+
+inline uint32_t millis() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(platformUptime()).count();
+}
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+#endif
+
+#endif // COMP_PLATAFORMA_H
@@ -0,0 +1,32 @@
+#ifndef COMP_TRAMA_H
+#define COMP_TRAMA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ *  Binary frames interleaved with the text output of the firmware, shared
+ *  with the collector. They start a line; NUL never appears in the text
+ *  reports, so it marks a frame:
+ *
+ *      0x00  type  length(LE16)  payload[length]
+ */
+#define FRAME_START    0x00
+#define FRAME_HISTORY  0x01   // TimeSeriesEncoder block (COMP_COMPRESION)
+
+// Size of the frame header in front of the payload
+#define FRAME_HEADER_SIZE 4
+
+/**
+ *  Write the header of a frame.
+ *  @param out  At least FRAME_HEADER_SIZE bytes
+ */
+inline size_t writeFrameHeader(uint8_t *out, uint8_t type, uint16_t length) {
+    out[0] = FRAME_START;
+    out[1] = type;
+    out[2] = (uint8_t)(length & 0xFF);
+    out[3] = (uint8_t)(length >> 8);
+    return FRAME_HEADER_SIZE;
+}
+
+#endif // COMP_TRAMA_H
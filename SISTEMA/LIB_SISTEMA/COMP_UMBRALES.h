@@ -0,0 +1,31 @@
+#ifndef COMP_UMBRALES_H
+#define COMP_UMBRALES_H
+
+#include <stdint.h>
+
+// Alert thresholds shared by the firmware and the collector
+constexpr float TEMP_ALERT_THRESHOLD     = 37.5f;  // °C
+constexpr float HR_ALERT_HIGH_THRESHOLD  = 120.0f; // BPM
+constexpr float HR_ALERT_LOW_THRESHOLD   =  50.0f; // BPM
+
+// Alert flags
+#define ALERT_TEMPERATURE  0x01
+#define ALERT_HEART_RATE   0x02
+#define ALERT_GEOFENCE     0x04   // outside every care zone
+
+/**
+ *  Evaluate the alert thresholds.
+ *  @param hasTemperature  False if the temperature is not available
+ *  @param bpm             0 when no heart rate is available
+ *  @return ALERT_* mask
+ */
+inline uint8_t evaluateAlerts(bool hasTemperature, float temperature, float bpm) {
+    uint8_t alerts = 0;
+    if (hasTemperature && temperature >= TEMP_ALERT_THRESHOLD) alerts |= ALERT_TEMPERATURE;
+    if (bpm >= HR_ALERT_HIGH_THRESHOLD || (bpm > 0 && bpm <= HR_ALERT_LOW_THRESHOLD)) {
+        alerts |= ALERT_HEART_RATE;
+    }
+    return alerts;
+}
+
+#endif // COMP_UMBRALES_H
@@ -3,32 +3,61 @@
 #include "LIB_MAX30102.h"
 #include "COMP_RITMO_CARDIACO.h"
 #include "COMP_SPO2.h"
+#include "COMP_VARIABILIDAD.h"
+#include "COMP_PRESENCIA.h"
+#include "COMP_GANANCIA.h"
+#include "COMP_CALIDAD.h"
+#include "COMP_COMPRESION.h"
+#include "COMP_TRAMA.h"
+#include "COMP_CANALES.h"
+#include "COMP_BUS_I2C.h"
+#include "COMP_INSTANTANEA.h"
+#include "COMP_UMBRALES.h"
+#include "COMP_GEOCERCA.h"
+#include "COMP_ESTADISTICAS.h"
 #include <TinyGPSPlus.h>
 #include <HardwareSerial.h>
 #include <TimeLib.h>
 #include <Wire.h>
+#include <sys/time.h>
+#include <esp_sleep.h>
 
 // --- Configuración de umbrales ---
-constexpr float TEMP_ALERT_THRESHOLD     = 37.5f;  // °C
-constexpr float HR_ALERT_HIGH_THRESHOLD  = 120.0f; // BPM
-constexpr float HR_ALERT_LOW_THRESHOLD   =  50.0f; // BPM
+// TEMP_ALERT_THRESHOLD y HR_ALERT_* están en COMP_UMBRALES.h (compartidos
+// con el colector)
 
 // --- Intervalos y temporizadores ---
 constexpr uint32_t READING_INTERVAL_MS   = 60000; // Periodo de análisis (1 minuto)
 static uint32_t lastReadingTimestamp = 0;
 
+// --- Bus I2C compartido ---
+I2CBusManager i2cBus(Wire);
+
 // --- SHT31 ---
-SHT31 sht31;
+SHT31T<ManagedBus> sht31(i2cBus);
 
 // --- MAX30102 ---
-MAX30102 maxSensor;
-HeartRateProcessor hrProcessor;
-SpO2Processor spo2Processor;
-float dcIR = 0.0f;
-float dcRed = 0.0f;
-bool fingerPresent = false;
-uint32_t lastSerialPrint = 0;
-static float lastValidBPM = 0.0f;
+MAX30102T<ManagedBus> maxSensor(i2cBus);
+
+// --- Canales de medición ---
+// Cada sitio (cama/paciente) es un canal con su MAX30102 y SHT31. Para más
+// sitios se agregan canales detrás de un TCA9548A o en el bus Wire1.
+SensorChannelsT<ManagedBus> channels;
+constexpr uint32_t BUS_BUDGET_US = 2000;  // Tiempo máximo de bus por ciclo
+// Perfil de adquisición: PROFILE_LOW_POWER, PROFILE_STANDARD,
+// PROFILE_HIGH_RES_400 o PROFILE_HIGH_RES_800 (ver COMP_PERFILES.h)
+const AcquisitionProfile &ACQUISITION_PROFILE = PROFILE_STANDARD;
+// Sin dedo el sensor queda en reposo (LED IR tenue, sin DSP) y el perfil
+// de adquisición se activa al detectar presencia
+constexpr bool PRESENCE_DETECTION = true;
+// Control automático de la corriente de los LED (nivel DC en la banda
+// objetivo del ADC)
+constexpr bool LED_GAIN_CONTROL = true;
+
+// --- Signos vitales publicados ---
+// Un snapshot consistente por canal; pantalla, registro y alertas lo leen
+// sin bloquear el muestreo.
+VitalsBoard vitals[SENSOR_MAX_CHANNELS];
 
 // --- GPS (NEO6MV2) ---
 static const int RXPin = 16;
@@ -38,121 +67,406 @@ const int UTC_OFFSET_SECONDS = -5 * 3600;
 TinyGPSPlus gps;
 HardwareSerial GPS_Serial(2);
 
-// --- Constantes MAX30102 internos ---
-constexpr uint32_t FINGER_TH_ON  = 30000;
-constexpr uint32_t FINGER_TH_OFF = 20000;
-constexpr float DC_ALPHA        = 0.95f;
-constexpr uint32_t SERIAL_UPDATE_INTERVAL = 1000;
-constexpr uint8_t LINE_CLEAR_WIDTH = 40;
+// --- Geocercas (zonas de cuidado) ---
+// Polígonos lat/lon de cada zona; más zonas se agregan en setup() con
+// geofence.addZone(). Cada fix del GPS se evalúa contra el índice en rejilla.
+constexpr uint16_t CARE_ZONE_ID = 1;
+static const float CARE_ZONE_LAT[] = { 6.2450f, 6.2450f, 6.2434f, 6.2434f };
+static const float CARE_ZONE_LON[] = { -75.5822f, -75.5802f, -75.5802f, -75.5822f };
+Geofence geofence;
+bool outsideCareZone = false;
+
+// --- Historial comprimido ---
+// Un bloque se llena en varias horas: el búfer va en la memoria RTC para
+// que sobreviva al deep sleep del ciclo de trabajo (su estado, en rtcState)
+constexpr size_t HISTORY_BUFFER_SIZE = 4096;      // bytes por bloque (máx. PROTOCOL_MAX_FRAME del colector)
+RTC_DATA_ATTR static uint8_t historyBuffer[HISTORY_BUFFER_SIZE];
+TimeSeriesEncoder historyEncoder;
+
+// --- Arranque y estado de los dispositivos ---
+// Conexión/desconexión de cada sensor y tiempo hasta su primer valor válido
+static uint32_t bringUpMs = 0;
+static bool deviceOnline[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+static uint32_t reportedAttach[SENSOR_MAX_CHANNELS][DEVICE_KIND_COUNT];
+static bool gpsFixReported = false;
+static bool gpsMissingReported = false;
+constexpr uint32_t GPS_SILENT_MS = 5000;  // Sin bytes del GPS: se avisa
+
+// --- Ciclo de trabajo (deep sleep) ---
+// Con DUTY_CYCLE el ESP32 duerme entre reportes: despierta por temporizador,
+// adquiere durante ACQUISITION_WINDOW_MS, reporta y vuelve a dormir. El
+// MAX30102 queda en shutdown con su configuración; el estado del
+// procesamiento, la hora, la última posición y el bloque de historial en
+// curso pasan por la memoria RTC, así
+// al despertar no se repite la espera inicial del detector de latidos ni el
+// asentamiento de filtros y ganancia.
+constexpr bool DUTY_CYCLE = false;
+constexpr uint32_t ACQUISITION_WINDOW_MS = 8000;  // Despierto por ciclo
+constexpr uint32_t MIN_SLEEP_MS = 1000;
+constexpr uint32_t RTC_MAGIC = 0x56495431;        // "VIT1": estado válido
+
+struct RetainedState {
+  uint32_t magic;
+  uint32_t wakeCount;
+  uint32_t epoch;          // Hora (TimeLib) al dormir, 0 si no había hora
+  int64_t  sleepStartUs;   // Reloj RTC al dormir (sigue contando en deep sleep)
+  bool     hasLocation;
+  double   latitude;
+  double   longitude;
+  SensorChannelsT<ManagedBus>::RetainedChannel channels[SENSOR_MAX_CHANNELS];
+  TimeSeriesEncoder::Retained history;
+};
+RTC_DATA_ATTR RetainedState rtcState;
 
 void setup() {
+  // Sin esperar al monitor serie: sin USB conectado el equipo arranca igual
   Serial.begin(115200);
-  while (!Serial) { delay(10); }
+  bool warm = DUTY_CYCLE && rtcState.magic == RTC_MAGIC &&
+              esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
 
-  // Inicializa bus I2C y sensores
-  Wire.begin();
-  if (!sht31.begin()) {
-    Serial.println("Error al iniciar SHT31: " + String(sht31.getErrorMessage()));
-    while (true) delay(1000);
-  }
-  Serial.println("SHT31 iniciado correctamente.");
+  // El GPS primero: la UART recibe sentencias mientras se inicia el resto
+  bringUpMs = millis();
+  GPS_Serial.begin(GPSBaud, SERIAL_8N1, RXPin, TXPin);
 
-  if (!maxSensor.begin()) {
-    Serial.println("Error: MAX30102 no encontrado.");
-    while (true) delay(100);
+  // Configuración de canales antes de iniciarlos, así cada sensor recibe
+  // su configuración final en una sola ráfaga
+  i2cBus.begin();
+  channels.addChannel(&maxSensor, &sht31);
+  channels.setProfile(ACQUISITION_PROFILE);
+  channels.setPresenceDetection(PRESENCE_DETECTION);
+  channels.setGainControl(LED_GAIN_CONTROL);
+  for (uint8_t ch = 0; ch < channels.getChannelCount(); ch++) vitals[ch].begin(ch);
+
+  // Sin bloqueo: el soft reset del SHT31 corre mientras se configura el
+  // MAX30102. Un sensor ausente no detiene el equipo, se reintenta en
+  // segundo plano. Al despertar del deep sleep se reanuda en caliente.
+  uint8_t up = warm ? channels.resumeAll(rtcState.channels) : channels.beginAll();
+  if (up < channels.getChannelCount()) {
+    Serial.println("Aviso: funcionamiento degradado, sensores ausentes se reintentan en segundo plano.");
+    if (!channels.isDeviceOnline(0, DEVICE_CLIMATE)) Serial.println("SHT31: " + String(sht31.getErrorMessage()));
   }
-  maxSensor.setup();
-  hrProcessor.reset();
-  spo2Processor.reset();
-  lastSerialPrint = millis();
-  Serial.println("MAX30102 iniciado correctamente.");
+  reportDevices();
+  Serial.printf("Perfil de adquisición: %s (%u Hz)\n", ACQUISITION_PROFILE.name,
+                (unsigned)profileOutputRateHz(ACQUISITION_PROFILE));
 
-  GPS_Serial.begin(GPSBaud, SERIAL_8N1, RXPin, TXPin);
-  Serial.println("GPS iniciado correctamente.");
+  geofence.addZone(CARE_ZONE_ID, CARE_ZONE_LAT, CARE_ZONE_LON,
+                   sizeof(CARE_ZONE_LAT) / sizeof(CARE_ZONE_LAT[0]));
+  if (!geofence.build()) Serial.println("Error al construir las geocercas.");
+  if (warm) restoreRetained();
+
+  if (warm) historyEncoder.restore(historyBuffer, HISTORY_BUFFER_SIZE, rtcState.history);
+  else      historyEncoder.begin(historyBuffer, HISTORY_BUFFER_SIZE);
+  if (warm) Serial.printf("Reanudación %lu en %lu ms\n", (unsigned long)rtcState.wakeCount, (unsigned long)millis());
+  else      Serial.printf("Arranque en %lu ms\n", (unsigned long)millis());
 }
 
 void loop() {
   uint32_t now = millis();
-  // Ejecutar lógica de monitoreo en intervalos definidos
-  if (now - lastReadingTimestamp < READING_INTERVAL_MS) {
+  // Ejecutar lógica de monitoreo en intervalos definidos (con ciclo de
+  // trabajo, al final de la ventana de adquisición)
+  uint32_t interval = DUTY_CYCLE ? ACQUISITION_WINDOW_MS : READING_INTERVAL_MS;
+  if (now - lastReadingTimestamp < interval) {
     // Actualizar lectura continua del GPS y sensor de pulso
     readGPS();
     processMAX30102();
+    reportDevices();
     return;
   }
   lastReadingTimestamp = now;
 
-  // 1) Lectura SHT31
-  float temperature, humidity;
-  bool okTemp = sht31.read(temperature, humidity);
-
-  // 2) Lectura frecuencia cardíaca y SpO2
+  // 1) Lectura frecuencia cardíaca y SpO2
   processMAX30102();
-  float currentBPM = lastValidBPM;
 
-  // 3) Actualizar GPS antes de enviar resultado
+  // 2) Actualizar GPS antes de enviar resultado
   readGPS();
 
-  // 4) Evaluar condiciones de alerta
-  bool alertTemp = okTemp && (temperature >= TEMP_ALERT_THRESHOLD);
-  bool alertHR   = (currentBPM >= HR_ALERT_HIGH_THRESHOLD) ||
-                   (currentBPM > 0 && currentBPM <= HR_ALERT_LOW_THRESHOLD);
-
-  // 5) Obtener timestamp formateado
+  // 3) Obtener timestamp formateado
   char bufferTime[20];
   sprintf(bufferTime, "%02d/%02d/%04d %02d:%02d:%02d", day(), month(), year(), hour(), minute(), second());
 
-  // 6) Mensaje de salida
-  if (alertTemp || alertHR) {
-    Serial.println("*** ALERTA DE SALUD ***");
-    if (alertTemp) Serial.printf("Temperatura alta: %.2f °C\n", temperature);
-    if (alertHR)   Serial.printf("Frecuencia cardiaca anómala: %.1f BPM\n", currentBPM);
-  } else {
-    Serial.println("Estado estable.");
-    if (okTemp) Serial.printf("Temp: %.2f °C, ", temperature);
-    else        Serial.print("Temp: N/A, ");
-    Serial.printf("BPM: %.1f, SpO2: %u%%\n", currentBPM, spo2Processor.getSpO2());
+  for (uint8_t ch = 0; ch < channels.getChannelCount(); ch++) {
+    reportChannel(ch, bufferTime);
   }
+  reportBus();
+  if (DUTY_CYCLE) sleepUntilNextReading();
+}
+
+void sleepUntilNextReading() {
+  // Estado para la reanudación en caliente; el MAX30102 queda en shutdown
+  channels.suspendAll(rtcState.channels);
+  historyEncoder.save(rtcState.history);
+  rtcState.magic = RTC_MAGIC;
+  rtcState.wakeCount++;
+  rtcState.epoch = (timeStatus() != timeNotSet) ? (uint32_t)now() : 0;
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  rtcState.sleepStartUs = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+
+  // El reporte cada READING_INTERVAL_MS incluye el tiempo despierto
+  uint32_t awakeMs = millis();
+  uint32_t sleepMs = (awakeMs + MIN_SLEEP_MS < READING_INTERVAL_MS) ? READING_INTERVAL_MS - awakeMs : MIN_SLEEP_MS;
+  Serial.printf("Deep sleep %lu ms (despierto %lu ms, ciclo de trabajo %.1f%%)\n",
+                (unsigned long)sleepMs, (unsigned long)awakeMs, 100.0f * awakeMs / (awakeMs + sleepMs));
+  Serial.flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000);
+  esp_deep_sleep_start();
+}
+
+void restoreRetained() {
+  // Hora: la del reloj al dormir más lo dormido
+  if (rtcState.epoch != 0) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int64_t sleptUs = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - rtcState.sleepStartUs;
+    setTime(rtcState.epoch + (uint32_t)(sleptUs / 1000000));
+  }
+  // Última posición: se publica y se reproduce en la geocerca sin eventos,
+  // así la pertenencia a zonas no genera entradas falsas en cada despertar
+  if (rtcState.hasLocation) {
+    for (uint8_t ch = 0; ch < channels.getChannelCount(); ch++) {
+      vitals[ch].updateLocation(rtcState.latitude, rtcState.longitude, millis());
+    }
+    GeofenceEvent events[4];
+    geofence.update(rtcState.latitude, rtcState.longitude, events, 4);
+    outsideCareZone = geofence.getZoneCount() > 0 && geofence.getInsideCount() == 0;
+  }
+}
+
+void reportChannel(uint8_t ch, const char *bufferTime) {
+  // 4) Lectura SHT31 y publicación del snapshot
+  float temperature, humidity;
+  if (channels.readClimate(ch, temperature, humidity)) {
+    vitals[ch].updateClimate(temperature, humidity, millis());
+    vitals[ch].publish(millis());
+  }
+  VitalsSnapshot snap;
+  if (!vitals[ch].read(snap)) return;
+
+  // 5) Resumen de la ventana desde el reporte anterior
+  const WindowStats &wBPM  = channels.getWindow(ch, VITAL_BPM);
+  const WindowStats &wSpO2 = channels.getWindow(ch, VITAL_SPO2);
+  const WindowStats &wTemp = channels.getWindow(ch, VITAL_TEMPERATURE);
+  const WindowStats &wHum  = channels.getWindow(ch, VITAL_HUMIDITY);
+  bool okTemp = wTemp.getCount() > 0;
+  temperature = wTemp.getMean();
+  humidity = wHum.getMean();
+  float meanBPM = wBPM.getMean();
+  uint8_t meanSpO2 = (uint8_t)lroundf(wSpO2.getMean());
+
+  // Alertas sobre la ventana: temperatura máxima y extremos de FC (p5/p95),
+  // así no se pierden ráfagas cortas dentro del intervalo
+  float bpmExtreme = (wBPM.getP95() >= HR_ALERT_HIGH_THRESHOLD) ? wBPM.getP95() : wBPM.getP5();
+  uint8_t alerts = evaluateAlerts(okTemp, wTemp.getMax(), bpmExtreme);
+  if (outsideCareZone) alerts |= ALERT_GEOFENCE;
+  bool alertTemp = alerts & ALERT_TEMPERATURE;
+  bool alertHR   = alerts & ALERT_HEART_RATE;
+  bool alertZone = alerts & ALERT_GEOFENCE;
+
+  // 6) Mensaje de salida: las constantes siempre; las alertas, detrás, con
+  // el valor que las dispara (el colector las marca en flags sin tocar las medias)
+  if (channels.getChannelCount() > 1) Serial.printf("Canal %u\n", ch);
+  bool alert = alertTemp || alertHR || alertZone;
+  Serial.println(alert ? "*** ALERTA DE SALUD ***" : "Estado estable.");
+  if (okTemp) Serial.printf("Temp: %.2f °C, ", temperature);
+  else        Serial.print("Temp: N/A, ");
+  Serial.printf("BPM: %.1f, SpO2: %u%%\n", meanBPM, meanSpO2);
+  if (alertTemp) Serial.printf("Temperatura alta: %.2f °C\n", wTemp.getMax());
+  if (alertHR)   Serial.printf("Frecuencia cardiaca anómala: %.1f BPM\n", bpmExtreme);
+  if (alertZone) Serial.println("Fuera de la zona de cuidado");
+  printWindow("BPM", wBPM, 1);
+  printWindow("SpO2", wSpO2, 0);
+  printWindow("Temp", wTemp, 2);
+  printWindow("Humedad", wHum, 1);
+  printHRV(channels.getHRV(ch));
+  printPresence(channels.getPresence(ch));
+  printGain(channels.getGainControl(ch));
+  printQuality(snap, channels.getQuality(ch));
   // 7) Datos adicionales: hora y ubicación
   Serial.printf("Timestamp: %s\n", bufferTime);
-  Serial.printf("Ubicación: Lat %.6f, Lon %.6f\n", gps.location.lat(), gps.location.lng());
+  Serial.printf("Ubicación: Lat %.6f, Lon %.6f\n", snap.latitude, snap.longitude);
   Serial.println("-------------------------------");
+
+  // 8) Guardar en historial comprimido (sitio principal)
+  if (ch == 0) appendHistory(snap, okTemp, temperature, humidity, meanBPM, meanSpO2);
+  channels.resetWindows(ch);
+  channels.resetPresenceStats(ch);
+  channels.resetGainStats(ch);
+  channels.resetQualityStats(ch);
+}
+
+void printWindow(const char *label, const WindowStats &w, int decimals) {
+  if (w.getCount() == 0) {
+    Serial.printf("  %s: sin datos\n", label);
+    return;
+  }
+  Serial.printf("  %s: media %.*f ± %.*f, min %.*f, p5 %.*f, p50 %.*f, p95 %.*f, max %.*f (n=%lu)\n",
+                label, decimals, w.getMean(), decimals, w.getStdDev(), decimals, w.getMin(),
+                decimals, w.getP5(), decimals, w.getP50(), decimals, w.getP95(),
+                decimals, w.getMax(), (unsigned long)w.getCount());
+}
+
+void printHRV(const HRVProcessor &hrv) {
+  // Ventana deslizante: no se reinicia con el reporte
+  if (hrv.getCount() < 2) {
+    Serial.println("  HRV: sin datos");
+    return;
+  }
+  Serial.printf("  HRV: RMSSD %.1f ms, SDNN %.1f ms, pNN50 %.1f%%, IBI medio %.0f ms (n=%u, descartados %lu)\n",
+                hrv.getRMSSD(), hrv.getSDNN(), hrv.getPNN50(), hrv.getMeanIBI(),
+                (unsigned)hrv.getCount(), (unsigned long)hrv.getRejectedCount());
+}
+
+void printPresence(const PresenceMonitor &presence) {
+  // Tiempo y uso de bus en cada estado desde el reporte anterior
+  uint32_t now = millis();
+  Serial.printf("  Presencia: %s, activo %.1f s (bus %.1f ms), reposo %.1f s (bus %.1f ms), %lu activaciones\n",
+                presence.getState() == PRESENCE_ACTIVE ? "activo" : "reposo",
+                presence.getTimeMs(PRESENCE_ACTIVE, now) / 1000.0f,
+                presence.getBusTimeUs(PRESENCE_ACTIVE) / 1000.0f,
+                presence.getTimeMs(PRESENCE_IDLE, now) / 1000.0f,
+                presence.getBusTimeUs(PRESENCE_IDLE) / 1000.0f,
+                (unsigned long)presence.getWakeCount());
+}
+
+void printGain(const LedGainControl &gain) {
+  // Ajuste actual de los LED y energía por muestra válida desde el reporte anterior
+  Serial.printf("  LED: rojo 0x%02X, IR 0x%02X, rango ADC %u, %lu ajustes, %lu saturadas, %.2f uJ por muestra válida (n=%lu)\n",
+                gain.getRedAmplitude(), gain.getIRAmplitude(), gain.getADCRange(),
+                (unsigned long)gain.getStepCount(), (unsigned long)gain.getSaturatedSamples(),
+                gain.getEnergyPerValidSampleUJ(), (unsigned long)gain.getValidSamples());
+}
+
+void printQuality(const VitalsSnapshot &snap, const SignalQuality &quality) {
+  // Ventanas de PPG evaluadas; las de baja calidad no pasan por el DSP
+  Serial.printf("  Calidad de señal: %u (media %.0f), IP %.2f%%, %lu de %lu ventanas descartadas\n",
+                snap.quality, quality.getMeanScore(), quality.getPerfusionIndex(),
+                (unsigned long)quality.getRejectedCount(), (unsigned long)quality.getWindowCount());
 }
 
 void processMAX30102() {
-  std::vector<std::pair<uint32_t,uint32_t>> samples;
-  if (!maxSensor.readAllFIFO(samples)) return;
-  uint32_t t = millis();
-  for (auto &p : samples) {
-    uint32_t rawRed = p.first;
-    uint32_t rawIR  = p.second;
-    // Detección de dedo
-    if (!fingerPresent && rawIR > FINGER_TH_ON) {
-      fingerPresent = true;
-      hrProcessor.reset(); spo2Processor.reset();
-    } else if (fingerPresent && rawIR < FINGER_TH_OFF) {
-      fingerPresent = false;
-      hrProcessor.reset(); spo2Processor.reset();
-      return;
+  // Vacía las FIFO de todos los canales por turnos dentro del presupuesto de bus
+  channels.poll(BUS_BUDGET_US);
+  // Transacciones de baja prioridad (p. ej. lectura SHT31) después del PPG
+  i2cBus.process(BUS_BUDGET_US);
+  publishVitals();
+}
+
+void publishVitals() {
+  uint32_t now = millis();
+  for (uint8_t ch = 0; ch < channels.getChannelCount(); ch++) {
+    vitals[ch].updatePulse(channels.getBPM(ch), channels.getSpO2(ch), channels.getSignalQuality(ch),
+                           channels.isFingerPresent(ch), now);
+    vitals[ch].publish(now);
+  }
+}
+
+void reportBus() {
+  Serial.printf("Bus I2C: %lu kHz, uso %.1f%%\n",
+                (unsigned long)(i2cBus.getClock() / 1000), i2cBus.getUtilization() * 100.0f);
+  for (uint8_t i = 0; i < i2cBus.getDeviceCount(); i++) {
+    const I2CDeviceStats &d = i2cBus.getDeviceStatsAt(i);
+    uint32_t avgUs = d.transactions ? d.totalLatencyUs / d.transactions : 0;
+    Serial.printf("  0x%02X: %lu trans, %lu errores, %lu reintentos, lat. media %lu us, max %lu us\n",
+                  d.address, (unsigned long)d.transactions, (unsigned long)d.errors,
+                  (unsigned long)d.retries, (unsigned long)avgUs, (unsigned long)d.maxLatencyUs);
+  }
+  i2cBus.resetStats();
+}
+
+void reportDevices() {
+  static const char *const DEVICE_NAMES[DEVICE_KIND_COUNT] = { "MAX30102", "SHT31" };
+  for (uint8_t ch = 0; ch < channels.getChannelCount(); ch++) {
+    for (uint8_t k = 0; k < DEVICE_KIND_COUNT; k++) {
+      DeviceKind kind = (DeviceKind)k;
+      bool online = channels.isDeviceOnline(ch, kind);
+      uint32_t attaches = channels.getAttachCount(ch, kind);
+      if (online != deviceOnline[ch][k]) {
+        deviceOnline[ch][k] = online;
+        Serial.printf("%s (canal %u) %s\n", DEVICE_NAMES[k], ch,
+                      online ? (attaches > 1 ? "reconectado" : "conectado") : "sin respuesta");
+      }
+      uint32_t firstMs = channels.getTimeToFirstVital(ch, kind);
+      if (firstMs != UINT32_MAX && reportedAttach[ch][k] != attaches) {
+        reportedAttach[ch][k] = attaches;
+        Serial.printf("%s (canal %u): primer valor válido %lu ms tras iniciarlo (%lu ms desde el arranque)\n",
+                      DEVICE_NAMES[k], ch, (unsigned long)firstMs, (unsigned long)millis());
+      }
     }
-    if (!fingerPresent) return;
-    // Eliminación DC y procesamiento
-    dcIR  = DC_ALPHA*dcIR  + (1.0f-DC_ALPHA)*rawIR;
-    dcRed = DC_ALPHA*dcRed + (1.0f-DC_ALPHA)*rawRed;
-    float acIR  = float(rawIR)  - dcIR;
-    float acRed = float(rawRed) - dcRed;
-    bool beat = hrProcessor.update(acIR, t);
-    spo2Processor.update(acIR, acRed, beat);
-    float rawBPM = hrProcessor.getBPM();
-    if (rawBPM >= 40.0f && rawBPM <= 180.0f) lastValidBPM = rawBPM;
+  }
+  if (!gpsMissingReported && gps.charsProcessed() == 0 && (millis() - bringUpMs) > GPS_SILENT_MS) {
+    gpsMissingReported = true;
+    Serial.println("Aviso: el GPS no envía datos, se continúa sin ubicación.");
   }
 }
 
 void readGPS() {
   while (GPS_Serial.available() > 0) gps.encode(GPS_Serial.read());
+  if (!gpsFixReported && gps.location.isValid()) {
+    gpsFixReported = true;
+    Serial.printf("GPS: primer fix %lu ms tras iniciarlo (%lu ms desde el arranque)\n",
+                  (unsigned long)(millis() - bringUpMs), (unsigned long)millis());
+  }
   if (gps.date.isValid() && gps.time.isValid()) {
     setTime(gps.time.hour(), gps.time.minute(), gps.time.second(),
             gps.date.day(), gps.date.month(), gps.date.year());
     adjustTime(UTC_OFFSET_SECONDS);
   }
+  if (gps.location.isUpdated() && gps.location.isValid()) {
+    rtcState.hasLocation = true;
+    rtcState.latitude = gps.location.lat();
+    rtcState.longitude = gps.location.lng();
+    for (uint8_t ch = 0; ch < channels.getChannelCount(); ch++) {
+      vitals[ch].updateLocation(gps.location.lat(), gps.location.lng(), millis());
+    }
+    checkGeofence(gps.location.lat(), gps.location.lng());
+  }
+}
+
+void checkGeofence(float lat, float lon) {
+  if (geofence.getZoneCount() == 0) return;
+  GeofenceEvent events[4];
+  uint8_t n = geofence.update(lat, lon, events, 4);
+  for (uint8_t i = 0; i < n; i++) {
+    Serial.println("*** ALERTA DE ZONA ***");
+    Serial.printf("%s de zona %u (Lat %.6f, Lon %.6f)\n",
+                  events[i].entered ? "Entrada" : "Salida", events[i].zoneId, lat, lon);
+  }
+  outsideCareZone = geofence.getInsideCount() == 0;
+}
+
+void appendHistory(const VitalsSnapshot &snap, bool okTemp, float temperature, float humidity, float bpm, uint8_t spo2) {
+  VitalsRecord rec;
+  rec.timestamp   = now();
+  rec.temperature = temperature;
+  rec.humidity    = humidity;
+  rec.bpm         = bpm;
+  rec.spo2        = spo2;
+  rec.latitude    = snap.latitude;
+  rec.longitude   = snap.longitude;
+  rec.flags = 0;
+  if (okTemp)                          rec.flags |= REC_HAS_TEMPERATURE | REC_HAS_HUMIDITY;
+  if (bpm > 0.0f)                      rec.flags |= REC_HAS_BPM;
+  if (spo2 > 0)                        rec.flags |= REC_HAS_SPO2;
+  if (snap.locationMs != VITALS_NEVER) rec.flags |= REC_HAS_LOCATION;
+
+  if (!historyEncoder.append(rec)) {
+    // Bloque lleno: se envía al colector y se inicia uno nuevo
+    sendHistory();
+    historyEncoder.append(rec);
+  }
+}
+
+void sendHistory() {
+  // Trama FRAME_HISTORY al inicio de línea (tras el separador del reporte);
+  // el colector la decodifica con TimeSeriesDecoder
+  size_t len = historyEncoder.size();
+  if (historyEncoder.getRecordCount() > 0) {
+    uint8_t header[FRAME_HEADER_SIZE];
+    writeFrameHeader(header, FRAME_HISTORY, (uint16_t)len);
+    Serial.write(header, FRAME_HEADER_SIZE);
+    Serial.write(historyBuffer, len);
+    Serial.printf("Historial: %u registros en %u bytes enviados\n",
+                  (unsigned)historyEncoder.getRecordCount(), (unsigned)len);
+  }
+  historyEncoder.begin(historyBuffer, HISTORY_BUFFER_SIZE);
 }